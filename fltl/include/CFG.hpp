@@ -940,7 +940,7 @@ namespace fltl {
         }
 
         /// get the number of productions related to a variable
-        unsigned num_productions(variable_type _var) throw() {
+        unsigned num_productions(variable_type _var) const throw() {
             return get_variable(_var)->num_productions;
         }
 
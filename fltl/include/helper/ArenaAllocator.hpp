@@ -0,0 +1,135 @@
+/*
+ * ArenaAllocator.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+#ifndef FLTL_ARENAALLOCATOR_HPP_
+#define FLTL_ARENAALLOCATOR_HPP_
+
+#include <new>
+
+#include "fltl/include/helper/Align.hpp"
+#include "fltl/include/helper/UnsafeCast.hpp"
+
+#include "fltl/include/trait/AlignmentOf.hpp"
+#include "fltl/include/trait/Uncopyable.hpp"
+
+namespace fltl { namespace helper {
+
+    namespace detail {
+
+        template <typename T, const unsigned NUM_SLOTS>
+        struct ArenaBlock {
+        public:
+
+            typedef ArenaBlock<T,NUM_SLOTS> self_type;
+
+            enum {
+                ALIGNMENT = trait::AlignmentOf<T>::VALUE
+            };
+
+            self_type *next;
+            char storage[NUM_SLOTS * sizeof(T) + ALIGNMENT];
+
+            ArenaBlock(void) throw()
+                : next(0)
+            { }
+
+            inline T *slot(const unsigned i) throw() {
+                return align<ALIGNMENT>(
+                    helper::unsafe_cast<T *>(&(storage[0]))
+                ) + i;
+            }
+        };
+    }
+
+    /// bump allocator for objects of the same type. objects can't be freed
+    /// one at a time; instead, all objects are destroyed at once by reset(),
+    /// which keeps the memory around for re-use, or by the destructor.
+    template <typename T, const unsigned BLOCK_SIZE=256U>
+    class ArenaAllocator : private trait::Uncopyable {
+    private:
+
+        typedef detail::ArenaBlock<T, BLOCK_SIZE> block_type;
+        typedef ArenaAllocator<T,BLOCK_SIZE> self_type;
+
+        block_type *first_block;
+        block_type *curr_block;
+        unsigned next_slot;
+
+    public:
+
+        ArenaAllocator(void) throw()
+            : first_block(0)
+            , curr_block(0)
+            , next_slot(BLOCK_SIZE)
+        { }
+
+        ~ArenaAllocator(void) throw() {
+            reset();
+            for(block_type *curr(first_block), *next(0); 0 != curr; curr = next) {
+                next = curr->next;
+                delete curr;
+            }
+
+            first_block = 0;
+        }
+
+        /// allocate and default-construct an object
+        inline T *allocate(void) throw() {
+            if(BLOCK_SIZE == next_slot) {
+                next_block();
+            }
+
+            return new (curr_block->slot(next_slot++)) T;
+        }
+
+        /// destroy all allocated objects
+        void reset(void) throw() {
+            for(block_type *block(first_block);
+                0 != curr_block;
+                block = block->next) {
+
+                const unsigned num_slots(
+                    block == curr_block ? next_slot : BLOCK_SIZE
+                );
+
+                for(unsigned i(0); i < num_slots; ++i) {
+                    block->slot(i)->~T();
+                }
+
+                if(block == curr_block) {
+                    curr_block = 0;
+                }
+            }
+
+            next_slot = BLOCK_SIZE;
+        }
+
+    private:
+
+        /// move on to the next block, re-using a block from before the last
+        /// reset if there is one
+        void next_block(void) throw() {
+            block_type *block(0 == curr_block ? first_block : curr_block->next);
+
+            if(0 == block) {
+                block = new block_type;
+                if(0 == curr_block) {
+                    first_block = block;
+                } else {
+                    curr_block->next = block;
+                }
+            }
+
+            curr_block = block;
+            next_slot = 0;
+        }
+    };
+
+}}
+
+#endif /* FLTL_ARENAALLOCATOR_HPP_ */
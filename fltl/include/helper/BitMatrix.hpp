@@ -0,0 +1,206 @@
+/*
+ * BitMatrix.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+#ifndef FLTL_BITMATRIX_HPP_
+#define FLTL_BITMATRIX_HPP_
+
+#include <vector>
+
+namespace fltl { namespace helper {
+
+    /// a dense matrix of bits. each row is stored as a contiguous run of
+    /// machine words, and all rows are stored back-to-back in one array,
+    /// so that a row can be tested or combined a word at a time.
+    ///
+    /// the static functions work on any run of words, e.g. a row of a
+    /// matrix or a BitSet. their loops have no dependencies between words,
+    /// so that the compiler can vectorize them.
+    class BitMatrix {
+    public:
+
+        typedef unsigned long word_type;
+
+        enum {
+            BITS_PER_WORD = sizeof(word_type) * 8U
+        };
+
+    private:
+
+        unsigned rows;
+        unsigned cols;
+        unsigned words_per_row;
+        std::vector<word_type> words;
+
+    public:
+
+        BitMatrix(void) throw()
+            : rows(0)
+            , cols(0)
+            , words_per_row(0)
+            , words()
+        { }
+
+        BitMatrix(const unsigned num_rows, const unsigned num_cols) throw()
+            : rows(0)
+            , cols(0)
+            , words_per_row(0)
+            , words()
+        {
+            resize(num_rows, num_cols);
+        }
+
+        /// change the dimensions of the matrix and clear all bits
+        void resize(const unsigned num_rows, const unsigned num_cols) throw() {
+            rows = num_rows;
+            cols = num_cols;
+            words_per_row = num_words(num_cols);
+            words.assign(
+                static_cast<std::vector<word_type>::size_type>(rows) *
+                words_per_row,
+                0UL
+            );
+        }
+
+        /// the number of words needed to hold a row of some number of bits
+        inline static unsigned num_words(const unsigned num_bits) throw() {
+            return (num_bits + BITS_PER_WORD - 1U) / BITS_PER_WORD;
+        }
+
+        inline static bool test(const word_type *row, const unsigned col) throw() {
+            return 0UL != (
+                row[col / BITS_PER_WORD] & (1UL << (col % BITS_PER_WORD))
+            );
+        }
+
+        inline static void set(word_type *row, const unsigned col) throw() {
+            row[col / BITS_PER_WORD] |= 1UL << (col % BITS_PER_WORD);
+        }
+
+        /// set a bit; returns true if the bit was already set
+        inline static bool test_and_set(word_type *row, const unsigned col) throw() {
+            word_type &word(row[col / BITS_PER_WORD]);
+            const word_type bit(1UL << (col % BITS_PER_WORD));
+            const bool was_set(0UL != (word & bit));
+            word |= bit;
+            return was_set;
+        }
+
+        /// or a run of words into another run of words
+        inline static void or_into(
+            word_type *dest,
+            const word_type *source,
+            const unsigned num_words_
+        ) throw() {
+            for(unsigned i(0); i < num_words_; ++i) {
+                dest[i] |= source[i];
+            }
+        }
+
+        /// or a run of words into another run of words; returns true if any
+        /// bits of the destination changed.
+        inline static bool union_into(
+            word_type *dest,
+            const word_type *source,
+            const unsigned num_words_
+        ) throw() {
+            word_type changed(0UL);
+            for(unsigned i(0); i < num_words_; ++i) {
+                changed |= source[i] & ~dest[i];
+                dest[i] |= source[i];
+            }
+            return 0UL != changed;
+        }
+
+        /// and a run of words into another run of words
+        inline static void and_into(
+            word_type *dest,
+            const word_type *source,
+            const unsigned num_words_
+        ) throw() {
+            for(unsigned i(0); i < num_words_; ++i) {
+                dest[i] &= source[i];
+            }
+        }
+
+        /// do two runs of words have any bits in common?
+        inline static bool intersects(
+            const word_type *a,
+            const word_type *b,
+            const unsigned num_words_
+        ) throw() {
+            word_type common(0UL);
+            for(unsigned i(0); i < num_words_; ++i) {
+                common |= a[i] & b[i];
+            }
+            return 0UL != common;
+        }
+
+        /// the index of the lowest set bit of a non-zero word
+        inline static unsigned lowest_bit(word_type word) throw() {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzl(word));
+#else
+            unsigned i(0);
+            for(; 0UL == (word & 1UL); word >>= 1U) {
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+        inline bool test(const unsigned row_, const unsigned col) const throw() {
+            return test(row(row_), col);
+        }
+
+        inline void set(const unsigned row_, const unsigned col) throw() {
+            set(row(row_), col);
+        }
+
+        inline const word_type *row(const unsigned row_) const throw() {
+            return &(words[row_ * words_per_row]);
+        }
+
+        inline word_type *row(const unsigned row_) throw() {
+            return &(words[row_ * words_per_row]);
+        }
+
+        /// or the bits of one row into another row; returns true if any
+        /// bits of the destination row changed.
+        bool union_into(const unsigned dest, const unsigned source) throw() {
+            return union_into(row(dest), row(source), words_per_row);
+        }
+
+        /// fill in a matrix with the transpose of this one
+        void transpose_into(BitMatrix &dest) const throw() {
+            dest.resize(cols, rows);
+            for(unsigned r(0); r < rows; ++r) {
+                const word_type *curr(row(r));
+                for(unsigned c(0); c < cols; ++c) {
+                    if(test(curr, c)) {
+                        dest.set(c, r);
+                    }
+                }
+            }
+        }
+
+        inline unsigned num_rows(void) const throw() {
+            return rows;
+        }
+
+        inline unsigned num_cols(void) const throw() {
+            return cols;
+        }
+
+        inline unsigned num_words_per_row(void) const throw() {
+            return words_per_row;
+        }
+    };
+
+}}
+
+#endif /* FLTL_BITMATRIX_HPP_ */
@@ -0,0 +1,138 @@
+/*
+ * BitSet.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef FLTL_BITSET_HPP_
+#define FLTL_BITSET_HPP_
+
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+namespace fltl { namespace helper {
+
+    /// a dense set of small unsigned numbers, stored as a run of machine
+    /// words so that it can be combined with other sets, or with the rows
+    /// of a BitMatrix, a word at a time.
+    class BitSet {
+    public:
+
+        typedef BitMatrix::word_type word_type;
+
+    private:
+
+        unsigned num_bits;
+        std::vector<word_type> words;
+
+    public:
+
+        BitSet(void) throw()
+            : num_bits(0)
+            , words()
+        { }
+
+        explicit BitSet(const unsigned num_bits_) throw()
+            : num_bits(0)
+            , words()
+        {
+            resize(num_bits_);
+        }
+
+        /// change the size of the set and remove all numbers from it
+        void resize(const unsigned num_bits_) throw() {
+            num_bits = num_bits_;
+            words.assign(BitMatrix::num_words(num_bits), 0UL);
+        }
+
+        /// remove all numbers from the set
+        void clear(void) throw() {
+            words.assign(words.size(), 0UL);
+        }
+
+        inline bool test(const unsigned i) const throw() {
+            return BitMatrix::test(data(), i);
+        }
+
+        inline void set(const unsigned i) throw() {
+            BitMatrix::set(data(), i);
+        }
+
+        /// add a number to the set; returns true if it was already there
+        inline bool test_and_set(const unsigned i) throw() {
+            return BitMatrix::test_and_set(data(), i);
+        }
+
+        /// add in the numbers of a run of words, e.g. a row of a BitMatrix.
+        /// numbers that are too big for this set are left out. returns true
+        /// if the set changed.
+        inline bool union_with(
+            const word_type *source,
+            const unsigned num_source_words
+        ) throw() {
+            const unsigned tail(num_bits % BitMatrix::BITS_PER_WORD);
+
+            if(num_source_words < num_words() || 0U == tail) {
+                return BitMatrix::union_into(
+                    data(),
+                    source,
+                    num_source_words < num_words() ? num_source_words : num_words()
+                );
+            }
+
+            const unsigned last(num_words() - 1U);
+            bool changed(BitMatrix::union_into(data(), source, last));
+            const word_type added(
+                source[last] & ((1UL << tail) - 1UL) & ~(words[last])
+            );
+
+            words[last] |= added;
+            changed = changed || 0UL != added;
+
+            return changed;
+        }
+
+        inline bool union_with(const BitSet &that) throw() {
+            return union_with(that.data(), that.num_words());
+        }
+
+        /// does this set have any numbers in common with a run of words?
+        inline bool intersects(
+            const word_type *other,
+            const unsigned num_other_words
+        ) const throw() {
+            return BitMatrix::intersects(
+                data(),
+                other,
+                num_other_words < num_words() ? num_other_words : num_words()
+            );
+        }
+
+        inline bool intersects(const BitSet &that) const throw() {
+            return intersects(that.data(), that.num_words());
+        }
+
+        inline unsigned size(void) const throw() {
+            return num_bits;
+        }
+
+        inline unsigned num_words(void) const throw() {
+            return static_cast<unsigned>(words.size());
+        }
+
+        inline const word_type *data(void) const throw() {
+            return words.empty() ? 0 : &(words[0]);
+        }
+
+        inline word_type *data(void) throw() {
+            return words.empty() ? 0 : &(words[0]);
+        }
+    };
+
+}}
+
+#endif /* FLTL_BITSET_HPP_ */
@@ -0,0 +1,272 @@
+/*
+ * PackedTable.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+
+#ifndef FLTL_PACKEDTABLE_HPP_
+#define FLTL_PACKEDTABLE_HPP_
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+namespace fltl { namespace helper {
+
+    /// a sparse two-dimensional table of unsigned values, compressed by row
+    /// displacement. the rows are overlapped in one array such that no two
+    /// non-empty entries collide, and each entry is tagged with the offset
+    /// of the row that it belongs to. a lookup is then two array reads and
+    /// a compare.
+    ///
+    /// identical rows share one offset, and no two distinct rows share an
+    /// offset. rows are placed densest first, at the first offset that fits.
+    /// the used slots and offsets are kept as bit sets so that a whole word
+    /// of offsets can be tried at once.
+    class PackedTable {
+    private:
+
+        typedef BitMatrix::word_type word_type;
+
+        enum {
+            NO_ROW = 0xFFFFFFFFU,
+            BITS_PER_WORD = BitMatrix::BITS_PER_WORD
+        };
+
+        /// the offset of each row in the packed arrays
+        std::vector<unsigned> base;
+
+        /// the offset of the row that owns each packed entry
+        std::vector<unsigned> check;
+
+        /// the value of each packed entry
+        std::vector<unsigned> value;
+
+        unsigned num_cols;
+        unsigned empty;
+
+        /// orders rows by decreasing number of non-empty entries
+        class denser_row {
+        public:
+            const std::vector<unsigned> &row_begin;
+
+            denser_row(const std::vector<unsigned> &row_begin_) throw()
+                : row_begin(row_begin_)
+            { }
+
+            bool operator()(const unsigned a, const unsigned b) const throw() {
+                return (row_begin[a + 1U] - row_begin[a]) >
+                       (row_begin[b + 1U] - row_begin[b]);
+            }
+        };
+
+    public:
+
+        PackedTable(void) throw()
+            : base()
+            , check()
+            , value()
+            , num_cols(0)
+            , empty(0)
+        { }
+
+        /// pack a dense table with num_rows rows of num_cols_ columns each.
+        /// entries equal to empty_ are left out of the packed table.
+        void pack(
+            const std::vector<unsigned> &dense,
+            const unsigned num_rows,
+            const unsigned num_cols_,
+            const unsigned empty_
+        ) throw() {
+
+            // the columns of the non-empty entries of each row
+            std::vector<unsigned> row_begin;
+            std::vector<unsigned> columns;
+            std::vector<unsigned> order(num_rows, 0U);
+
+            // the offsets of the rows that have been placed, by contents
+            std::map<std::vector<unsigned>, unsigned> placed;
+            std::vector<unsigned> contents;
+
+            // the used slots and offsets
+            std::vector<word_type> used_slots;
+            std::vector<word_type> used_offsets;
+
+            num_cols = num_cols_;
+            empty = empty_;
+            base.assign(num_rows, 0U);
+            check.assign(num_cols, static_cast<unsigned>(NO_ROW));
+            value.assign(num_cols, empty);
+
+            for(unsigned r(0); r < num_rows; ++r) {
+                const unsigned *row(&(dense[r * num_cols]));
+                order[r] = r;
+                row_begin.push_back(static_cast<unsigned>(columns.size()));
+                for(unsigned c(0); c < num_cols; ++c) {
+                    if(empty != row[c]) {
+                        columns.push_back(c);
+                    }
+                }
+            }
+            row_begin.push_back(static_cast<unsigned>(columns.size()));
+            columns.push_back(0U);
+
+            std::stable_sort(order.begin(), order.end(), denser_row(row_begin));
+
+            // all slots before this one are used
+            unsigned first_free(0);
+
+            for(unsigned i(0); i < num_rows; ++i) {
+                const unsigned r(order[i]);
+                const unsigned *row(&(dense[r * num_cols]));
+                const unsigned *cols(&(columns[row_begin[r]]));
+                const unsigned num_entries(row_begin[r + 1U] - row_begin[r]);
+
+                contents.clear();
+                for(unsigned j(0); j < num_entries; ++j) {
+                    contents.push_back(cols[j]);
+                    contents.push_back(row[cols[j]]);
+                }
+
+                std::map<std::vector<unsigned>, unsigned>::iterator same(
+                    placed.find(contents)
+                );
+
+                if(placed.end() != same) {
+                    base[r] = same->second;
+                    continue;
+                }
+
+                // no offset that puts the first entry before first_free
+                // can fit
+                unsigned offset(0);
+                if(0U < num_entries && first_free > cols[0]) {
+                    offset = first_free - cols[0];
+                }
+
+                offset = find_fit(
+                    used_slots, used_offsets, cols, num_entries, offset
+                );
+
+                // every lookup of this row must stay inside the arrays
+                if(check.size() < offset + num_cols) {
+                    check.resize(offset + num_cols, static_cast<unsigned>(NO_ROW));
+                    value.resize(offset + num_cols, empty);
+                }
+
+                mark(used_offsets, offset);
+                placed[contents] = offset;
+                base[r] = offset;
+
+                for(unsigned j(0); j < num_entries; ++j) {
+                    check[offset + cols[j]] = offset;
+                    value[offset + cols[j]] = row[cols[j]];
+                    mark(used_slots, offset + cols[j]);
+                }
+
+                for(; first_free < check.size()
+                   && NO_ROW != check[first_free];
+                    ++first_free) {
+                    // skip used slots
+                }
+            }
+        }
+
+        /// look up an entry of the table
+        inline unsigned get(const unsigned row, const unsigned col) const throw() {
+            const unsigned offset(base[row]);
+            if(offset != check[offset + col]) {
+                return empty;
+            }
+            return value[offset + col];
+        }
+
+        /// the number of entries in the packed arrays
+        inline unsigned num_entries(void) const throw() {
+            return static_cast<unsigned>(check.size());
+        }
+
+        /// the offset of a row in the packed arrays
+        inline unsigned row_offset(const unsigned row) const throw() {
+            return base[row];
+        }
+
+        /// the offset of the row that owns the ith packed entry, or a value
+        /// that is not the offset of any row if the entry is unused
+        inline unsigned entry_row(const unsigned i) const throw() {
+            return check[i];
+        }
+
+        /// the value of the ith packed entry
+        inline unsigned entry_value(const unsigned i) const throw() {
+            return value[i];
+        }
+
+    private:
+
+        /// mark a slot or offset as used
+        static void mark(std::vector<word_type> &bits, const unsigned i) throw() {
+            const unsigned word(i / BITS_PER_WORD);
+            if(bits.size() <= word) {
+                bits.resize(word + 1U, 0UL);
+            }
+            BitMatrix::set(&(bits[0]), i);
+        }
+
+        /// get the bits for the slots or offsets i through i + 63. bits
+        /// past the end of the set are unused.
+        static word_type window(
+            const std::vector<word_type> &bits,
+            const unsigned i
+        ) throw() {
+            const unsigned word(i / BITS_PER_WORD);
+            const unsigned shift(i % BITS_PER_WORD);
+
+            if(bits.size() <= word) {
+                return 0UL;
+            }
+
+            word_type w(bits[word] >> shift);
+            if(0U != shift && word + 1U < bits.size()) {
+                w |= bits[word + 1U] << (BITS_PER_WORD - shift);
+            }
+
+            return w;
+        }
+
+        /// find the first offset at or after some offset where the non-empty
+        /// entries of a row collide neither with the entries of other rows,
+        /// nor with their offsets. the offsets are tried one word at a time:
+        /// a set bit in the collision word rules out its offset.
+        static unsigned find_fit(
+            const std::vector<word_type> &used_slots,
+            const std::vector<word_type> &used_offsets,
+            const unsigned *cols,
+            const unsigned num_entries,
+            unsigned offset
+        ) throw() {
+            const word_type ALL(~static_cast<word_type>(0UL));
+
+            for(;; offset += BITS_PER_WORD) {
+                word_type collisions(window(used_offsets, offset));
+
+                for(unsigned i(0); ALL != collisions && i < num_entries; ++i) {
+                    collisions |= window(used_slots, offset + cols[i]);
+                }
+
+                if(ALL != collisions) {
+                    return offset + BitMatrix::lowest_bit(~collisions);
+                }
+            }
+        }
+    };
+
+}}
+
+#endif /* FLTL_PACKEDTABLE_HPP_ */
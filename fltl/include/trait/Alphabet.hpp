@@ -56,6 +56,14 @@ namespace fltl { namespace trait {
             static void unserialize(const char *, T &) throw() {
                 assert(false && "Unimplemented.");
             }
+
+            static unsigned long hash(const T &that) throw() {
+                return static_cast<unsigned long>(that);
+            }
+
+            static bool equal(const T &a, const T &b) throw() {
+                return a == b;
+            }
         };
     }
 
@@ -121,6 +129,20 @@ namespace fltl { namespace trait {
         static void unserialize(const char *from, const char *&to) throw() {
             to = from;
         }
+
+        /// FNV-1a hash of the string
+        static unsigned long hash(const char *that) throw() {
+            unsigned long h(2166136261UL);
+            for(; '\0' != *that; ++that) {
+                h ^= static_cast<unsigned char>(*that);
+                h *= 16777619UL;
+            }
+            return h;
+        }
+
+        static bool equal(const char *a, const char *b) throw() {
+            return 0 == strcmp(a, b);
+        }
     };
 }}
 
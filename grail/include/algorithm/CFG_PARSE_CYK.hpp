@@ -0,0 +1,297 @@
+/*
+ * CFG_PARSE_CYK.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef FLTL_CFG_PARSE_CYK_HPP_
+#define FLTL_CFG_PARSE_CYK_HPP_
+
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/CYKTables.hpp"
+
+#include "grail/include/helper/Thread.hpp"
+
+#include "grail/include/io/verbose.hpp"
+#include "grail/include/io/UTF8FileTokBuffer.hpp"
+
+namespace grail { namespace algorithm {
+
+    /// recognize a token stream using the Cocke-Younger-Kasami algorithm.
+    /// the grammar must be in Chomsky Normal Form (see CFG_TO_CNF). each
+    /// cell of the chart is a set of variables, stored as a row of bits,
+    /// and the cells of a span are combined a word at a time using the
+    /// rule tables of CYKTables.
+    ///
+    /// all cells that cover spans of the same length are independent of
+    /// each other, so the chart can be filled one diagonal at a time by
+    /// several threads.
+    template <typename AlphaT, const unsigned MAX_TOK_LENGTH>
+    class CFG_PARSE_CYK {
+    public:
+
+        // take off the templates!
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef cfg::CYKTables<AlphaT> tables_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+        typedef bit_matrix_type::word_type word_type;
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+            // number of chart cells that were filled
+            unsigned long num_cells;
+
+            // number of (B, C) pairs looked at while combining cells
+            unsigned long num_pairs;
+
+            // number of threads used to fill the chart
+            unsigned num_threads;
+
+            stats_type(void)
+                : num_cells(0)
+                , num_pairs(0)
+                , num_threads(0)
+            { }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_cells += that.num_cells;
+                num_pairs += that.num_pairs;
+                if(num_threads < that.num_threads) {
+                    num_threads = that.num_threads;
+                }
+            }
+        };
+
+    private:
+
+        /// the chart; cells are stored diagonal by diagonal, so that the
+        /// cell for the span of length len starting at token i is at index
+        /// diagonal[len] + i.
+        class chart_type {
+        public:
+            const tables_type &tables;
+            const unsigned num_tokens;
+            std::vector<unsigned> diagonal;
+            std::vector<word_type> words;
+
+            chart_type(const tables_type &tables_, const unsigned n) throw()
+                : tables(tables_)
+                , num_tokens(n)
+                , diagonal(n + 2U, 0U)
+                , words()
+            {
+                for(unsigned len(1); len <= n; ++len) {
+                    diagonal[len + 1U] = diagonal[len] + (n - len + 1U);
+                }
+
+                words.assign(
+                    static_cast<std::vector<word_type>::size_type>(
+                        diagonal[n + 1U]
+                    ) * tables.num_words,
+                    0UL
+                );
+            }
+
+            inline word_type *cell(const unsigned i, const unsigned len) throw() {
+                return &(words[
+                    static_cast<std::vector<word_type>::size_type>(
+                        diagonal[len] + i
+                    ) * tables.num_words
+                ]);
+            }
+        };
+
+        /// the state shared by all threads that fill in the chart. the
+        /// cells of each diagonal are handed out one at a time, so that the
+        /// work stays balanced even though cells of the same diagonal can
+        /// have very different amounts of variables in them.
+        class shared_state_type {
+        public:
+            chart_type &chart;
+            helper::Barrier &barrier;
+            helper::Mutex mutex;
+            std::vector<unsigned> next_cell;
+
+            shared_state_type(
+                chart_type &chart_,
+                helper::Barrier &barrier_
+            ) throw()
+                : chart(chart_)
+                , barrier(barrier_)
+                , mutex()
+                , next_cell(chart_.num_tokens + 1U, 0U)
+            { }
+
+            /// claim the next cell of a diagonal, or return false if all of
+            /// its cells have been claimed
+            bool claim(const unsigned len, unsigned &i) throw() {
+                mutex.lock();
+                i = next_cell[len]++;
+                mutex.unlock();
+                return i <= chart.num_tokens - len;
+            }
+        };
+
+        /// the state of one thread that fills in part of each diagonal
+        class worker_type {
+        public:
+            shared_state_type *shared;
+            bool is_parallel;
+            unsigned long num_cells;
+            unsigned long num_pairs;
+        };
+
+        /// fill in cells of each diagonal until they are all claimed. all
+        /// workers finish a diagonal before any of them moves on to the
+        /// next one.
+        static void fill(void *worker_) throw() {
+            worker_type &worker(*reinterpret_cast<worker_type *>(worker_));
+            shared_state_type &shared(*(worker.shared));
+            chart_type &chart(shared.chart);
+            const tables_type &tables(chart.tables);
+            const unsigned n(chart.num_tokens);
+            unsigned i(0);
+
+            for(unsigned len(2); len <= n; ++len) {
+                for(; shared.claim(len, i); ) {
+                    word_type *out(chart.cell(i, len));
+                    for(unsigned split(1); split < len; ++split) {
+                        worker.num_pairs += tables.combine(
+                            chart.cell(i, split),
+                            chart.cell(i + split, len - split),
+                            out
+                        );
+                    }
+
+                    ++(worker.num_cells);
+                }
+
+                if(worker.is_parallel) {
+                    shared.barrier.wait();
+                }
+            }
+        }
+
+    public:
+
+        /// run the recognizer using at most num_threads threads to fill in
+        /// the chart.
+        static bool run(
+            const grammar_type &grammar,
+            const tables_type &tables,
+            const unsigned num_threads,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats
+        ) throw() {
+
+            // the variables that can derive each token
+            std::vector<const word_type *> token_heads;
+            alphabet_type lexeme;
+
+            for(const char *token(reader.read());
+                0 != token && '\0' != *token;
+                token = reader.read()) {
+
+                traits_type::unserialize(token, lexeme);
+                const unsigned a(grammar.find_terminal(lexeme));
+
+                if(0U != a) {
+                    token_heads.push_back(tables.terminal_heads.row(a));
+                } else if(tables.has_variable_terminals) {
+                    token_heads.push_back(&(tables.variable_terminal_heads[0]));
+                } else {
+                    io::verbose("    Unrecognized terminal '%s'.\n", token);
+                    io::verbose("Failed to parse all input.\n");
+                    return false;
+                }
+            }
+
+            const unsigned n(static_cast<unsigned>(token_heads.size()));
+
+            if(0U == n) {
+                io::verbose(tables.accepts_empty
+                    ? "Parsed. Accepted empty string.\n"
+                    : "Failed to parse. Empty string not accepted.\n"
+                );
+                return tables.accepts_empty;
+            }
+
+            io::verbose("Filling CYK chart for %u tokens...\n", n);
+
+            chart_type chart(tables, n);
+            for(unsigned i(0); i < n; ++i) {
+                bit_matrix_type::or_into(
+                    chart.cell(i, 1U),
+                    token_heads[i],
+                    tables.num_words
+                );
+            }
+
+            // there is no point in having more threads than there are
+            // cells in the longest interesting diagonal
+            unsigned num_workers(0U == num_threads ? 1U : num_threads);
+            if(num_workers > n - 1U) {
+                num_workers = 0U == n - 1U ? 1U : n - 1U;
+            }
+
+            helper::Barrier barrier(num_workers);
+            shared_state_type shared(chart, barrier);
+            std::vector<worker_type> workers(num_workers);
+            helper::Thread *threads(new helper::Thread[num_workers]);
+
+            for(unsigned w(0); w < num_workers; ++w) {
+                workers[w].shared = &shared;
+                workers[w].is_parallel = 1U < num_workers;
+                workers[w].num_cells = 0;
+                workers[w].num_pairs = 0;
+            }
+
+            // the current thread acts as the first worker. if a thread
+            // can't be started then the others pick up its share.
+            stats.num_threads = num_workers;
+            for(unsigned w(1); w < num_workers; ++w) {
+                if(!threads[w].start(&fill, &(workers[w]))) {
+                    io::verbose("Unable to start CYK worker thread.\n");
+                    barrier.leave();
+                    --(stats.num_threads);
+                }
+            }
+
+            fill(&(workers[0]));
+
+            stats.num_cells += n;
+            for(unsigned w(0); w < num_workers; ++w) {
+                threads[w].join();
+                stats.num_cells += workers[w].num_cells;
+                stats.num_pairs += workers[w].num_pairs;
+            }
+
+            delete [] threads;
+
+            if(bit_matrix_type::test(chart.cell(0, n), tables.start_variable)) {
+                io::verbose("Successfully parsed.\n");
+                return true;
+            }
+
+            io::verbose("Failed to parse all input.\n");
+            return false;
+        }
+    };
+}}
+
+#endif /* FLTL_CFG_PARSE_CYK_HPP_ */
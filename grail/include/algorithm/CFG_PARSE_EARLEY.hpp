@@ -29,12 +29,21 @@
 #ifndef FLTL_CFG_EARLEY_PARSE_HPP_
 #define FLTL_CFG_EARLEY_PARSE_HPP_
 
+#include <algorithm>
+#include <cstring>
+#include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include "fltl/include/CFG.hpp"
 
-#include "fltl/include/helper/BlockAllocator.hpp"
+#include "fltl/include/helper/ArenaAllocator.hpp"
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LookaheadSets.hpp"
+#include "grail/include/cfg/ParseForest.hpp"
 
 #include "grail/include/io/verbose.hpp"
 #include "grail/include/io/UTF8FileTokBuffer.hpp"
@@ -51,7 +60,49 @@ namespace grail { namespace algorithm {
 
         FLTL_CFG_USE_TYPES(CFG);
 
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef cfg::ParseForest<AlphaT> forest_type;
+        typedef cfg::LookaheadSets<AlphaT> lookahead_sets_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+        typedef bit_matrix_type::word_type word_type;
+
+        enum {
+            NO_LINK = 0xFFFFFFFFU,
+            NO_NODE = forest_type::NO_NODE
+        };
+
         class earley_item_type;
+        class earley_set_type;
+
+        /// the items of a set that are waiting on a particular variable,
+        /// i.e. all items of the form A --> ... * B ... for some B.
+        class waiting_list_type {
+        public:
+            unsigned variable;
+            earley_item_type *first;
+            earley_item_type *last;
+
+            // memoized Leo item for this variable and set; this is the
+            // topmost item of the deterministic reduction path that starts
+            // when the variable is completed with this set as its origin.
+            unsigned leo_state;
+            unsigned leo_item;
+            earley_set_type *leo_set;
+
+            // the last set in which the variable was completed with this
+            // set as its origin, and the bucket of completed items that
+            // this made in that set
+            earley_set_type *completed_in;
+            unsigned bucket;
+        };
+
+        enum {
+            LEO_UNKNOWN = 0,
+            LEO_IN_PROGRESS,
+            LEO_NONE,
+            LEO_FOUND
+        };
 
         /// Earley set
         class earley_set_type {
@@ -67,14 +118,34 @@ namespace grail { namespace algorithm {
             // offset into the terminal stream
             unsigned offset;
 
+            // number of items in this set
+            unsigned num_items;
+
+            // open-addressed hash table of waiting lists, keyed by the
+            // variable that the items are waiting on
+            waiting_list_type *waiting;
+            unsigned waiting_capacity;
+            unsigned num_waiting;
+
             earley_set_type(void)
                 : first(0)
                 , last(0)
                 , next(0)
                 , prev(0)
                 , offset(0)
+                , num_items(0)
+                , waiting(0)
+                , waiting_capacity(0)
+                , num_waiting(0)
             { }
 
+            ~earley_set_type(void) throw() {
+                if(0 != waiting) {
+                    delete [] waiting;
+                    waiting = 0;
+                }
+            }
+
             void push(earley_item_type *item) throw() {
                 if(0 == item) {
                     return;
@@ -88,6 +159,7 @@ namespace grail { namespace algorithm {
                 }
 
                 item->next = 0;
+                ++num_items;
             }
 
             void set_next(earley_set_type *set) throw() {
@@ -96,14 +168,192 @@ namespace grail { namespace algorithm {
                 next = set;
                 set->offset = offset + 1;
             }
+
+            /// add an item to the waiting list for its variable B, where the
+            /// item has the form A --> ... * B ...
+            void wait(const unsigned var, earley_item_type *item) throw() {
+                if((num_waiting + 1U) * 2U > waiting_capacity) {
+                    grow_waiting();
+                }
+
+                waiting_list_type *list(find_waiting(var));
+                item->next_waiting = 0;
+
+                if(0 == list->first) {
+                    ++num_waiting;
+                    list->variable = var;
+                    list->first = item;
+                } else {
+                    list->last->next_waiting = item;
+                }
+
+                list->last = item;
+            }
+
+            /// get the first item in this set that is waiting on a variable
+            earley_item_type *waiting_on(const unsigned var) const throw() {
+                if(0 == num_waiting) {
+                    return 0;
+                }
+                return find_waiting(var)->first;
+            }
+
+            /// get the waiting list for a variable, or 0 if no items in this
+            /// set are waiting on the variable
+            waiting_list_type *waiting_list(const unsigned var) const throw() {
+                if(0 == num_waiting) {
+                    return 0;
+                }
+
+                waiting_list_type *list(find_waiting(var));
+                if(0 == list->first) {
+                    return 0;
+                }
+
+                return list;
+            }
+
+        private:
+
+            waiting_list_type *find_waiting(const unsigned var) const throw() {
+                const unsigned mask(waiting_capacity - 1U);
+                unsigned slot((var * 2654435761U) & mask);
+
+                for(; 0 != waiting[slot].first
+                   && var != waiting[slot].variable;
+                    slot = (slot + 1U) & mask) {
+                    // linear probe
+                }
+
+                return &(waiting[slot]);
+            }
+
+            void grow_waiting(void) throw() {
+                waiting_list_type *old_waiting(waiting);
+                const unsigned old_capacity(waiting_capacity);
+
+                waiting_capacity = 0 == old_capacity ? 8U : old_capacity * 2U;
+                waiting = new waiting_list_type[waiting_capacity];
+                memset(waiting, 0, sizeof(waiting_list_type) * waiting_capacity);
+
+                for(unsigned i(0); i < old_capacity; ++i) {
+                    if(0 != old_waiting[i].first) {
+                        *find_waiting(old_waiting[i].variable) = old_waiting[i];
+                    }
+                }
+
+                if(0 != old_waiting) {
+                    delete [] old_waiting;
+                }
+            }
+        };
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+
+            enum {
+                NUM_SET_SIZE_BUCKETS = 32
+            };
+
+            // number of Earley items in all sets
+            unsigned long num_items;
+
+            // number of Earley sets
+            unsigned long num_sets;
+
+            // number of items in the largest set
+            unsigned long max_set_items;
+
+            // the number of sets with 2^k to 2^(k+1) - 1 items, for each k
+            unsigned long set_size_histogram[NUM_SET_SIZE_BUCKETS];
+
+            // number of items X --> * alpha added by the predictor
+            unsigned long num_predictions;
+
+            // number of items moved into the next set by the scanner
+            unsigned long num_scans;
+
+            // number of items that were not added to a set because they
+            // were already in it
+            unsigned long num_duplicates;
+
+            // number of completed items
+            unsigned long num_completions;
+
+            // number of items visited by the completer, i.e. items that
+            // were waiting on a completed variable
+            unsigned long num_completer_visits;
+
+            // number of items of initial sets that the completer did not
+            // have to visit because they were not waiting on the completed
+            // variable
+            unsigned long num_completer_skips;
+
+            // number of completions that were handled by a Leo item
+            unsigned long num_leo_completions;
+
+            // the most items, and bytes of items, sets, and their waiting
+            // lists, that were live at once while parsing one input
+            unsigned long max_live_items;
+            unsigned long max_live_bytes;
+
+            stats_type(void)
+                : num_items(0)
+                , num_sets(0)
+                , max_set_items(0)
+                , num_predictions(0)
+                , num_scans(0)
+                , num_duplicates(0)
+                , num_completions(0)
+                , num_completer_visits(0)
+                , num_completer_skips(0)
+                , num_leo_completions(0)
+                , max_live_items(0)
+                , max_live_bytes(0)
+            {
+                memset(set_size_histogram, 0, sizeof set_size_histogram);
+            }
+
+            /// count a set once it is done
+            void add_set(const unsigned long set_items) throw() {
+                unsigned bucket(0);
+                for(unsigned long n(set_items >> 1U); 0 != n; n >>= 1U) {
+                    ++bucket;
+                }
+
+                ++num_sets;
+                ++(set_size_histogram[bucket]);
+                num_items += set_items;
+                max_set_items = std::max(max_set_items, set_items);
+            }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_items += that.num_items;
+                num_sets += that.num_sets;
+                max_set_items = std::max(max_set_items, that.max_set_items);
+                num_predictions += that.num_predictions;
+                num_scans += that.num_scans;
+                num_duplicates += that.num_duplicates;
+                num_completions += that.num_completions;
+                num_completer_visits += that.num_completer_visits;
+                num_completer_skips += that.num_completer_skips;
+                num_leo_completions += that.num_leo_completions;
+                max_live_items = std::max(max_live_items, that.max_live_items);
+                max_live_bytes = std::max(max_live_bytes, that.max_live_bytes);
+
+                for(unsigned i(0); i < NUM_SET_SIZE_BUCKETS; ++i) {
+                    set_size_histogram[i] += that.set_size_histogram[i];
+                }
+            }
         };
 
         /// Earley item
         class earley_item_type {
         public:
-            // dotted production
-            unsigned dot;
-            production_type production;
+            // dotted production, as an item id of the compiled grammar
+            unsigned item;
 
             // next item in the set
             earley_item_type *next;
@@ -117,139 +367,742 @@ namespace grail { namespace algorithm {
             // set
             earley_item_type *next_with_same_initial_set;
 
+            // the next item in the same set that is waiting on the same
+            // variable. complete items never wait, so when building a parse
+            // forest this instead links together the items of a bucket.
+            earley_item_type *next_waiting;
+
+            // the ways that this item was derived, as a list of links; only
+            // recorded when building a parse forest
+            unsigned first_link;
+            unsigned last_link;
+
+            // when building a parse forest, this is the bucket of a
+            // complete item, or the intermediate node of any other item
+            unsigned node;
+
             earley_item_type(void)
-                : dot(0)
-                , production()
+                : item(0)
                 , next(0)
                 , initial_set(0)
                 , next_with_same_initial_set(0)
+                , next_waiting(0)
+                , first_link(NO_LINK)
+                , last_link(NO_LINK)
+                , node(NO_NODE)
             { }
+        };
+
+    private:
+
+        enum {
+            NUM_BLOCKS = 1024U
+        };
+
+        /// one way that an Earley item was derived: the dot of pred was
+        /// slid over a token (cause is 0 and the symbol is a terminal), an
+        /// empty span (cause is 0 and the symbol is a nullable variable),
+        /// or the complete item cause.
+        class link_type {
+        public:
+            earley_item_type *pred;
+            earley_item_type *cause;
+            unsigned next;
+        };
+
+        /// the complete items A --> ... * of one set that have the same
+        /// initial set; these make up a single symbol node of a forest.
+        class bucket_type {
+        public:
+            earley_item_type *first;
+            earley_item_type *last;
+            unsigned end;
+            unsigned node;
+        };
+
+        /// builds a parse forest from the links recorded while recognizing
+        /// the input. nodes are made on demand starting from the root so
+        /// that only useful derivations end up in the forest, and a work
+        /// list is used instead of recursion so that long inputs don't
+        /// overflow the stack.
+        class forest_builder_type {
+        private:
+
+            enum {
+                WORK_BUCKET,
+                WORK_ITEM,
+                WORK_NULL_VARIABLE,
+                WORK_NULL_ITEM
+            };
+
+            enum {
+                KEY_TERMINAL,
+                KEY_NULL_VARIABLE,
+                KEY_NULL_ITEM
+            };
+
+            class work_type {
+            public:
+                unsigned kind;
+                unsigned node;
+                earley_item_type *item;
+                unsigned id;
+                unsigned pos;
+            };
+
+            class entry_type {
+            public:
+                unsigned key;
+                unsigned pos;
+                unsigned node;
+            };
+
+            const grammar_type &grammar;
+            forest_type &forest;
+            const std::vector<link_type> &links;
+            std::vector<bucket_type> &buckets;
+
+            std::vector<work_type> work;
+
+            // open-addressed hash table of the terminal nodes and the nodes
+            // of empty spans, keyed by (key, pos)
+            std::vector<entry_type> table;
+            unsigned num_entries;
+
+        public:
+
+            forest_builder_type(
+                const grammar_type &grammar_,
+                forest_type &forest_,
+                const std::vector<link_type> &links_,
+                std::vector<bucket_type> &buckets_
+            ) throw()
+                : grammar(grammar_)
+                , forest(forest_)
+                , links(links_)
+                , buckets(buckets_)
+                , work()
+                , table()
+                , num_entries(0)
+            {
+                entry_type empty;
+                empty.key = 0;
+                empty.pos = 0;
+                empty.node = NO_NODE;
+                table.assign(16U, empty);
+            }
+
+            /// build the forest whose root is the derivation of the accept
+            /// item START --> S * that ends at position end
+            void build(earley_item_type *accept, const unsigned end) throw() {
+                forest.root = right_node(links[accept->first_link], end);
+
+                for(; !work.empty(); ) {
+                    const work_type curr(work.back());
+                    work.pop_back();
+
+                    switch(curr.kind) {
+                    case WORK_BUCKET:
+                        for(earley_item_type *item(buckets[curr.id].first);
+                            0 != item;
+                            item = item->next_waiting) {
+                            add_packed_nodes(curr.node, item, curr.pos);
+                        }
+                        break;
+
+                    case WORK_ITEM:
+                        add_packed_nodes(curr.node, curr.item, curr.pos);
+                        break;
+
+                    case WORK_NULL_VARIABLE:
+                        add_null_packed_node(
+                            curr.node,
+                            grammar.production_item[
+                                grammar.null_production[curr.id] + 1U
+                            ] - 1U,
+                            curr.pos
+                        );
+                        break;
 
-            void scanned_from(
-                earley_item_type *scan
+                    case WORK_NULL_ITEM:
+                        add_null_packed_node(curr.node, curr.id, curr.pos);
+                        break;
+                    }
+                }
+            }
+
+        private:
+
+            void push_work(
+                const unsigned kind,
+                const unsigned node,
+                earley_item_type *item,
+                const unsigned id,
+                const unsigned pos
             ) throw() {
-                dot = scan->dot + 1U;
-                production = scan->production;
-                initial_set = scan->initial_set;
+                work_type next;
+                next.kind = kind;
+                next.node = node;
+                next.item = item;
+                next.id = id;
+                next.pos = pos;
+                work.push_back(next);
             }
 
-            void predicted_from(
-                earley_set_type *set,
-                const production_type &prod
+            /// add one packed node for each link of an Earley item
+            void add_packed_nodes(
+                const unsigned node,
+                earley_item_type *item,
+                const unsigned end
             ) throw() {
-                dot = 0;
-                production = prod;
-                initial_set = set;
+                for(unsigned l(item->first_link); NO_LINK != l; l = links[l].next) {
+                    const link_type &link(links[l]);
+                    const unsigned left(prefix_node(
+                        link.pred,
+                        split_pos(link, end)
+                    ));
+
+                    forest.add_packed(
+                        node,
+                        item->item,
+                        left,
+                        right_node(link, end)
+                    );
+                }
             }
-        };
 
-    private:
+            /// add the packed node of an item that derives an empty span
+            void add_null_packed_node(
+                const unsigned node,
+                const unsigned item,
+                const unsigned pos
+            ) throw() {
+                if(0 == grammar.item_dot[item]) {
+                    forest.add_packed(node, item, NO_NODE, NO_NODE);
+                    return;
+                }
 
-        enum {
-            NUM_BLOCKS = 1024U
+                const unsigned left(null_prefix_node(item - 1U, pos));
+                forest.add_packed(node, item, left, null_variable_node(
+                    static_cast<unsigned>(grammar.item_symbol[item - 1U]),
+                    pos
+                ));
+            }
+
+            /// the position at which the symbol before the dot of an item
+            /// derived by some link begins
+            unsigned split_pos(
+                const link_type &link,
+                const unsigned end
+            ) const throw() {
+                if(0 != link.cause) {
+                    return link.cause->initial_set->offset;
+                } else if(0 > grammar.item_symbol[link.pred->item]) {
+                    return end - 1U;
+                }
+                return end;
+            }
+
+            /// the node of the symbol before the dot of an item derived by
+            /// some link
+            unsigned right_node(
+                const link_type &link,
+                const unsigned end
+            ) throw() {
+                const symbol_id_type sym(grammar.item_symbol[link.pred->item]);
+
+                if(0 != link.cause) {
+                    return bucket_node(link.cause->node);
+                } else if(0 > sym) {
+                    return terminal_node(static_cast<unsigned>(-sym), end - 1U);
+                }
+                return null_variable_node(static_cast<unsigned>(sym), end);
+            }
+
+            /// the node of the symbols before the dot of an Earley item that
+            /// ends at position end
+            unsigned prefix_node(
+                earley_item_type *item,
+                const unsigned end
+            ) throw() {
+                const unsigned dot(grammar.item_dot[item->item]);
+
+                if(0 == dot) {
+                    return NO_NODE;
+
+                // all derivations of an item with one symbol before the dot
+                // lead to the same node
+                } else if(1 == dot) {
+                    return right_node(links[item->first_link], end);
+                }
+
+                if(NO_NODE == item->node) {
+                    item->node = forest.add_node(
+                        0,
+                        item->item,
+                        item->initial_set->offset,
+                        end
+                    );
+                    push_work(WORK_ITEM, item->node, item, 0, end);
+                }
+
+                return item->node;
+            }
+
+            /// the node of the symbols before the dot of an item that derives
+            /// an empty span
+            unsigned null_prefix_node(
+                const unsigned item,
+                const unsigned pos
+            ) throw() {
+                const unsigned dot(grammar.item_dot[item]);
+
+                if(0 == dot) {
+                    return NO_NODE;
+                } else if(1 == dot) {
+                    return null_variable_node(
+                        static_cast<unsigned>(grammar.item_symbol[item - 1U]),
+                        pos
+                    );
+                }
+
+                unsigned &node(find_node((item << 2U) | KEY_NULL_ITEM, pos));
+                if(NO_NODE == node) {
+                    node = forest.add_node(0, item, pos, pos);
+                    push_work(WORK_NULL_ITEM, node, 0, item, pos);
+                }
+
+                return node;
+            }
+
+            unsigned bucket_node(const unsigned bucket) throw() {
+                bucket_type &b(buckets[bucket]);
+
+                if(NO_NODE == b.node) {
+                    b.node = forest.add_node(
+                        static_cast<symbol_id_type>(
+                            grammar.item_variable[b.first->item]
+                        ),
+                        0,
+                        b.first->initial_set->offset,
+                        b.end
+                    );
+                    push_work(WORK_BUCKET, b.node, 0, bucket, b.end);
+                }
+
+                return b.node;
+            }
+
+            unsigned terminal_node(
+                const unsigned term,
+                const unsigned pos
+            ) throw() {
+                unsigned &node(find_node((term << 2U) | KEY_TERMINAL, pos));
+                if(NO_NODE == node) {
+                    node = forest.add_node(
+                        -static_cast<symbol_id_type>(term),
+                        0,
+                        pos,
+                        pos + 1U
+                    );
+                }
+                return node;
+            }
+
+            unsigned null_variable_node(
+                const unsigned var,
+                const unsigned pos
+            ) throw() {
+                unsigned &node(find_node((var << 2U) | KEY_NULL_VARIABLE, pos));
+                if(NO_NODE == node) {
+                    node = forest.add_node(
+                        static_cast<symbol_id_type>(var),
+                        0,
+                        pos,
+                        pos
+                    );
+                    push_work(WORK_NULL_VARIABLE, node, 0, var, pos);
+                }
+                return node;
+            }
+
+            /// find the slot for a node in the hash table; the node of a new
+            /// slot is NO_NODE, and must be filled in by the caller before
+            /// the table is used again.
+            unsigned &find_node(const unsigned key, const unsigned pos) throw() {
+                if((num_entries + 1U) * 2U > table.size()) {
+                    grow_table();
+                }
+
+                entry_type *entry(find_entry(key, pos));
+                if(NO_NODE == entry->node) {
+                    entry->key = key;
+                    entry->pos = pos;
+                    ++num_entries;
+                }
+
+                return entry->node;
+            }
+
+            entry_type *find_entry(const unsigned key, const unsigned pos) throw() {
+                const unsigned mask(static_cast<unsigned>(table.size()) - 1U);
+                unsigned slot(((key * 2654435761U) ^ (pos * 40503U)) & mask);
+
+                for(; NO_NODE != table[slot].node
+                   && (key != table[slot].key || pos != table[slot].pos);
+                    slot = (slot + 1U) & mask) {
+                    // linear probe
+                }
+
+                return &(table[slot]);
+            }
+
+            void grow_table(void) throw() {
+                std::vector<entry_type> old_table;
+                old_table.swap(table);
+
+                entry_type empty;
+                empty.key = 0;
+                empty.pos = 0;
+                empty.node = NO_NODE;
+                table.assign(old_table.size() * 2U, empty);
+
+                for(unsigned i(0); i < old_table.size(); ++i) {
+                    if(NO_NODE != old_table[i].node) {
+                        *find_entry(old_table[i].key, old_table[i].pos) = old_table[i];
+                    }
+                }
+            }
         };
 
-        static void
-        clear_index(std::vector<earley_item_type *> &index) throw() {
-            for(unsigned i(0); i < index.size(); ++i) {
-                index[i] = 0;
+        /// record that item was derived from pred by sliding the dot over
+        /// cause
+        static void add_link(
+            std::vector<link_type> &links,
+            earley_item_type *item,
+            earley_item_type *pred,
+            earley_item_type *cause
+        ) throw() {
+            const unsigned id(static_cast<unsigned>(links.size()));
+            link_type link;
+            link.pred = pred;
+            link.cause = cause;
+            link.next = NO_LINK;
+
+            if(NO_LINK == item->first_link) {
+                item->first_link = id;
+            } else {
+                links[item->last_link].next = id;
             }
+
+            item->last_link = id;
+            links.push_back(link);
         }
 
         /// allocator type for Earley items
-        typedef fltl::helper::BlockAllocator<
+        typedef fltl::helper::ArenaAllocator<
             earley_item_type, NUM_BLOCKS
         > earley_item_allocator_type;
 
         /// allocator type for Earley sets
-        typedef fltl::helper::BlockAllocator<
+        typedef fltl::helper::ArenaAllocator<
             earley_set_type, NUM_BLOCKS
         > earley_set_allocator_type;
 
-        /// check the index for the existence of item, if it's in, return 0,
-        /// otherwise return the item and add it to the index
+        /// the items of a set with some initial set, sorted by their item
+        /// ids. an entry belongs to a set only if its set field matches,
+        /// so that entries never need to be cleared.
+        class index_entry_type {
+        public:
+            earley_set_type *set;
+            earley_item_type *first;
+        };
+
+        /// look for the item (item_id, initial_set) in a set; if it's not
+        /// there then allocate it and add it to the set. either way, return
+        /// the item.
         static earley_item_type *
         indexed_push(
             earley_set_type *set,
-            std::vector<earley_item_type *> &index,
+            std::vector<index_entry_type> &index,
             earley_item_allocator_type &allocator,
-            earley_item_type *item
+            const symbol_id_type *item_symbol,
+            const unsigned item_id,
+            earley_set_type *initial_set,
+            stats_type &stats
         ) throw() {
 
-            const unsigned offset(item->initial_set->offset);
+            index_entry_type &entry(index[initial_set->offset]);
             earley_item_type *prev(0);
+            earley_item_type *curr(set == entry.set ? entry.first : 0);
 
-            for(earley_item_type *curr(index[offset]);
-                0 != curr;
+            // find the insertion point
+            for(; 0 != curr;
                 prev = curr, curr = curr->next_with_same_initial_set) {
 
-                // found an insertion point
-                if(item->dot < curr->dot) {
-                    item->next_with_same_initial_set = curr;
-
-                    if(0 == prev) {
-                        index[offset] = item;
-                    } else {
-                        prev->next_with_same_initial_set = item;
-                    }
-
-                    set->push(item);
-                    return item;
+                if(item_id < curr->item) {
+                    break;
 
-                // skip
-                } else if(item->dot > curr->dot) {
-                    continue;
-
-                // same dot values, check if the productions are equivalent
-                } else if(curr->production == item->production) {
-                    allocator.deallocate(item);
+                // same dotted production
+                } else if(item_id == curr->item) {
+                    ++(stats.num_duplicates);
                     return curr;
                 }
             }
 
-            // the set was empty
-            if(0 == prev) {
-                index[offset] = item;
+            earley_item_type *item(allocator.allocate());
+            item->item = item_id;
+            item->initial_set = initial_set;
+            item->next_with_same_initial_set = curr;
 
-            // this item is going at the end
+            if(0 == prev) {
+                entry.set = set;
+                entry.first = item;
             } else {
                 prev->next_with_same_initial_set = item;
             }
 
-            set->push(item);
+            push(set, item_symbol, item);
             return item;
         }
 
+        /// add a predicted item X --> * alpha to a set. predicted items are
+        /// never looked up again, so they are not added to the set's index.
+        inline static void predict_push(
+            earley_set_type *set,
+            earley_item_allocator_type &allocator,
+            const symbol_id_type *item_symbol,
+            const unsigned item_id
+        ) throw() {
+            earley_item_type *item(allocator.allocate());
+            item->item = item_id;
+            item->initial_set = set;
+            push(set, item_symbol, item);
+        }
+
+        /// add an item to a set, and to the set's waiting list if the item
+        /// has the form A --> ... * B ...
+        inline static void push(
+            earley_set_type *set,
+            const symbol_id_type *item_symbol,
+            earley_item_type *item
+        ) throw() {
+            const symbol_id_type sym(item_symbol[item->item]);
+            set->push(item);
+            if(0 < sym) {
+                set->wait(static_cast<unsigned>(sym), item);
+            }
+        }
+
+        /// find the Leo item for a variable B that was completed with some
+        /// set as its origin. if the set has exactly one item waiting on B
+        /// and that item has the form A --> ... * B then completing B will
+        /// deterministically complete A, and so on up the chain; only the
+        /// topmost completed item needs to be added to the current set.
+        ///
+        /// the chain is walked iteratively, as right-recursive grammars
+        /// produce chains that are as long as the input.
+        static bool leo_item(
+            const grammar_type &grammar,
+            earley_set_type *set,
+            unsigned var,
+            std::vector<waiting_list_type *> &path,
+            unsigned &top_item,
+            earley_set_type *&top_set
+        ) throw() {
+
+            waiting_list_type *list(0);
+            earley_item_type *waiting_item(0);
+            bool found(false);
+
+            path.clear();
+
+            for(;;) {
+                list = set->waiting_list(var);
+
+                // no such list; this happens for the fake start variable
+                if(0 == list) {
+                    break;
+
+                // memoized
+                } else if(LEO_FOUND == list->leo_state) {
+                    top_item = list->leo_item;
+                    top_set = list->leo_set;
+                    found = true;
+                    break;
+
+                // memoized, or a cycle of unit productions
+                } else if(LEO_UNKNOWN != list->leo_state) {
+                    break;
+                }
+
+                waiting_item = list->first;
+
+                // not deterministic, or B is not the last symbol
+                if(waiting_item != list->last
+                || grammar_type::END_OF_PRODUCTION != grammar.item_symbol[
+                        waiting_item->item + 1U
+                   ]) {
+                    list->leo_state = LEO_NONE;
+                    break;
+                }
+
+                list->leo_state = LEO_IN_PROGRESS;
+                list->leo_item = waiting_item->item + 1U;
+                list->leo_set = waiting_item->initial_set;
+                path.push_back(list);
+
+                var = grammar.item_variable[waiting_item->item];
+                set = waiting_item->initial_set;
+            }
+
+            // fill in the memos on the way back down the chain
+            for(unsigned i(static_cast<unsigned>(path.size())); i-- > 0; ) {
+                list = path[i];
+
+                if(found) {
+                    list->leo_item = top_item;
+                    list->leo_set = top_set;
+                } else {
+                    top_item = list->leo_item;
+                    top_set = list->leo_set;
+                    found = true;
+                }
+
+                list->leo_state = LEO_FOUND;
+            }
+
+            return found;
+        }
+
+        /// read in the next token. if next_token is non-null then one token
+        /// of lookahead is kept: the returned token is a copy that is kept
+        /// in buffer, and next_token is the token after it.
+        static const char *read_token(
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            char *buffer,
+            const char *&next_token
+        ) throw() {
+            if(0 == next_token) {
+                return reader.read();
+            }
+
+            strcpy(buffer, next_token);
+            if('\0' != *buffer) {
+                next_token = reader.read();
+            }
+
+            return buffer;
+        }
+
+        /// find the variables that can begin the input a b ... using the
+        /// FIRST_2 sets, remembering the result for the pair.
+        static const word_type *first2_row(
+            const lookahead_sets_type &lookahead_sets,
+            const unsigned a,
+            const unsigned b,
+            std::map<std::pair<unsigned, unsigned>, unsigned> &offsets,
+            std::vector<word_type> &rows
+        ) throw() {
+            const std::pair<unsigned, unsigned> key(a, b);
+            typename std::map<
+                std::pair<unsigned, unsigned>, unsigned
+            >::iterator pos(offsets.find(key));
+
+            if(offsets.end() != pos) {
+                return &(rows[pos->second]);
+            }
+
+            const unsigned offset(static_cast<unsigned>(rows.size()));
+            rows.resize(offset + lookahead_sets.num_words(), 0UL);
+            lookahead_sets.first2(a, b, &(rows[offset]));
+            offsets.insert(std::make_pair(key, offset));
+
+            return &(rows[offset]);
+        }
+
+        /// record how many items, and how many bytes of items, sets, and
+        /// the structures indexing them, are live at the end of a parse;
+        /// nothing is freed until then.
+        static void measure_live(
+            earley_set_type *first_set,
+            const std::vector<index_entry_type> (&set_index)[2],
+            const std::vector<link_type> &links,
+            const std::vector<bucket_type> &buckets,
+            stats_type &stats
+        ) throw() {
+            unsigned long num_items(0);
+            unsigned long num_bytes(
+                (set_index[0].capacity() + set_index[1].capacity())
+                    * sizeof(index_entry_type)
+                + links.capacity() * sizeof(link_type)
+                + buckets.capacity() * sizeof(bucket_type)
+            );
+
+            for(earley_set_type *set(first_set); 0 != set; set = set->next) {
+                num_items += set->num_items;
+                num_bytes += sizeof(earley_set_type)
+                           + set->num_items * sizeof(earley_item_type)
+                           + set->waiting_capacity * sizeof(waiting_list_type);
+            }
+
+            stats.max_live_items = std::max(stats.max_live_items, num_items);
+            stats.max_live_bytes = std::max(stats.max_live_bytes, num_bytes);
+        }
+
     public:
 
 
-        /// run the parser; assumes that the NULLABLE set is properly filled
-        /// for this grammar
+        /// run the parser; assumes that the NULLABLE set used to compile
+        /// the grammar is properly filled. if lookahead_sets is non-null
+        /// then predictions are filtered by the FIRST_k sets, where k is the
+        /// amount of lookahead (1 or 2). if forest is non-null then the
+        /// parse forest of the input is built into it; Leo items are not
+        /// used when building a forest, as they skip over the derivations
+        /// that make up right-recursive parse trees.
         static bool run(
-            CFG &cfg,
-            std::vector<bool> &is_nullable,
-            const bool use_first_set,
-            std::vector<std::vector<bool> *> &first_terminals,
-            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader
+            const CFG &cfg,
+            const grammar_type &grammar,
+            const lookahead_sets_type *lookahead_sets,
+            const unsigned lookahead,
+            const bool use_leo_items,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats,
+            forest_type *forest
         ) throw() {
 
             bool parse_result(false);
-            const char *token(reader.read());
 
-            // allocator for Earley sets
-            static earley_set_allocator_type set_allocator;
+            // the current token, and the one after it when using two
+            // tokens of lookahead
+            char token_buffer[MAX_TOK_LENGTH + 8U] = {'\0'};
+            const char *next_token(0);
+            if(0 != lookahead_sets && 2U == lookahead) {
+                next_token = reader.read();
+            }
+
+            const char *token(read_token(reader, token_buffer, next_token));
+            const bool build_forest(0 != forest);
+            const bool use_leo(use_leo_items && !build_forest);
 
-            /// allocator for Earley items
-            static earley_item_allocator_type item_allocator;
+            // derivations of items and the buckets of complete items, for
+            // building the parse forest
+            std::vector<link_type> links;
+            std::vector<bucket_type> buckets;
 
-            // the actual start variable; we will end up adding a fake
-            // start variable later
-            const variable_type ASV(cfg.get_start_variable());
+            if(build_forest) {
+                forest->clear();
+            }
+
+            // allocators for Earley sets and items; everything that they
+            // allocate is released at once when the parse is done
+            earley_set_allocator_type set_allocator;
+            earley_item_allocator_type item_allocator;
 
             // is it worth parsing?
             if(0 == cfg.num_productions()
             || !cfg.has_start_variable()
-            || 0 == cfg.num_productions(ASV)) {
+            || 0 == cfg.num_productions(cfg.get_start_variable())) {
                 if(0 == token || '\0' == *token) {
                     io::verbose("Parsed. Accepted empty language.\n");
                     return true;
@@ -259,57 +1112,70 @@ namespace grail { namespace algorithm {
                 }
             }
 
-            // add in a fake start variable; this variable and its productions
-            // will be removed at the end
-            variable_type SV(cfg.add_variable());
-            production_type SP(cfg.add_production(SV, ASV));
-            is_nullable[SV.number()] = is_nullable[ASV.number()];
-
-            if(use_first_set) {
-                first_terminals[SV.number()] = new std::vector<bool>(
-                    *(first_terminals[ASV.number()])
-                );
-            }
+            // flat views of the compiled grammar
+            const symbol_id_type * const item_symbol(&(grammar.item_symbol[0]));
+            const unsigned * const prediction_begin(
+                &(grammar.prediction_begin[0])
+            );
+            const unsigned * const predictions(&(grammar.predictions[0]));
+            const unsigned * const closure_begin(&(grammar.closure_begin[0]));
+            const unsigned * const closure(&(grammar.closure[0]));
+            const std::vector<bool> &is_nullable(grammar.is_nullable);
+            const std::vector<bool> &is_variable_terminal(
+                grammar.is_variable_terminal
+            );
+
+            // indexes for the sets to test membership, indexed by the
+            // offsets of initial sets. one is for the current set, and the
+            // other is for the next set.
+            std::vector<index_entry_type> set_index[2];
+            index_entry_type empty_entry;
+            empty_entry.set = 0;
+            empty_entry.first = 0;
+            set_index[0].assign(2U, empty_entry);
+            set_index[1].assign(2U, empty_entry);
+            unsigned curr_index(0U);
 
-            // set up the base case for the earley parser
-            earley_item_type *curr_item(item_allocator.allocate());
+            // set up the base case for the earley parser; the first item is
+            // START -> . S, where START is the grammar's fake start variable
             earley_set_type *curr_set(set_allocator.allocate());
+            earley_set_type * const first_set(curr_set);
             earley_set_type *prev_set(0);
-
-            earley_item_type *first_item(curr_item);
-            earley_set_type *first_set(curr_set);
-
-            curr_set->next = 0;
-            curr_item->production = SP;
-            curr_item->initial_set = curr_set;
-            curr_set->push(first_item);
-
-            // variables used in the patterns
-            unsigned dot;
-            variable_type A;
-            variable_type B;
-            terminal_type a;
-            production_type prod;
-
-            pattern_type scanner_known((~A) --->* cfg.__(dot) + a + cfg.__);
-            pattern_type scanner_unknown((~A) --->* cfg.__(dot) + ~a + cfg.__);
-            pattern_type predictor((~A) --->* cfg.__(dot) + ~B + cfg.__);
-            pattern_type completer((~A) --->* cfg.__(dot));
-
-            generator_type predictor_related(cfg.search(~prod, B --->* cfg.__));
-            pattern_type completer_related(cfg._ --->* cfg.__(dot) + A + cfg.__);
+            earley_item_type *curr_item(indexed_push(
+                curr_set,
+                set_index[curr_index],
+                item_allocator,
+                item_symbol,
+                grammar.start_item,
+                curr_set,
+                stats
+            ));
+
+            // the symbol after the dot of the current item
+            symbol_id_type sym;
+            unsigned B(0);
+
+            // scratch space for finding Leo items
+            std::vector<waiting_list_type *> leo_path;
+            unsigned leo_top_item(0);
+            earley_set_type *leo_top_set(0);
 
             // terminals
             unsigned i(0);
+            unsigned a(0);
             alphabet_type lexeme;
+            alphabet_type next_lexeme;
             bool solve_for_variable_terminal(false);
 
-            // indexes for the sets to test membership, +1 as there are n+1
-            // sets (S_0 ... S_n) for a string of length n.
-            std::vector<earley_item_type *> set_index[2];
-            set_index[0].assign(1U, static_cast<earley_item_type *>(0));
-            set_index[1].assign(1U, static_cast<earley_item_type *>(0));
-            unsigned curr_index(0U);
+            // the variables that can be usefully predicted in the current
+            // set, or null if all variables can be predicted
+            const word_type *predict_row(0);
+            std::map<std::pair<unsigned, unsigned>, unsigned> first2_offsets;
+            std::vector<word_type> first2_rows;
+
+            // the offset of the last set in which each variable was
+            // predicted
+            std::vector<unsigned> predicted_in(grammar.num_variables, ~0U);
 
             // for each set
             bool not_at_end(true);
@@ -321,9 +1187,12 @@ namespace grail { namespace algorithm {
                 prev_set = curr_set,
                 curr_set = curr_set->next,
                 curr_index = 1U - curr_index,
-                ++i, token = reader.read()) {
+                ++i, token = read_token(reader, token_buffer, next_token)) {
 
-                set_index[curr_index].push_back(0);
+                // the next set can have items with any of S_0 ... S_{i+1}
+                // as their initial set
+                set_index[0].push_back(empty_entry);
+                set_index[1].push_back(empty_entry);
 
                 // done the tokens
                 if(0 == token || '\0' == *token) {
@@ -335,13 +1204,13 @@ namespace grail { namespace algorithm {
                     traits_type::unserialize(token, lexeme);
 
                     // try to get the terminal
-                    solve_for_variable_terminal = !cfg.has_terminal(lexeme);
-                    if(!solve_for_variable_terminal) {
-                        a = cfg.get_terminal(lexeme);
+                    a = grammar.find_terminal(lexeme);
+                    solve_for_variable_terminal = 0U == a;
 
                     // found a token but this grammar has no variable terminals
                     // and so it can't be substituted for anything
-                    } else if(0 == cfg.num_variable_terminals()){
+                    if(solve_for_variable_terminal
+                    && 0 == cfg.num_variable_terminals()) {
 
                         io::verbose(
                             "    Unrecognized terminal '%s'.\n",
@@ -351,6 +1220,43 @@ namespace grail { namespace algorithm {
                     }
 
                     io::verbose("    Looking at '%s'...\n", token);
+
+                    if(build_forest) {
+                        forest->add_lexeme(token);
+                    }
+                }
+
+                predict_row = 0;
+                if(0 != lookahead_sets
+                && not_at_end
+                && !solve_for_variable_terminal) {
+                    predict_row = lookahead_sets->first.row(a);
+
+                    // if the next token is unknown then it might be a
+                    // variable terminal; stick with one token of lookahead
+                    if(0 != next_token) {
+                        if('\0' == *next_token) {
+                            predict_row = first2_row(
+                                *lookahead_sets,
+                                a,
+                                lookahead_sets_type::END_OF_INPUT,
+                                first2_offsets,
+                                first2_rows
+                            );
+                        } else {
+                            traits_type::unserialize(next_token, next_lexeme);
+                            const unsigned b(grammar.find_terminal(next_lexeme));
+                            if(0U != b) {
+                                predict_row = first2_row(
+                                    *lookahead_sets,
+                                    a,
+                                    b,
+                                    first2_offsets,
+                                    first2_rows
+                                );
+                            }
+                        }
+                    }
                 }
 
                 // for each item
@@ -359,73 +1265,185 @@ namespace grail { namespace algorithm {
                     0 != curr_item;
                     curr_item = curr_item->next) {
 
-                    // move the dot to where the current item is looking so
-                    // that the patterns see the right value
-                    dot = curr_item->dot;
+                    sym = item_symbol[curr_item->item];
 
                     // the item has the form A --> ... * B ...
-                    if(predictor.match(curr_item->production)) {
+                    if(0 < sym) {
+
+                        B = static_cast<unsigned>(sym);
 
                         // if B is nullable then add A --> ... B * ... to
                         // the item set
-                        if(is_nullable[B.number()]) {
+                        if(is_nullable[B]) {
 
-                            next_item = item_allocator.allocate();
-                            next_item->scanned_from(curr_item);
-                            indexed_push(
+                            next_item = indexed_push(
                                 curr_set,
                                 set_index[curr_index],
                                 item_allocator,
-                                next_item
+                                item_symbol,
+                                curr_item->item + 1U,
+                                curr_item->initial_set,
+                                stats
                             );
+
+                            if(build_forest) {
+                                add_link(links, next_item, curr_item, 0);
+                            }
                         }
 
-                        // if we're using FIRST sets then use them to skip
-                        // useless predictions
-                        if(use_first_set && not_at_end
-                        && !solve_for_variable_terminal
-                        && !(first_terminals[B.number()]->operator[](a.number()))) {
+                        // B, and everything that predicting B leads to,
+                        // has already been predicted in this set
+                        if(i == predicted_in[B]) {
                             continue;
                         }
 
-                        // for each B --> alpha, add B --> * alpha to the
-                        // item set
-                        for(predictor_related.rewind();
-                            predictor_related.match_next();) {
+                        // for each X in the prediction closure of B, and
+                        // for each X --> alpha, add X --> * alpha to the
+                        // item set. these items can only be made here, and
+                        // each variable is visited once per set, so they
+                        // are pushed without checking for duplicates.
+                        for(unsigned c(closure_begin[B]),
+                                     max_c(closure_begin[B + 1U]);
+                            c < max_c;
+                            ++c) {
+
+                            const unsigned X(closure[c]);
+                            if(i == predicted_in[X]) {
+                                continue;
+                            }
+
+                            predicted_in[X] = i;
+
+                            // if we're using FIRST sets then use them to
+                            // skip useless predictions
+                            if(0 != predict_row
+                            && !bit_matrix_type::test(predict_row, X)) {
+                                continue;
+                            }
+
+                            for(unsigned p(prediction_begin[X]),
+                                         max_p(prediction_begin[X + 1U]);
+                                p < max_p;
+                                ++p) {
+
+                                predict_push(
+                                    curr_set,
+                                    item_allocator,
+                                    item_symbol,
+                                    predictions[p]
+                                );
+                            }
+
+                            stats.num_predictions += (
+                                prediction_begin[X + 1U] - prediction_begin[X]
+                            );
+                        }
 
-                            next_item = item_allocator.allocate();
-                            next_item->predicted_from(curr_set, prod);
+                    // the item has the form A --> ... *
+                    } else if(grammar_type::END_OF_PRODUCTION == sym) {
+
+                        const unsigned A(
+                            grammar.item_variable[curr_item->item]
+                        );
+                        waiting_list_type *list(
+                            curr_item->initial_set->waiting_list(A)
+                        );
+                        const bool is_empty_span(
+                            curr_set == curr_item->initial_set
+                        );
+                        unsigned num_visited(0);
+
+                        ++(stats.num_completions);
+
+                        // nothing is waiting on A; this only happens for the
+                        // fake start variable
+                        if(0 == list) {
+                            continue;
+                        }
 
+                        // A was already completed in this set with the same
+                        // origin by another item, so completing it again
+                        // would not add anything new. empty spans are
+                        // derived through the nullable variables instead.
+                        if(curr_set == list->completed_in) {
+                            if(build_forest && !is_empty_span) {
+                                buckets[list->bucket].last->next_waiting = curr_item;
+                                buckets[list->bucket].last = curr_item;
+                                curr_item->next_waiting = 0;
+                                curr_item->node = list->bucket;
+                            }
+                            continue;
+                        }
+
+                        list->completed_in = curr_set;
+
+                        if(build_forest && !is_empty_span) {
+                            bucket_type bucket;
+                            bucket.first = curr_item;
+                            bucket.last = curr_item;
+                            bucket.end = curr_set->offset;
+                            bucket.node = NO_NODE;
+
+                            list->bucket = static_cast<unsigned>(buckets.size());
+                            buckets.push_back(bucket);
+                            curr_item->next_waiting = 0;
+                            curr_item->node = list->bucket;
+                        }
+
+                        // skip to the top of a deterministic reduction path;
+                        // the initial set must be complete to do this.
+                        if(use_leo
+                        && !is_empty_span
+                        && leo_item(
+                            grammar,
+                            curr_item->initial_set,
+                            A,
+                            leo_path,
+                            leo_top_item,
+                            leo_top_set
+                        )) {
                             indexed_push(
                                 curr_set,
                                 set_index[curr_index],
                                 item_allocator,
-                                next_item
+                                item_symbol,
+                                leo_top_item,
+                                leo_top_set,
+                                stats
                             );
-                        }
 
-                    // the item has the form A --> ... *
-                    } else if(completer.match(curr_item->production)) {
+                            ++(stats.num_leo_completions);
+                            continue;
+                        }
 
-                        for(earley_item_type *rel_item(curr_item->initial_set->first);
+                        // only visit those items of the initial set that
+                        // are waiting on A
+                        for(earley_item_type *rel_item(
+                                curr_item->initial_set->waiting_on(A)
+                            );
                             0 != rel_item;
-                            rel_item = rel_item->next) {
+                            rel_item = rel_item->next_waiting, ++num_visited) {
 
-                            dot = rel_item->dot;
-                            if(!completer_related.match(rel_item->production)) {
-                                continue;
-                            }
-
-                            next_item = item_allocator.allocate();
-                            next_item->scanned_from(rel_item);
                             next_item = indexed_push(
                                 curr_set,
                                 set_index[curr_index],
                                 item_allocator,
-                                next_item
+                                item_symbol,
+                                rel_item->item + 1U,
+                                rel_item->initial_set,
+                                stats
                             );
+
+                            if(build_forest && !is_empty_span) {
+                                add_link(links, next_item, rel_item, curr_item);
+                            }
                         }
 
+                        stats.num_completer_visits += num_visited;
+                        stats.num_completer_skips += (
+                            curr_item->initial_set->num_items - num_visited
+                        );
+
                     // try to "solve" this terminal
                     } else if(not_at_end) {
 
@@ -436,14 +1454,15 @@ namespace grail { namespace algorithm {
                             // try to match this production as
                             // A --> ... * a ... for some variable terminal
                             // a.
-                            if(!scanner_unknown.match(curr_item->production)
-                            || !cfg.is_variable_terminal(a)) {
+                            if(!is_variable_terminal[static_cast<unsigned>(-sym)]) {
                                 continue;
                             }
 
                             io::verbose(
                                 "        Substituting as %s...\n",
-                                cfg.get_name(a)
+                                cfg.get_name(
+                                    grammar.terminals[static_cast<unsigned>(-sym)]
+                                )
                             );
 
                         // we know the terminal of this lexeme
@@ -452,7 +1471,7 @@ namespace grail { namespace algorithm {
                             // try to match this production as
                             // A --> ... * a ... where "a" is the terminal
                             // of the current lexeme.
-                            if(!scanner_known.match(curr_item->production)) {
+                            if(a != static_cast<unsigned>(-sym)) {
                                 continue;
                             }
                         }
@@ -461,20 +1480,27 @@ namespace grail { namespace algorithm {
                         if(0 == next_set) {
                             next_set = set_allocator.allocate();
                             curr_set->set_next(next_set);
-                            set_index[1U - curr_index].push_back(0);
-                            clear_index(set_index[1U - curr_index]);
                         }
 
-                        next_item = item_allocator.allocate();
-                        next_item->scanned_from(curr_item);
                         next_item = indexed_push(
                             next_set,
                             set_index[1U - curr_index],
                             item_allocator,
-                            next_item
+                            item_symbol,
+                            curr_item->item + 1U,
+                            curr_item->initial_set,
+                            stats
                         );
+
+                        ++(stats.num_scans);
+
+                        if(build_forest) {
+                            add_link(links, next_item, curr_item, 0);
+                        }
                     }
                 }
+
+                stats.add_set(curr_set->num_items);
             }
 
             if(0 != token && '\0' == *token) {
@@ -493,10 +1519,21 @@ namespace grail { namespace algorithm {
                     0 != curr_item;
                     curr_item = curr_item->next) {
 
-                    if(1U == curr_item->dot
-                    && SV == curr_item->production.variable()) {
+                    if(grammar.accept_item == curr_item->item) {
                         io::verbose("Successfully parsed.\n");
                         parse_result = true;
+
+                        if(build_forest) {
+                            io::verbose("Building parse forest...\n");
+                            forest_builder_type builder(
+                                grammar,
+                                *forest,
+                                links,
+                                buckets
+                            );
+                            builder.build(curr_item, curr_set->offset);
+                        }
+
                         goto done;
                     }
                 }
@@ -509,26 +1546,12 @@ namespace grail { namespace algorithm {
 
         done:
 
-            io::verbose("Cleaning up Earley items/sets...\n");
+            measure_live(first_set, set_index, links, buckets, stats);
 
-            next_set = 0;
-            for(curr_set = first_set; 0 != curr_set; curr_set = next_set) {
-                next_set = curr_set->next;
-
-                for(curr_item = curr_set->first;
-                    0 != curr_item;
-                    curr_item = next_item) {
-
-                    next_item = curr_item->next;
-
-                    item_allocator.deallocate(curr_item);
-                }
-
-                set_allocator.deallocate(curr_set);
-            }
+            io::verbose("Cleaning up Earley items/sets...\n");
 
-            // done; clean up
-            cfg.unsafe_remove_variable(SV);
+            item_allocator.reset();
+            set_allocator.reset();
 
             io::verbose("Done.\n");
 
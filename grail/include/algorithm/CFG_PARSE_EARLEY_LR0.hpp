@@ -0,0 +1,790 @@
+/*
+ * CFG_PARSE_EARLEY_LR0.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef FLTL_CFG_PARSE_EARLEY_LR0_HPP_
+#define FLTL_CFG_PARSE_EARLEY_LR0_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LR0EpsilonAutomaton.hpp"
+
+#include "grail/include/io/verbose.hpp"
+#include "grail/include/io/UTF8FileTokBuffer.hpp"
+
+namespace grail { namespace algorithm {
+
+    /// recognize a token stream with the Earley parser of Aycock and
+    /// Horspool ("Practical Earley Parsing"). instead of one Earley item
+    /// per dotted production, each Earley item is a state of the grammar's
+    /// split epsilon-LR(0) automaton together with an origin, so a single
+    /// item stands for all of the dotted productions of its state.
+    ///
+    /// nullable variables need no special handling at run time: the states
+    /// are closed under sliding the dot over them, and so a completion can
+    /// never add anything to the Earley set that it started in. only
+    /// completions of non-empty spans are done, and the items that they
+    /// advance are looked up once per (origin set, variable) pair.
+    ///
+    /// finished sets are only needed for as long as some item can still
+    /// complete back into them. when streaming, the sets that no item of
+    /// the current set can reach through the origins of items are garbage
+    /// collected once the finished sets hold MIN_COLLECT_ITEMS items, and
+    /// then whenever they hold twice as many items as the last collection
+    /// left. for grammars whose items only look back a bounded number of
+    /// sets, e.g. S --> S line | line, each collection leaves a bounded
+    /// number of items, so memory stays bounded.
+    template <typename AlphaT, const unsigned MAX_TOK_LENGTH>
+    class CFG_PARSE_EARLEY_LR0 {
+    public:
+
+        // take off the templates!
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef cfg::LR0EpsilonAutomaton<AlphaT> automaton_type;
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+            // number of Earley items in all sets
+            unsigned long num_items;
+
+            // number of times that a variable was completed with some
+            // origin
+            unsigned long num_completions;
+
+            // number of items of earlier sets that were visited to find the
+            // items advanced by a completion
+            unsigned long num_completer_visits;
+
+            // number of times that unreachable sets were collected
+            unsigned long num_collections;
+
+            // the largest number of items kept in finished sets
+            unsigned long max_kept_items;
+
+            // the largest number of items that a collection left in the
+            // finished sets
+            unsigned long max_items_after_collection;
+
+            stats_type(void)
+                : num_items(0)
+                , num_completions(0)
+                , num_completer_visits(0)
+                , num_collections(0)
+                , max_kept_items(0)
+                , max_items_after_collection(0)
+            { }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_items += that.num_items;
+                num_completions += that.num_completions;
+                num_completer_visits += that.num_completer_visits;
+                num_collections += that.num_collections;
+                if(max_kept_items < that.max_kept_items) {
+                    max_kept_items = that.max_kept_items;
+                }
+                if(max_items_after_collection
+                 < that.max_items_after_collection) {
+                    max_items_after_collection =
+                        that.max_items_after_collection;
+                }
+            }
+        };
+
+    private:
+
+        enum {
+            NO_STATE = automaton_type::NO_STATE
+        };
+
+        /// Earley item: a state of the automaton and the offset of the set
+        /// where its kernel items were predicted
+        class earley_item_type {
+        public:
+            unsigned state;
+            unsigned origin;
+        };
+
+        /// a set of Earley items, with an open-addressed hash table for
+        /// testing membership. the table is reused from set to set; a slot
+        /// is only in use if its generation is the current one.
+        class earley_set_type {
+        public:
+
+            std::vector<earley_item_type> items;
+
+        private:
+
+            class slot_type {
+            public:
+                unsigned state;
+                unsigned origin;
+                unsigned generation;
+            };
+
+            std::vector<slot_type> slots;
+            unsigned generation;
+
+        public:
+
+            earley_set_type(void) throw()
+                : items()
+                , slots()
+                , generation(1U)
+            {
+                slot_type empty_slot;
+                empty_slot.state = 0U;
+                empty_slot.origin = 0U;
+                empty_slot.generation = 0U;
+                slots.assign(64U, empty_slot);
+            }
+
+            void clear(void) throw() {
+                items.clear();
+                ++generation;
+            }
+
+            /// add an item to the set if it's not already there
+            void push(const unsigned state, const unsigned origin) throw() {
+                if((items.size() + 1U) * 2U > slots.size()) {
+                    grow();
+                }
+
+                if(insert(state, origin)) {
+                    earley_item_type item;
+                    item.state = state;
+                    item.origin = origin;
+                    items.push_back(item);
+                }
+            }
+
+        private:
+
+            bool insert(const unsigned state, const unsigned origin) throw() {
+                const unsigned mask(static_cast<unsigned>(slots.size()) - 1U);
+                unsigned slot(
+                    ((state * 2654435761U) ^ (origin * 40503U)) & mask
+                );
+
+                for(; generation == slots[slot].generation;
+                    slot = (slot + 1U) & mask) {
+                    if(state == slots[slot].state
+                    && origin == slots[slot].origin) {
+                        return false;
+                    }
+                }
+
+                slots[slot].state = state;
+                slots[slot].origin = origin;
+                slots[slot].generation = generation;
+                return true;
+            }
+
+            void grow(void) throw() {
+                slot_type empty_slot;
+                empty_slot.state = 0U;
+                empty_slot.origin = 0U;
+                empty_slot.generation = 0U;
+
+                slots.assign(slots.size() * 2U, empty_slot);
+                generation = 1U;
+
+                for(unsigned i(0); i < items.size(); ++i) {
+                    insert(items[i].state, items[i].origin);
+                }
+            }
+        };
+
+        /// the items of the finished sets, in order of their offsets. the
+        /// items of the jth kept set are items[begin[j]] to
+        /// items[begin[j + 1]]. until sets are collected, the jth kept set
+        /// is the set at offset j.
+        ///
+        /// a finished set is only ever looked at to advance its items over
+        /// a completed variable, so only the items whose states have
+        /// transitions on variables are kept.
+        class finished_sets_type {
+        public:
+
+            const automaton_type &automaton;
+            std::vector<earley_item_type> items;
+            std::vector<unsigned> offsets;
+            std::vector<unsigned> begin;
+
+            finished_sets_type(const automaton_type &automaton_) throw()
+                : automaton(automaton_)
+                , items()
+                , offsets()
+                , begin(1U, 0U)
+            { }
+
+            /// can an item in this state ever be advanced over a variable?
+            /// transitions on terminals come before those on variables.
+            bool waits_on_variable(const unsigned state) const throw() {
+                const unsigned end(automaton.transition_begin[state + 1U]);
+                return automaton.transition_begin[state] < end
+                    && 0 < automaton.transition_symbol[end - 1U];
+            }
+
+            /// can an item in this state ever be advanced at all?
+            bool waits(const unsigned state) const throw() {
+                return automaton.transition_begin[state]
+                     < automaton.transition_begin[state + 1U];
+            }
+
+            void add(
+                const unsigned offset,
+                const std::vector<earley_item_type> &set_items
+            ) throw() {
+                for(unsigned k(0); k < set_items.size(); ++k) {
+                    if(waits_on_variable(set_items[k].state)) {
+                        items.push_back(set_items[k]);
+                    }
+                }
+
+                offsets.push_back(offset);
+                begin.push_back(static_cast<unsigned>(items.size()));
+            }
+
+            /// find the index of the kept set at some offset
+            unsigned find(const unsigned offset) const throw() {
+                if(offset < offsets.size() && offset == offsets[offset]) {
+                    return offset;
+                }
+
+                return static_cast<unsigned>(std::lower_bound(
+                    offsets.begin(),
+                    offsets.end(),
+                    offset
+                ) - offsets.begin());
+            }
+
+            bool contains(const unsigned offset) const throw() {
+                const unsigned j(find(offset));
+                return j < offsets.size() && offset == offsets[j];
+            }
+
+            /// remove the sets that the items of the current set, which was
+            /// the last set added, cannot reach through the origins of items
+            /// that can still be advanced. origins always point back, so one
+            /// backward sweep finds every reachable set.
+            void collect(
+                const std::vector<earley_item_type> &curr_items
+            ) throw() {
+                const unsigned num_sets(static_cast<unsigned>(offsets.size()));
+                std::vector<bool> is_live(num_sets, false);
+                is_live[num_sets - 1U] = true;
+
+                for(unsigned k(0); k < curr_items.size(); ++k) {
+                    if(waits(curr_items[k].state)) {
+                        is_live[find(curr_items[k].origin)] = true;
+                    }
+                }
+
+                for(unsigned j(num_sets); j-- > 0; ) {
+                    if(!is_live[j]) {
+                        continue;
+                    }
+
+                    for(unsigned k(begin[j]); k < begin[j + 1U]; ++k) {
+                        if(offsets[j] != items[k].origin) {
+                            is_live[find(items[k].origin)] = true;
+                        }
+                    }
+                }
+
+                // compact the kept sets in place
+                unsigned num_kept(0U);
+                unsigned next_item(0U);
+
+                for(unsigned j(0); j < num_sets; ++j) {
+                    const unsigned first(begin[j]);
+                    const unsigned last(begin[j + 1U]);
+
+                    if(!is_live[j]) {
+                        continue;
+                    }
+
+                    for(unsigned k(first); k < last; ++k) {
+                        items[next_item++] = items[k];
+                    }
+
+                    offsets[num_kept] = offsets[j];
+                    begin[++num_kept] = next_item;
+                }
+
+                items.resize(next_item);
+                offsets.resize(num_kept);
+                begin.resize(num_kept + 1U);
+            }
+        };
+
+        /// the items that completing a variable advances in some earlier
+        /// set: for each item (q, k) of the set, the item (goto(q, A), k).
+        /// these are found the first time that A is completed with the set
+        /// as its origin, and are then reused.
+        class advance_list_type {
+        public:
+            unsigned set;
+            unsigned variable;
+            unsigned begin;
+            unsigned end;
+
+            // the last set in which this list was used
+            unsigned completed_in;
+        };
+
+        /// open-addressed hash table of advance lists, keyed by their
+        /// origin set and variable
+        class advance_table_type {
+        public:
+
+            std::vector<advance_list_type> lists;
+            std::vector<earley_item_type> advanced;
+
+        private:
+
+            enum {
+                NO_LIST = 0xFFFFFFFFU
+            };
+
+            std::vector<unsigned> slots;
+
+        public:
+
+            advance_table_type(void) throw()
+                : lists()
+                , advanced()
+                , slots(64U, static_cast<unsigned>(NO_LIST))
+            { }
+
+            /// find the advance list for some origin set and variable, or
+            /// make an empty one
+            advance_list_type &find(
+                const unsigned set,
+                const unsigned variable,
+                bool &is_new
+            ) throw() {
+                if((lists.size() + 1U) * 2U > slots.size()) {
+                    grow();
+                }
+
+                const unsigned slot(find_slot(set, variable));
+                is_new = NO_LIST == slots[slot];
+
+                if(is_new) {
+                    advance_list_type list;
+                    list.set = set;
+                    list.variable = variable;
+                    list.begin = static_cast<unsigned>(advanced.size());
+                    list.end = list.begin;
+                    list.completed_in = NO_LIST;
+
+                    slots[slot] = static_cast<unsigned>(lists.size());
+                    lists.push_back(list);
+                }
+
+                return lists[slots[slot]];
+            }
+
+            /// drop the advance lists whose origin sets were collected
+            void retain(const finished_sets_type &sets) throw() {
+                unsigned num_kept(0U);
+                unsigned next_advanced(0U);
+
+                for(unsigned l(0); l < lists.size(); ++l) {
+                    advance_list_type list(lists[l]);
+                    if(!sets.contains(list.set)) {
+                        continue;
+                    }
+
+                    const unsigned list_begin(next_advanced);
+                    for(unsigned j(list.begin); j < list.end; ++j) {
+                        advanced[next_advanced++] = advanced[j];
+                    }
+
+                    list.begin = list_begin;
+                    list.end = next_advanced;
+                    lists[num_kept++] = list;
+                }
+
+                lists.resize(num_kept);
+                advanced.resize(next_advanced);
+
+                unsigned num_slots(64U);
+                for(; (num_kept + 1U) * 2U > num_slots; num_slots *= 2U) {
+                    // find the smallest table that fits
+                }
+
+                slots.assign(num_slots, static_cast<unsigned>(NO_LIST));
+                for(unsigned l(0); l < lists.size(); ++l) {
+                    slots[find_slot(lists[l].set, lists[l].variable)] = l;
+                }
+            }
+
+        private:
+
+            unsigned find_slot(
+                const unsigned set,
+                const unsigned variable
+            ) const throw() {
+                const unsigned mask(static_cast<unsigned>(slots.size()) - 1U);
+                unsigned slot(
+                    ((set * 2654435761U) ^ (variable * 40503U)) & mask
+                );
+
+                for(; NO_LIST != slots[slot]; slot = (slot + 1U) & mask) {
+                    const advance_list_type &list(lists[slots[slot]]);
+                    if(set == list.set && variable == list.variable) {
+                        break;
+                    }
+                }
+
+                return slot;
+            }
+
+            void grow(void) throw() {
+                slots.assign(slots.size() * 2U, static_cast<unsigned>(NO_LIST));
+                for(unsigned i(0); i < lists.size(); ++i) {
+                    slots[find_slot(lists[i].set, lists[i].variable)] = i;
+                }
+            }
+        };
+
+        /// add the item (state, origin) to a set, along with the non-kernel
+        /// item that it predicts
+        inline static void push(
+            const automaton_type &automaton,
+            earley_set_type &set,
+            const unsigned set_offset,
+            const unsigned state,
+            const unsigned origin
+        ) throw() {
+            set.push(state, origin);
+
+            const unsigned predicted(automaton.epsilon_target[state]);
+            if(NO_STATE != predicted) {
+                set.push(predicted, set_offset);
+            }
+        }
+
+        enum {
+            // the fewest items that finished sets can hold before they are
+            // collected
+            MIN_COLLECT_ITEMS = 1U << 16U,
+
+            // offsets are unsigned, so streams are cut off before this many
+            // tokens
+            MAX_OFFSET = 0xFFFFFFFEU
+        };
+
+        /// ignores the prefixes of the input that are sentences
+        class ignore_prefixes_type {
+        public:
+            void accept_prefix(const unsigned) throw() { }
+        };
+
+        /// recognize the input. listener.accept_prefix(n) is called for
+        /// each n such that the first n tokens of the input are a sentence
+        /// of the grammar. if collect is true then the finished sets that
+        /// can no longer be completed into are thrown away whenever the
+        /// kept items double.
+        template <typename ListenerT>
+        static bool recognize(
+            const CFG &cfg,
+            const grammar_type &grammar,
+            const automaton_type &automaton,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats,
+            ListenerT &listener,
+            const bool collect
+        ) throw() {
+
+            const char *token(reader.read());
+
+            // is it worth parsing?
+            if(0 == cfg.num_productions()
+            || !cfg.has_start_variable()
+            || 0 == cfg.num_productions(cfg.get_start_variable())) {
+                if(0 == token || '\0' == *token) {
+                    io::verbose("Parsed. Accepted empty language.\n");
+                    return true;
+                } else {
+                    io::verbose("Failed to parse. Language is empty.\n");
+                    return false;
+                }
+            }
+
+            const std::vector<bool> &is_variable_terminal(
+                grammar.is_variable_terminal
+            );
+
+            // the items of the finished sets
+            finished_sets_type finished(automaton);
+            unsigned collect_at(MIN_COLLECT_ITEMS);
+
+            // the set being worked on, and the set after it
+            earley_set_type sets[2];
+            unsigned curr(0U);
+
+            advance_table_type advance_table;
+            alphabet_type lexeme;
+
+            push(automaton, sets[curr], 0U, 0U, 0U);
+
+            for(unsigned i(0);; ++i, token = reader.read()) {
+
+                earley_set_type &curr_set(sets[curr]);
+                earley_set_type &next_set(sets[1U - curr]);
+                const bool at_end(0 == token || '\0' == *token);
+                bool can_scan(!at_end);
+                bool solve_for_variable_terminal(false);
+                unsigned a(0);
+
+                next_set.clear();
+
+                if(at_end) {
+                    io::verbose("    Looking at EOF\n");
+
+                } else {
+                    traits_type::unserialize(token, lexeme);
+                    a = grammar.find_terminal(lexeme);
+                    solve_for_variable_terminal = 0U == a;
+
+                    // the set is still finished so that a sentence that
+                    // ends right before the token is reported
+                    if(solve_for_variable_terminal
+                    && 0 == cfg.num_variable_terminals()) {
+                        io::verbose("    Unrecognized terminal '%s'.\n", token);
+                        can_scan = false;
+                    } else {
+                        io::verbose("    Looking at '%s'...\n", token);
+                    }
+                }
+
+                if(MAX_OFFSET == i) {
+                    io::verbose("    Input is too long.\n");
+                    break;
+                }
+
+                // for each item; the set grows while it is being walked
+                for(unsigned k(0); k < curr_set.items.size(); ++k) {
+                    const unsigned state(curr_set.items[k].state);
+                    const unsigned origin(curr_set.items[k].origin);
+
+                    // scan
+                    if(!can_scan) {
+                        // nothing to scan
+
+                    } else if(!solve_for_variable_terminal) {
+                        const unsigned target(automaton.next_state(
+                            state,
+                            -static_cast<symbol_id_type>(a)
+                        ));
+
+                        if(NO_STATE != target) {
+                            push(automaton, next_set, i + 1U, target, origin);
+                        }
+
+                    // try to substitute a variable terminal for the token;
+                    // terminal transitions come first
+                    } else {
+                        for(unsigned t(automaton.transition_begin[state]),
+                                     max_t(automaton.transition_begin[state + 1U]);
+                            t < max_t && 0 > automaton.transition_symbol[t];
+                            ++t) {
+
+                            const unsigned term(static_cast<unsigned>(
+                                -automaton.transition_symbol[t]
+                            ));
+
+                            if(is_variable_terminal[term]) {
+                                push(
+                                    automaton, next_set, i + 1U,
+                                    automaton.transition_target[t], origin
+                                );
+                            }
+                        }
+                    }
+
+                    // complete; completions of empty spans add nothing
+                    if(origin == i) {
+                        continue;
+                    }
+
+                    for(unsigned r(automaton.reduction_begin[state]),
+                                 max_r(automaton.reduction_begin[state + 1U]);
+                        r < max_r;
+                        ++r) {
+
+                        const unsigned A(automaton.reduction_variable[r]);
+                        bool is_new(false);
+                        advance_list_type &list(
+                            advance_table.find(origin, A, is_new)
+                        );
+
+                        // A was already completed with this origin
+                        if(i == list.completed_in) {
+                            continue;
+                        }
+
+                        list.completed_in = i;
+                        ++(stats.num_completions);
+
+                        // find the items that A advances in the origin set
+                        if(is_new) {
+                            const unsigned o(finished.find(origin));
+                            const unsigned min_j(finished.begin[o]);
+                            const unsigned max_j(finished.begin[o + 1U]);
+
+                            for(unsigned j(min_j); j < max_j; ++j) {
+                                const earley_item_type &item(
+                                    finished.items[j]
+                                );
+                                const unsigned target(automaton.next_state(
+                                    item.state,
+                                    static_cast<symbol_id_type>(A)
+                                ));
+
+                                if(NO_STATE != target) {
+                                    earley_item_type advanced;
+                                    advanced.state = target;
+                                    advanced.origin = item.origin;
+                                    advance_table.advanced.push_back(advanced);
+                                }
+                            }
+
+                            stats.num_completer_visits += max_j - min_j;
+
+                            list.end = static_cast<unsigned>(
+                                advance_table.advanced.size()
+                            );
+                        }
+
+                        for(unsigned j(list.begin); j < list.end; ++j) {
+                            push(
+                                automaton, curr_set, i,
+                                advance_table.advanced[j].state,
+                                advance_table.advanced[j].origin
+                            );
+                        }
+                    }
+                }
+
+                // the set is done
+                stats.num_items += curr_set.items.size();
+                finished.add(i, curr_set.items);
+
+                if(stats.max_kept_items < finished.items.size()) {
+                    stats.max_kept_items = finished.items.size();
+                }
+
+                if(collect && collect_at <= finished.items.size()) {
+                    finished.collect(curr_set.items);
+                    advance_table.retain(finished);
+                    ++(stats.num_collections);
+
+                    if(stats.max_items_after_collection
+                     < finished.items.size()) {
+                        stats.max_items_after_collection =
+                            finished.items.size();
+                    }
+
+                    collect_at = 2U * static_cast<unsigned>(
+                        finished.items.size()
+                    );
+                    if(collect_at < MIN_COLLECT_ITEMS) {
+                        collect_at = MIN_COLLECT_ITEMS;
+                    }
+                }
+
+                // look for the accept item START --> S . with the first
+                // set as its origin
+                bool is_sentence(false);
+                for(unsigned k(0); k < curr_set.items.size(); ++k) {
+                    if(0U == curr_set.items[k].origin
+                    && automaton.is_accepting[curr_set.items[k].state]) {
+                        is_sentence = true;
+                        break;
+                    }
+                }
+
+                if(is_sentence) {
+                    listener.accept_prefix(i);
+                }
+
+                if(at_end) {
+                    if(is_sentence) {
+                        io::verbose("Successfully parsed.\n");
+                        return true;
+                    }
+                    break;
+                }
+
+                // nothing could scan the token
+                if(next_set.items.empty()) {
+                    break;
+                }
+
+                curr = 1U - curr;
+            }
+
+            io::verbose("Failed to parse all input.\n");
+            return false;
+        }
+
+    public:
+
+        /// run the parser; assumes that the NULLABLE set used to compile
+        /// the grammar is properly filled, and that the automaton was built
+        /// from the compiled grammar.
+        static bool run(
+            const CFG &cfg,
+            const grammar_type &grammar,
+            const automaton_type &automaton,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats
+        ) throw() {
+            ignore_prefixes_type ignore;
+            return recognize(
+                cfg, grammar, automaton, reader, stats, ignore, false
+            );
+        }
+
+        /// run the parser on a stream of any length, in memory that is
+        /// bounded when the grammar only looks back a bounded number of
+        /// sets. listener.accept_prefix(n) is called as soon as the first
+        /// n tokens of the stream are known to be a sentence.
+        template <typename ListenerT>
+        static bool run_stream(
+            const CFG &cfg,
+            const grammar_type &grammar,
+            const automaton_type &automaton,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats,
+            ListenerT &listener
+        ) throw() {
+            return recognize(
+                cfg, grammar, automaton, reader, stats, listener, true
+            );
+        }
+    };
+}}
+
+#endif /* FLTL_CFG_PARSE_EARLEY_LR0_HPP_ */
@@ -0,0 +1,540 @@
+/*
+ * CFG_PARSE_GLL.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef FLTL_CFG_PARSE_GLL_HPP_
+#define FLTL_CFG_PARSE_GLL_HPP_
+
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/GLLTables.hpp"
+
+#include "grail/include/io/verbose.hpp"
+#include "grail/include/io/UTF8FileTokBuffer.hpp"
+
+namespace grail { namespace algorithm {
+
+    /// recognize a token stream with a generalised LL (GLL) parser, after
+    /// Scott and Johnstone. the grammar is interpreted rather than compiled
+    /// into code: a grammar slot is an item of the compiled grammar.
+    ///
+    /// the parser works through descriptors (slot, u, i), meaning that the
+    /// input from position i on should be parsed from the slot, and that
+    /// the variable of the slot was called from the graph-structured stack
+    /// (GSS) node u. a GSS node (L, j) stands for every call that returns
+    /// to the slot L with the call made at input position j, so callers
+    /// are shared and left recursion terminates. the set of descriptors
+    /// that have been made is kept so that each one is processed at most
+    /// once, which bounds the work on ambiguous grammars.
+    ///
+    /// alternates are only tried if the next token is in their select set;
+    /// on grammars that are close to LL(1) this leaves one descriptor per
+    /// token and variable, and parsing takes close to linear time.
+    template <typename AlphaT, const unsigned MAX_TOK_LENGTH>
+    class CFG_PARSE_GLL {
+    public:
+
+        // take off the templates!
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef cfg::GLLTables<AlphaT> tables_type;
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+            // number of descriptors processed
+            unsigned long num_descriptors;
+
+            // number of GSS nodes and edges
+            unsigned long num_gss_nodes;
+            unsigned long num_gss_edges;
+
+            // number of times that a GSS node was popped at some position
+            unsigned long num_pops;
+
+            stats_type(void)
+                : num_descriptors(0)
+                , num_gss_nodes(0)
+                , num_gss_edges(0)
+                , num_pops(0)
+            { }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_descriptors += that.num_descriptors;
+                num_gss_nodes += that.num_gss_nodes;
+                num_gss_edges += that.num_gss_edges;
+                num_pops += that.num_pops;
+            }
+        };
+
+    private:
+
+        enum {
+            END_OF_INPUT = tables_type::END_OF_INPUT,
+            UNKNOWN_TERMINAL = 0xFFFFFFFFU,
+            NO_ENTRY = 0xFFFFFFFFU,
+
+            // the GSS node that the start variable is called from
+            ROOT_NODE = 0U
+        };
+
+        /// open-addressed hash table from triples of unsigned values to
+        /// unsigned values. used for finding GSS nodes, and for the sets of
+        /// GSS edges, popped nodes, and descriptors.
+        class triple_map_type {
+        private:
+
+            class slot_type {
+            public:
+                unsigned a;
+                unsigned b;
+                unsigned c;
+                unsigned value;
+            };
+
+            std::vector<slot_type> slots;
+            unsigned size;
+
+        public:
+
+            triple_map_type(void) throw()
+                : slots()
+                , size(0)
+            {
+                slot_type empty_slot;
+                empty_slot.a = 0;
+                empty_slot.b = 0;
+                empty_slot.c = 0;
+                empty_slot.value = NO_ENTRY;
+                slots.assign(1024U, empty_slot);
+            }
+
+            /// find the value of a triple; if the triple is not in the map
+            /// then add it with the value value and return NO_ENTRY.
+            unsigned insert(
+                const unsigned a,
+                const unsigned b,
+                const unsigned c,
+                const unsigned value
+            ) throw() {
+                if((size + 1U) * 2U > slots.size()) {
+                    grow();
+                }
+
+                slot_type &slot(find(a, b, c));
+                if(NO_ENTRY != slot.value) {
+                    return slot.value;
+                }
+
+                slot.a = a;
+                slot.b = b;
+                slot.c = c;
+                slot.value = value;
+                ++size;
+
+                return NO_ENTRY;
+            }
+
+        private:
+
+            slot_type &find(
+                const unsigned a,
+                const unsigned b,
+                const unsigned c
+            ) throw() {
+                const unsigned mask(static_cast<unsigned>(slots.size()) - 1U);
+                unsigned i(
+                    ((a * 2654435761U) ^ (b * 40503U) ^ (c * 2246822519U)) & mask
+                );
+
+                for(; NO_ENTRY != slots[i].value; i = (i + 1U) & mask) {
+                    if(a == slots[i].a && b == slots[i].b && c == slots[i].c) {
+                        break;
+                    }
+                }
+
+                return slots[i];
+            }
+
+            void grow(void) throw() {
+                std::vector<slot_type> old_slots;
+                old_slots.swap(slots);
+
+                slot_type empty_slot;
+                empty_slot.a = 0;
+                empty_slot.b = 0;
+                empty_slot.c = 0;
+                empty_slot.value = NO_ENTRY;
+                slots.assign(old_slots.size() * 2U, empty_slot);
+
+                for(unsigned i(0); i < old_slots.size(); ++i) {
+                    if(NO_ENTRY != old_slots[i].value) {
+                        find(old_slots[i].a, old_slots[i].b, old_slots[i].c) =
+                            old_slots[i];
+                    }
+                }
+            }
+        };
+
+        /// a node (L, j) of the graph-structured stack. its edges go to the
+        /// nodes of its callers, and the positions at which it was popped
+        /// are kept so that callers that are added later can be resumed.
+        /// both are linked lists through the arrays of the GSS.
+        class gss_node_type {
+        public:
+            unsigned slot;
+            unsigned position;
+            unsigned first_edge;
+            unsigned first_pop;
+        };
+
+        /// a link of one of the linked lists of a GSS node
+        class gss_link_type {
+        public:
+            unsigned value;
+            unsigned next;
+        };
+
+        /// a unit of work: parse from position i on, starting at the slot
+        class descriptor_type {
+        public:
+            unsigned slot;
+            unsigned node;
+            unsigned position;
+        };
+
+        /// the state of one parse
+        class parser_type {
+        public:
+
+            const grammar_type &grammar;
+            const tables_type &tables;
+            const std::vector<unsigned> &input;
+            stats_type &stats;
+
+            std::vector<gss_node_type> nodes;
+            std::vector<gss_link_type> links;
+            std::vector<descriptor_type> work;
+
+            triple_map_type node_ids;
+            triple_map_type edges;
+            triple_map_type popped;
+            triple_map_type descriptors;
+
+            parser_type(
+                const grammar_type &grammar_,
+                const tables_type &tables_,
+                const std::vector<unsigned> &input_,
+                stats_type &stats_
+            ) throw()
+                : grammar(grammar_)
+                , tables(tables_)
+                , input(input_)
+                , stats(stats_)
+                , nodes()
+                , links()
+                , work()
+                , node_ids()
+                , edges()
+                , popped()
+                , descriptors()
+            { }
+
+            /// hand a descriptor back through next, or queue it if next is
+            /// already taken. continuing with a descriptor right away saves
+            /// a trip through the work list, which for deterministic
+            /// stretches of the input is most of the work.
+            void offer(
+                const unsigned slot,
+                const unsigned node,
+                const unsigned position,
+                descriptor_type &next
+            ) throw() {
+                descriptor_type desc;
+                desc.slot = slot;
+                desc.node = node;
+                desc.position = position;
+
+                if(NO_ENTRY == next.slot) {
+                    next = desc;
+                } else {
+                    work.push_back(desc);
+                }
+            }
+
+            /// offer a descriptor if it has not been added before
+            void add(
+                const unsigned slot,
+                const unsigned node,
+                const unsigned position,
+                descriptor_type &next
+            ) throw() {
+                if(NO_ENTRY == descriptors.insert(slot, node, position, 0U)) {
+                    offer(slot, node, position, next);
+                }
+            }
+
+            /// can production p derive a string that starts with the token
+            /// at some position?
+            bool selects(const unsigned p, const unsigned position) const throw() {
+                const unsigned a(input[position]);
+                if(UNKNOWN_TERMINAL == a) {
+                    return tables.selects_variable_terminal[p];
+                }
+                return tables.select.test(p, a);
+            }
+
+            /// make a GSS node for the call of the variable before the slot
+            /// at some position, or find the existing one
+            unsigned make_node(
+                const unsigned slot,
+                const unsigned position,
+                bool &is_new
+            ) throw() {
+                const unsigned id(static_cast<unsigned>(nodes.size()));
+                const unsigned found(node_ids.insert(slot, position, 0U, id));
+
+                is_new = NO_ENTRY == found;
+                if(!is_new) {
+                    return found;
+                }
+
+                gss_node_type node;
+                node.slot = slot;
+                node.position = position;
+                node.first_edge = NO_ENTRY;
+                node.first_pop = NO_ENTRY;
+                nodes.push_back(node);
+                ++(stats.num_gss_nodes);
+
+                return id;
+            }
+
+            /// prepend a value to a linked list of a GSS node
+            void link(unsigned &first, const unsigned value) throw() {
+                gss_link_type l;
+                l.value = value;
+                l.next = first;
+                first = static_cast<unsigned>(links.size());
+                links.push_back(l);
+            }
+
+            /// call the variable B from the slot before return_slot, where
+            /// the caller's node is caller
+            void call(
+                const unsigned B,
+                const unsigned return_slot,
+                const unsigned caller,
+                const unsigned position,
+                descriptor_type &next
+            ) throw() {
+                bool is_new(false);
+                const unsigned v(make_node(return_slot, position, is_new));
+
+                if(NO_ENTRY == edges.insert(v, caller, 0U, 0U)) {
+                    ++(stats.num_gss_edges);
+                    link(nodes[v].first_edge, caller);
+
+                    // the call already returned at these positions; resume
+                    // the new caller from each of them
+                    for(unsigned l(nodes[v].first_pop);
+                        NO_ENTRY != l;
+                        l = links[l].next) {
+                        add(return_slot, caller, links[l].value, next);
+                    }
+                }
+
+                if(!is_new) {
+                    return;
+                }
+
+                // the node is new, so none of these descriptors can have
+                // been added before; first items are never return slots
+                for(unsigned p(grammar.prediction_begin[B]);
+                    p < grammar.prediction_begin[B + 1U];
+                    ++p) {
+
+                    const unsigned first_item(grammar.predictions[p]);
+                    if(selects(grammar.item_production[first_item], position)) {
+                        offer(first_item, v, position, next);
+                    }
+                }
+            }
+
+            /// return from the call of node u at some position
+            void pop(
+                const unsigned u,
+                const unsigned position,
+                descriptor_type &next
+            ) throw() {
+                if(NO_ENTRY != popped.insert(u, position, 0U, 0U)) {
+                    return;
+                }
+
+                ++(stats.num_pops);
+                link(nodes[u].first_pop, position);
+
+                for(unsigned l(nodes[u].first_edge);
+                    NO_ENTRY != l;
+                    l = links[l].next) {
+                    add(nodes[u].slot, links[l].value, position, next);
+                }
+            }
+
+            /// run a descriptor until it calls a variable, returns, or fails
+            /// to match a token. returns true if the whole input has been
+            /// derived from the start variable.
+            bool run_one(
+                const descriptor_type &desc,
+                descriptor_type &next
+            ) throw() {
+                unsigned slot(desc.slot);
+                unsigned position(desc.position);
+
+                for(;;) {
+                    const symbol_id_type sym(grammar.item_symbol[slot]);
+
+                    // the item has the form A --> ... *
+                    if(grammar_type::END_OF_PRODUCTION == sym) {
+                        if(ROOT_NODE == desc.node) {
+                            return input.size() == position + 1U;
+                        }
+                        pop(desc.node, position, next);
+                        return false;
+
+                    // the item has the form A --> ... * B ...
+                    } else if(0 < sym) {
+                        call(
+                            static_cast<unsigned>(sym),
+                            slot + 1U,
+                            desc.node,
+                            position,
+                            next
+                        );
+                        return false;
+                    }
+
+                    // the item has the form A --> ... * a ...
+                    const unsigned a(input[position]);
+                    const unsigned term(static_cast<unsigned>(-sym));
+
+                    if(END_OF_INPUT == a) {
+                        return false;
+                    } else if(UNKNOWN_TERMINAL == a) {
+                        if(!grammar.is_variable_terminal[term]) {
+                            return false;
+                        }
+                    } else if(a != term) {
+                        return false;
+                    }
+
+                    ++slot;
+                    ++position;
+                }
+            }
+
+            /// run a descriptor, and then the descriptors that it hands
+            /// back, until one of them fails or hands nothing back
+            bool step(descriptor_type desc) throw() {
+                for(;;) {
+                    descriptor_type next;
+                    next.slot = NO_ENTRY;
+                    next.node = NO_ENTRY;
+                    next.position = 0U;
+
+                    ++(stats.num_descriptors);
+
+                    if(run_one(desc, next)) {
+                        return true;
+                    } else if(NO_ENTRY == next.slot) {
+                        return false;
+                    }
+
+                    desc = next;
+                }
+            }
+        };
+
+    public:
+
+        /// run the parser; assumes that the NULLABLE set used to compile
+        /// the grammar is properly filled. all tokens are read in before
+        /// parsing, as descriptors visit the input out of order.
+        static bool run(
+            const CFG &cfg,
+            const grammar_type &grammar,
+            const tables_type &tables,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats
+        ) throw() {
+
+            // the terminals of the tokens, ending with END_OF_INPUT
+            std::vector<unsigned> input;
+            alphabet_type lexeme;
+
+            for(const char *token(reader.read());
+                0 != token && '\0' != *token;
+                token = reader.read()) {
+
+                traits_type::unserialize(token, lexeme);
+                const unsigned a(grammar.find_terminal(lexeme));
+
+                if(0U != a) {
+                    input.push_back(a);
+                } else if(0 != cfg.num_variable_terminals()) {
+                    input.push_back(UNKNOWN_TERMINAL);
+                } else {
+                    io::verbose("    Unrecognized terminal '%s'.\n", token);
+                    io::verbose("Failed to parse all input.\n");
+                    return false;
+                }
+            }
+
+            input.push_back(END_OF_INPUT);
+
+            if(0 == grammar.num_items()) {
+                return 1U == input.size();
+            }
+
+            parser_type parser(grammar, tables, input, stats);
+
+            // the root of the GSS stands for the caller of START. its slot
+            // is START --> . S, which can't be the return slot of any call.
+            bool is_new(false);
+            parser.make_node(grammar.start_item, 0U, is_new);
+
+            descriptor_type start;
+            start.slot = NO_ENTRY;
+            parser.offer(grammar.start_item, ROOT_NODE, 0U, start);
+            parser.work.push_back(start);
+
+            for(; !parser.work.empty(); ) {
+                const descriptor_type desc(parser.work.back());
+                parser.work.pop_back();
+
+                if(parser.step(desc)) {
+                    io::verbose("Successfully parsed.\n");
+                    return true;
+                }
+            }
+
+            io::verbose("Failed to parse all input.\n");
+            return false;
+        }
+    };
+}}
+
+#endif /* FLTL_CFG_PARSE_GLL_HPP_ */
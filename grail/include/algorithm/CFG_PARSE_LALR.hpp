@@ -0,0 +1,175 @@
+/*
+ * CFG_PARSE_LALR.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef FLTL_CFG_PARSE_LALR_HPP_
+#define FLTL_CFG_PARSE_LALR_HPP_
+
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LALRTable.hpp"
+
+#include "grail/include/io/verbose.hpp"
+#include "grail/include/io/UTF8FileTokBuffer.hpp"
+
+namespace grail { namespace algorithm {
+
+    /// recognize a token stream with a table-driven LALR(1) parser. a token
+    /// that is not a terminal of the grammar matches any variable terminal;
+    /// it is rejected if the grammar has none, or if variable terminals
+    /// have different actions where it is read.
+    template <typename AlphaT, const unsigned MAX_TOK_LENGTH>
+    class CFG_PARSE_LALR {
+    public:
+
+        // take off the templates!
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef cfg::LALRTable<AlphaT> table_type;
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+            // number of tokens shifted
+            unsigned long num_shifts;
+
+            // number of reductions
+            unsigned long num_reductions;
+
+            // the largest number of states on the stack
+            unsigned long max_stack_size;
+
+            stats_type(void)
+                : num_shifts(0)
+                , num_reductions(0)
+                , max_stack_size(0)
+            { }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_shifts += that.num_shifts;
+                num_reductions += that.num_reductions;
+                if(max_stack_size < that.max_stack_size) {
+                    max_stack_size = that.max_stack_size;
+                }
+            }
+        };
+
+    private:
+
+        enum {
+            NO_TERMINAL = 0xFFFFFFFFU
+        };
+
+        /// get the terminal of the next token, END_OF_INPUT at the end of
+        /// the input, UNKNOWN_TERMINAL if the token is not a terminal of the
+        /// grammar but could match a variable terminal, or NO_TERMINAL if it
+        /// can't be matched at all.
+        static unsigned next_terminal(
+            const grammar_type &grammar,
+            const table_type &table,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            alphabet_type &lexeme
+        ) throw() {
+            const char *token(reader.read());
+            if(0 == token || '\0' == *token) {
+                return table_type::END_OF_INPUT;
+            }
+
+            traits_type::unserialize(token, lexeme);
+            const unsigned a(grammar.find_terminal(lexeme));
+
+            if(0U == a) {
+                if(table.has_variable_terminals()) {
+                    return table_type::UNKNOWN_TERMINAL;
+                }
+                io::verbose("    Unrecognized terminal '%s'.\n", token);
+                return NO_TERMINAL;
+            }
+
+            return a;
+        }
+
+    public:
+
+        /// run the parser
+        static bool run(
+            const grammar_type &grammar,
+            const table_type &table,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats
+        ) throw() {
+
+            if(0 == grammar.num_items()) {
+                const char *token(reader.read());
+                return 0 == token || '\0' == *token;
+            }
+
+            // the stack of states; its top is at the back
+            std::vector<unsigned> stack;
+            stack.reserve(256U);
+            stack.push_back(0U);
+
+            alphabet_type lexeme;
+            unsigned a(next_terminal(grammar, table, reader, lexeme));
+
+            for(; NO_TERMINAL != a; ) {
+                const unsigned action(table.action(stack.back(), a));
+
+                if(stats.max_stack_size < stack.size()) {
+                    stats.max_stack_size = stack.size();
+                }
+
+                switch(table_type::action_kind(action)) {
+                case table_type::ACTION_SHIFT:
+                    ++(stats.num_shifts);
+                    stack.push_back(table_type::action_target(action));
+                    a = next_terminal(grammar, table, reader, lexeme);
+                    break;
+
+                case table_type::ACTION_REDUCE: {
+                    const unsigned p(table_type::action_target(action));
+                    const unsigned A(grammar.item_variable[
+                        grammar.production_item[p]
+                    ]);
+
+                    ++(stats.num_reductions);
+                    stack.resize(stack.size() - grammar.production_length(p));
+                    stack.push_back(table.next_state(stack.back(), A));
+                    break;
+                }
+
+                case table_type::ACTION_ACCEPT:
+                    io::verbose("Successfully parsed.\n");
+                    return true;
+
+                default:
+                    if(table_type::ACTION_AMBIGUOUS == action) {
+                        io::verbose(
+                            "    Unrecognized terminal has different actions "
+                            "through different variable terminals.\n"
+                        );
+                    }
+                    io::verbose("Failed to parse all input.\n");
+                    return false;
+                }
+            }
+
+            io::verbose("Failed to parse all input.\n");
+            return false;
+        }
+    };
+}}
+
+#endif /* FLTL_CFG_PARSE_LALR_HPP_ */
@@ -0,0 +1,202 @@
+/*
+ * CFG_PARSE_LL1.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef FLTL_CFG_PARSE_LL1_HPP_
+#define FLTL_CFG_PARSE_LL1_HPP_
+
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LL1Table.hpp"
+
+#include "grail/include/io/verbose.hpp"
+#include "grail/include/io/UTF8FileTokBuffer.hpp"
+
+namespace grail { namespace algorithm {
+
+    /// recognize a token stream with a table-driven LL(1) parser. this is
+    /// meant for grammars whose LL(1) table has no conflicts; if the table
+    /// has conflicts then only the production that was added to a cell
+    /// first is ever tried. a token that is not a terminal of the grammar
+    /// matches any variable terminal; it is rejected if the grammar has
+    /// none, or if variable terminals select different productions where
+    /// it is read.
+    template <typename AlphaT, const unsigned MAX_TOK_LENGTH>
+    class CFG_PARSE_LL1 {
+    public:
+
+        // take off the templates!
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef cfg::LL1Table<AlphaT> table_type;
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+            // number of tokens matched against the stack
+            unsigned long num_scans;
+
+            // number of variables expanded using the table
+            unsigned long num_expansions;
+
+            // the largest number of symbols on the stack
+            unsigned long max_stack_size;
+
+            stats_type(void)
+                : num_scans(0)
+                , num_expansions(0)
+                , max_stack_size(0)
+            { }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_scans += that.num_scans;
+                num_expansions += that.num_expansions;
+                if(max_stack_size < that.max_stack_size) {
+                    max_stack_size = that.max_stack_size;
+                }
+            }
+        };
+
+    private:
+
+        /// get the terminal of the next token, END_OF_INPUT at the end of
+        /// the input, UNKNOWN_TERMINAL if the token is not a terminal of the
+        /// grammar but could match a variable terminal, or ~0U if it can't
+        /// be matched at all.
+        static unsigned next_terminal(
+            const grammar_type &grammar,
+            const table_type &table,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            alphabet_type &lexeme
+        ) throw() {
+            const char *token(reader.read());
+            if(0 == token || '\0' == *token) {
+                return table_type::END_OF_INPUT;
+            }
+
+            traits_type::unserialize(token, lexeme);
+            const unsigned a(grammar.find_terminal(lexeme));
+
+            if(0U == a) {
+                if(table.has_variable_terminals()) {
+                    return table_type::UNKNOWN_TERMINAL;
+                }
+                io::verbose("    Unrecognized terminal '%s'.\n", token);
+                return ~0U;
+            }
+
+            return a;
+        }
+
+    public:
+
+        /// run the parser
+        static bool run(
+            const grammar_type &grammar,
+            const table_type &table,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats
+        ) throw() {
+
+            if(0 == grammar.num_items()) {
+                const char *token(reader.read());
+                return 0 == token || '\0' == *token;
+            }
+
+            const symbol_id_type * const item_symbol(&(grammar.item_symbol[0]));
+            const unsigned * const production_item(&(grammar.production_item[0]));
+
+            // the stack of symbols that remain to be matched; its top is
+            // at the back
+            std::vector<symbol_id_type> stack;
+            stack.reserve(256U);
+            stack.push_back(item_symbol[grammar.start_item]);
+
+            alphabet_type lexeme;
+            unsigned a(next_terminal(grammar, table, reader, lexeme));
+            if(~0U == a) {
+                return false;
+            }
+
+            for(; !stack.empty(); ) {
+
+                const symbol_id_type sym(stack.back());
+                stack.pop_back();
+
+                // match a terminal against the input
+                if(0 > sym) {
+                    const unsigned t(static_cast<unsigned>(-sym));
+                    if(t != a && (table_type::UNKNOWN_TERMINAL != a
+                               || !grammar.is_variable_terminal[t])) {
+                        io::verbose("Failed to parse all input.\n");
+                        return false;
+                    }
+
+                    ++(stats.num_scans);
+                    a = next_terminal(grammar, table, reader, lexeme);
+                    if(~0U == a) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                // expand a variable
+                const unsigned p(table.production(
+                    static_cast<unsigned>(sym),
+                    a
+                ));
+
+                if(table_type::NO_PRODUCTION == p) {
+                    io::verbose("Failed to parse all input.\n");
+                    return false;
+
+                } else if(table_type::AMBIGUOUS_PRODUCTION == p
+                       && table_type::UNKNOWN_TERMINAL == a) {
+                    io::verbose(
+                        "    Unrecognized terminal selects different "
+                        "productions through different variable terminals.\n"
+                        "Failed to parse all input.\n"
+                    );
+                    return false;
+                }
+
+                ++(stats.num_expansions);
+
+                // push the symbols of the production in reverse so that the
+                // first one ends up on top
+                for(unsigned item(production_item[p + 1U] - 1U);
+                    item-- > production_item[p]; ) {
+                    stack.push_back(item_symbol[item]);
+                }
+
+                if(stats.max_stack_size < stack.size()) {
+                    stats.max_stack_size = stack.size();
+                }
+            }
+
+            if(table_type::END_OF_INPUT != a) {
+                io::verbose("Failed to parse all input.\n");
+                return false;
+            }
+
+            io::verbose("Successfully parsed.\n");
+            return true;
+        }
+    };
+}}
+
+#endif /* FLTL_CFG_PARSE_LL1_HPP_ */
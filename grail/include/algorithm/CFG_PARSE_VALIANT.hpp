@@ -0,0 +1,513 @@
+/*
+ * CFG_PARSE_VALIANT.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_CFG_PARSE_VALIANT_HPP_
+#define Grail_Plus_CFG_PARSE_VALIANT_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/CYKTables.hpp"
+
+#include "grail/include/helper/Thread.hpp"
+
+#include "grail/include/io/verbose.hpp"
+#include "grail/include/io/UTF8FileTokBuffer.hpp"
+
+namespace grail { namespace algorithm {
+
+    /// recognize a token stream with Valiant's reduction of CYK parsing to
+    /// matrix multiplication, as reformulated by Okhotin. the grammar must
+    /// be in Chomsky Normal Form (see CFG_TO_CNF). the chart is a matrix
+    /// over the positions between tokens whose entries are sets of
+    /// variables, and the product of two such matrices combines entries
+    /// using the binary productions of the grammar.
+    ///
+    /// the matrix is split into square tiles of TILE_SIZE positions. the
+    /// entries of tile (I, J) are the union of the products of tiles
+    /// (I, K) and (K, J) for every K strictly between I and J, plus the
+    /// closure of the tile against the diagonal tiles (I, I) and (J, J).
+    /// all tiles on the same diagonal of tiles are independent, so the
+    /// chart is filled one band of tiles at a time by several threads. the
+    /// products are also split by rows, so that threads still have work
+    /// to share once bands get short.
+    ///
+    /// Valiant's recursion is taken down to the tiles and not further: the
+    /// products are not done with a sub-cubic matrix multiplication, but
+    /// with a kernel that decodes each left entry once per tile and tests
+    /// whole rows of the rule tables against each right entry.
+    template <typename AlphaT, const unsigned MAX_TOK_LENGTH>
+    class CFG_PARSE_VALIANT {
+    public:
+
+        // take off the templates!
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef cfg::CYKTables<AlphaT> tables_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+        typedef bit_matrix_type::word_type word_type;
+
+        enum {
+            TILE_SIZE = 64U,
+            ROWS_PER_TASK = 16U,
+            TASKS_PER_TILE = TILE_SIZE / ROWS_PER_TASK
+        };
+
+        /// counters collected while parsing
+        class stats_type {
+        public:
+            // number of tiles of the chart that were filled
+            unsigned long num_tiles;
+
+            // number of products of a block of rows of one tile with another
+            // tile
+            unsigned long num_products;
+
+            // number of (B, C) pairs looked at while combining entries
+            unsigned long num_pairs;
+
+            // number of threads used to fill the chart
+            unsigned num_threads;
+
+            stats_type(void)
+                : num_tiles(0)
+                , num_products(0)
+                , num_pairs(0)
+                , num_threads(0)
+            { }
+
+            /// add in the counters collected while parsing another input
+            void merge(const stats_type &that) throw() {
+                num_tiles += that.num_tiles;
+                num_products += that.num_products;
+                num_pairs += that.num_pairs;
+                if(num_threads < that.num_threads) {
+                    num_threads = that.num_threads;
+                }
+            }
+        };
+
+    private:
+
+        /// the upper triangle of the chart, tile by tile. entry (i, j) is
+        /// the set of variables that derive tokens i through j - 1; it is
+        /// stored in tile (i / TILE_SIZE, j / TILE_SIZE), whose entries are
+        /// laid out row by row.
+        class chart_type {
+        public:
+            const tables_type &tables;
+            const unsigned num_positions;
+            const unsigned num_tiles;
+            const unsigned entry_words;
+            std::vector<word_type> words;
+
+            chart_type(const tables_type &tables_, const unsigned n) throw()
+                : tables(tables_)
+                , num_positions(n + 1U)
+                , num_tiles((n + TILE_SIZE) / TILE_SIZE)
+                , entry_words(tables_.num_words)
+                , words()
+            {
+                words.assign(
+                    static_cast<std::vector<word_type>::size_type>(
+                        num_tiles * (num_tiles + 1U) / 2U
+                    ) * TILE_SIZE * TILE_SIZE * entry_words,
+                    0UL
+                );
+            }
+
+            /// the position just after the last position of a tile
+            inline unsigned tile_end(const unsigned I) const throw() {
+                const unsigned end((I + 1U) * TILE_SIZE);
+                return end < num_positions ? end : num_positions;
+            }
+
+            inline word_type *entry(const unsigned i, const unsigned j) throw() {
+                const unsigned I(i / TILE_SIZE);
+                const unsigned J(j / TILE_SIZE);
+                const unsigned tile(I * num_tiles - (I * (I - 1U)) / 2U + J - I);
+
+                return &(words[
+                    ((static_cast<std::vector<word_type>::size_type>(tile)
+                      * TILE_SIZE + (i % TILE_SIZE)) * TILE_SIZE
+                      + (j % TILE_SIZE)) * entry_words
+                ]);
+            }
+        };
+
+        /// the state shared by all threads that fill in the chart. the
+        /// tasks of each phase are handed out one at a time.
+        class shared_state_type {
+        public:
+            chart_type &chart;
+            helper::Barrier &barrier;
+            helper::Mutex mutex;
+            std::vector<unsigned> next_task;
+
+            shared_state_type(
+                chart_type &chart_,
+                helper::Barrier &barrier_
+            ) throw()
+                : chart(chart_)
+                , barrier(barrier_)
+                , mutex()
+                , next_task(2U * chart_.num_tiles, 0U)
+            { }
+
+            /// claim the next task of a phase, or return false if all of its
+            /// num_tasks tasks have been claimed
+            bool claim(
+                const unsigned phase,
+                const unsigned num_tasks,
+                unsigned &task
+            ) throw() {
+                mutex.lock();
+                task = next_task[phase]++;
+                mutex.unlock();
+                return task < num_tasks;
+            }
+        };
+
+        /// the state of one thread that fills in part of each band
+        class worker_type {
+        public:
+            shared_state_type *shared;
+            bool is_parallel;
+            std::vector<unsigned> left;
+            unsigned long num_tiles;
+            unsigned long num_products;
+            unsigned long num_pairs;
+        };
+
+        /// list the variables B of an entry such that A --> B C for some A
+        /// and C. returns the number of variables listed.
+        static unsigned decode(
+            const tables_type &tables,
+            const word_type *entry,
+            unsigned *vars
+        ) throw() {
+            const word_type *lefts(&(tables.left_variables[0]));
+            unsigned num_vars(0);
+
+            for(unsigned w(0); w < tables.num_words; ++w) {
+                for(word_type bits(entry[w] & lefts[w]);
+                    0UL != bits;
+                    bits &= bits - 1UL) {
+                    vars[num_vars++] = w * bit_matrix_type::BITS_PER_WORD
+                                     + bit_matrix_type::lowest_bit(bits);
+                }
+            }
+
+            return num_vars;
+        }
+
+        /// or into out the variables A such that A --> B C, where B is one
+        /// of the decoded left variables and C is in right. the whole row
+        /// of possible C's of each B is tested against right first, so that
+        /// most B's are ruled out with a few word operations.
+        static void combine(
+            const tables_type &tables,
+            const unsigned *left,
+            const unsigned num_left,
+            const word_type *right,
+            word_type *out,
+            unsigned long &num_pairs
+        ) throw() {
+            const unsigned num_words(tables.num_words);
+
+            for(unsigned l(0); l < num_left; ++l) {
+                const unsigned B(left[l]);
+                const word_type *rights(tables.right_variables.row(B));
+
+                word_type any(0UL);
+                for(unsigned w(0); w < num_words; ++w) {
+                    any |= rights[w] & right[w];
+                }
+
+                if(0UL == any) {
+                    continue;
+                }
+
+                for(unsigned k(tables.binary_begin[B]),
+                             max_k(tables.binary_begin[B + 1U]);
+                    k < max_k;
+                    ++k) {
+
+                    ++num_pairs;
+                    if(bit_matrix_type::test(right, tables.binary_right[k])) {
+                        bit_matrix_type::or_into(
+                            out,
+                            tables.binary_heads.row(k),
+                            num_words
+                        );
+                    }
+                }
+            }
+        }
+
+        /// or into the entries (i, j) for i in [i_begin, i_end) and j in
+        /// [j_begin, j_end) the product of the entries (i, t) and (t, j) for
+        /// t in [t_begin, t_end). all of those entries must be final.
+        static void multiply(
+            worker_type &worker,
+            chart_type &chart,
+            const unsigned i_begin, const unsigned i_end,
+            const unsigned t_begin, const unsigned t_end,
+            const unsigned j_begin, const unsigned j_end
+        ) throw() {
+            unsigned *left(&(worker.left[0]));
+
+            for(unsigned i(i_begin); i < i_end; ++i) {
+                for(unsigned t(t_begin); t < t_end; ++t) {
+                    const unsigned num_left(
+                        decode(chart.tables, chart.entry(i, t), left)
+                    );
+
+                    if(0U == num_left) {
+                        continue;
+                    }
+
+                    for(unsigned j(j_begin); j < j_end; ++j) {
+                        combine(
+                            chart.tables,
+                            left,
+                            num_left,
+                            chart.entry(t, j),
+                            chart.entry(i, j),
+                            worker.num_pairs
+                        );
+                    }
+                }
+            }
+        }
+
+        /// finish tile (I, J) once the products of the tiles between I and
+        /// J are in it: combine its entries with those of the diagonal tiles
+        /// (I, I) and (J, J). rows are done from the bottom up and entries
+        /// from left to right, so that each entry is final by the time it
+        /// is combined with others. a diagonal tile is the CYK chart of its
+        /// own tokens.
+        static void close(
+            worker_type &worker,
+            chart_type &chart,
+            const unsigned I,
+            const unsigned J
+        ) throw() {
+            unsigned *left(&(worker.left[0]));
+            const unsigned i_begin(I * TILE_SIZE);
+            const unsigned i_end(chart.tile_end(I));
+            const unsigned j_begin(J * TILE_SIZE);
+            const unsigned j_end(chart.tile_end(J));
+
+            for(unsigned i(i_end); i-- > i_begin; ) {
+
+                // (i, t) in tile (I, I) with (t, j) in the rows below
+                if(I != J) {
+                    multiply(worker, chart, i, i + 1U, i + 1U, i_end, j_begin, j_end);
+                }
+
+                // (i, t) in this row with (t, j) in tile (J, J)
+                for(unsigned t(I == J ? i + 1U : j_begin); t < j_end; ++t) {
+                    const unsigned num_left(
+                        decode(chart.tables, chart.entry(i, t), left)
+                    );
+
+                    for(unsigned j(t + 1U); 0U != num_left && j < j_end; ++j) {
+                        combine(
+                            chart.tables,
+                            left,
+                            num_left,
+                            chart.entry(t, j),
+                            chart.entry(i, j),
+                            worker.num_pairs
+                        );
+                    }
+                }
+            }
+
+            ++(worker.num_tiles);
+        }
+
+        /// fill in the chart one band of tiles at a time. in each band, the
+        /// products of all tiles are done first, a block of rows at a time,
+        /// and then the tiles are closed. all workers finish a phase before
+        /// any of them moves on to the next one.
+        static void fill(void *worker_) throw() {
+            worker_type &worker(*reinterpret_cast<worker_type *>(worker_));
+            shared_state_type &shared(*(worker.shared));
+            chart_type &chart(shared.chart);
+            const unsigned num_tiles(chart.num_tiles);
+            unsigned task(0);
+
+            for(unsigned d(0); d < num_tiles; ++d) {
+                const unsigned num_band_tiles(num_tiles - d);
+
+                for(; 0U < d && shared.claim(
+                    2U * d,
+                    num_band_tiles * TASKS_PER_TILE,
+                    task
+                ); ) {
+                    const unsigned I(task / TASKS_PER_TILE);
+                    const unsigned J(I + d);
+                    const unsigned i_begin(
+                        I * TILE_SIZE + (task % TASKS_PER_TILE) * ROWS_PER_TASK
+                    );
+                    const unsigned i_end(std::min(
+                        i_begin + ROWS_PER_TASK,
+                        chart.tile_end(I)
+                    ));
+
+                    for(unsigned K(I + 1U); K < J; ++K) {
+                        multiply(
+                            worker, chart,
+                            i_begin, i_end,
+                            K * TILE_SIZE, chart.tile_end(K),
+                            J * TILE_SIZE, chart.tile_end(J)
+                        );
+                        ++(worker.num_products);
+                    }
+                }
+
+                if(0U < d && worker.is_parallel) {
+                    shared.barrier.wait();
+                }
+
+                for(; shared.claim(2U * d + 1U, num_band_tiles, task); ) {
+                    close(worker, chart, task, task + d);
+                }
+
+                if(worker.is_parallel) {
+                    shared.barrier.wait();
+                }
+            }
+        }
+
+    public:
+
+        /// run the recognizer using at most num_threads threads to fill in
+        /// the chart.
+        static bool run(
+            const grammar_type &grammar,
+            const tables_type &tables,
+            const unsigned num_threads,
+            io::UTF8FileTokBuffer<MAX_TOK_LENGTH> &reader,
+            stats_type &stats
+        ) throw() {
+
+            // the variables that can derive each token
+            std::vector<const word_type *> token_heads;
+            alphabet_type lexeme;
+
+            for(const char *token(reader.read());
+                0 != token && '\0' != *token;
+                token = reader.read()) {
+
+                traits_type::unserialize(token, lexeme);
+                const unsigned a(grammar.find_terminal(lexeme));
+
+                if(0U != a) {
+                    token_heads.push_back(tables.terminal_heads.row(a));
+                } else if(tables.has_variable_terminals) {
+                    token_heads.push_back(&(tables.variable_terminal_heads[0]));
+                } else {
+                    io::verbose("    Unrecognized terminal '%s'.\n", token);
+                    io::verbose("Failed to parse all input.\n");
+                    return false;
+                }
+            }
+
+            const unsigned n(static_cast<unsigned>(token_heads.size()));
+
+            if(0U == n) {
+                io::verbose(tables.accepts_empty
+                    ? "Parsed. Accepted empty string.\n"
+                    : "Failed to parse. Empty string not accepted.\n"
+                );
+                return tables.accepts_empty;
+            }
+
+            chart_type chart(tables, n);
+
+            io::verbose(
+                "Filling %u bands of chart tiles for %u tokens...\n",
+                chart.num_tiles,
+                n
+            );
+
+            for(unsigned i(0); i < n; ++i) {
+                bit_matrix_type::or_into(
+                    chart.entry(i, i + 1U),
+                    token_heads[i],
+                    tables.num_words
+                );
+            }
+
+            // the widest band has one tile per band position, and each of
+            // its tiles can be split by rows
+            unsigned num_workers(0U == num_threads ? 1U : num_threads);
+            if(num_workers > chart.num_tiles * TASKS_PER_TILE) {
+                num_workers = chart.num_tiles * TASKS_PER_TILE;
+            }
+
+            helper::Barrier barrier(num_workers);
+            shared_state_type shared(chart, barrier);
+            std::vector<worker_type> workers(num_workers);
+            helper::Thread *threads(new helper::Thread[num_workers]);
+
+            for(unsigned w(0); w < num_workers; ++w) {
+                workers[w].shared = &shared;
+                workers[w].is_parallel = 1U < num_workers;
+                workers[w].left.assign(tables.num_variables + 1U, 0U);
+                workers[w].num_tiles = 0;
+                workers[w].num_products = 0;
+                workers[w].num_pairs = 0;
+            }
+
+            // the current thread acts as the first worker. if a thread
+            // can't be started then the others pick up its share.
+            stats.num_threads = num_workers;
+            for(unsigned w(1); w < num_workers; ++w) {
+                if(!threads[w].start(&fill, &(workers[w]))) {
+                    io::verbose("Unable to start chart worker thread.\n");
+                    barrier.leave();
+                    --(stats.num_threads);
+                }
+            }
+
+            fill(&(workers[0]));
+
+            for(unsigned w(0); w < num_workers; ++w) {
+                threads[w].join();
+                stats.num_tiles += workers[w].num_tiles;
+                stats.num_products += workers[w].num_products;
+                stats.num_pairs += workers[w].num_pairs;
+            }
+
+            delete [] threads;
+
+            if(bit_matrix_type::test(chart.entry(0, n), tables.start_variable)) {
+                io::verbose("Successfully parsed.\n");
+                return true;
+            }
+
+            io::verbose("Failed to parse all input.\n");
+            return false;
+        }
+    };
+}}
+
+#endif /* Grail_Plus_CFG_PARSE_VALIANT_HPP_ */
@@ -31,6 +31,8 @@
 
 #include <vector>
 
+#include "fltl/include/helper/BitSet.hpp"
+
 namespace grail { namespace algorithm {
 
     /// remove all non-generating variables and all unreachable variables
@@ -46,14 +48,12 @@ namespace grail { namespace algorithm {
         static void reach_variable(
             const CFG &cfg,
             const variable_type var,
-            std::vector<bool> &reachable
+            fltl::helper::BitSet &reachable
         ) throw() {
-            if(reachable[var.number()]) {
+            if(reachable.test_and_set(var.number())) {
                 return;
             }
 
-            reachable[var.number()] = true;
-
             symbol_string_type str;
             generator_type reached_productions(cfg.search(var --->* ~str));
 
@@ -85,14 +85,14 @@ namespace grail { namespace algorithm {
             }
 
             // find all reachable variables
-            std::vector<bool> reachable(cfg.num_variables_capacity() + 2, false);
+            fltl::helper::BitSet reachable(cfg.num_variables_capacity() + 2);
             reach_variable(cfg, cfg.get_start_variable(), reachable);
 
             // get rid of unreachable variables
             for(variables.rewind();
                 variables.match_next(); ) {
 
-                if(!(reachable[V.number()])) {
+                if(!reachable.test(V.number())) {
                     cfg.remove_variable(V);
                 }
             }
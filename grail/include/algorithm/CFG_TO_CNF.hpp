@@ -59,8 +59,7 @@ namespace grail { namespace algorithm {
         // are terminals, then replace them with variables
         inline static void clean_up_terminals(
             CFG &cfg,
-            std::map<terminal_type, variable_type> &terminal_rules,
-            std::map<variable_type, variable_type> &vars_to_replace
+            std::map<terminal_type, variable_type> &terminal_rules
         ) throw() {
 
             production_type P;
@@ -107,18 +106,12 @@ namespace grail { namespace algorithm {
                 } else if(first_is_term) {
                     cfg.remove_production(P);
                     B = str.at(1);
-                    if(vars_to_replace.count(B)) {
-                        B = vars_to_replace[B];
-                    }
                     cfg.add_production(P.variable(), A + B);
 
                 // second symbol is a terminal
                 } else if(second_is_term) {
                     cfg.remove_production(P);
                     A = str.at(0);
-                    if(vars_to_replace.count(A)) {
-                        A = vars_to_replace[A];
-                    }
                     cfg.add_production(P.variable(), A + B);
                 }
             }
@@ -155,30 +148,36 @@ namespace grail { namespace algorithm {
 
             io::verbose("Moving terminals to their own variables...\n");
 
-            // keep track of those productions that only generate a terminal
+            // find the variables whose only production generates a single
+            // terminal; they can stand in for their terminal in pairs. the
+            // start variable can't, as it must not appear in any pair. no
+            // variables are removed, because the other productions that use
+            // them would be left with dangling symbols.
             std::map<terminal_type, variable_type> terminal_rules;
-            std::map<variable_type, variable_type> vars_to_replace;
 
-            terminal_type T;
             production_type P;
-            variable_type A;
+            symbol_string_type str;
+            generator_type productions(cfg.search(~P));
 
-            generator_type terminal_units(cfg.search(~P, (~A) --->* T));
+            for(; productions.match_next(); ) {
+                str = P.symbols();
+                if(1 != str.length() || !str.at(0).is_terminal()) {
+                    continue;
+                }
 
-            for(; terminal_units.match_next(); ) {
-                if(1 == cfg.num_productions(A)) {
-                    if(1 == terminal_rules.count(T)) {
-                        vars_to_replace[A] = terminal_rules[T];
-                        cfg.unsafe_remove_variable(A);
-                    } else {
-                        terminal_rules[T] = A;
-                    }
+                const variable_type A(P.variable());
+                const terminal_type T(str.at(0));
+
+                if(A != cfg.get_start_variable()
+                && 1 == cfg.num_productions(A)
+                && 0 == terminal_rules.count(T)) {
+                    terminal_rules[T] = A;
                 }
             }
 
             io::verbose("Updating non-unit productions with terminals...\n");
 
-            clean_up_terminals(cfg, terminal_rules, vars_to_replace);
+            clean_up_terminals(cfg, terminal_rules);
 
             io::verbose("Done.\n");
         }
@@ -0,0 +1,377 @@
+/*
+ * AnalysisCache.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_ANALYSIS_CACHE_HPP_
+#define Grail_Plus_ANALYSIS_CACHE_HPP_
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "fltl/include/CFG.hpp"
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "fltl/include/trait/Uncopyable.hpp"
+
+#include "grail/include/cfg/compute_first_set.hpp"
+#include "grail/include/cfg/compute_follow_set.hpp"
+#include "grail/include/cfg/compute_null_set.hpp"
+
+#include "grail/include/io/verbose.hpp"
+
+namespace grail { namespace cfg {
+
+    /// a directory of the NULL, FIRST, and FOLLOW sets of grammars, so that
+    /// tools that are run over and over on the same grammar don't need to
+    /// recompute them.
+    ///
+    /// the sets of a grammar are kept in the file <hash>.sets, where the
+    /// hash is taken over the numbered form of the grammar: its start
+    /// variable and productions, with every symbol replaced by its number.
+    /// formatting, comments, and names don't change the hash, but anything
+    /// that changes the sets or the numbering of their rows and columns
+    /// does. the file begins with a header that repeats the hash and the
+    /// sizes of the sets, followed by the words of the nullable bit set and
+    /// of the FIRST and FOLLOW bit matrices. a file whose header doesn't
+    /// match the grammar is stale and is replaced.
+    class AnalysisCache : private fltl::trait::Uncopyable {
+    public:
+
+        typedef fltl::helper::BitMatrix::word_type word_type;
+
+    private:
+
+        enum {
+            VERSION = 1U
+        };
+
+        /// the header of a cache file. it is a multiple of eight bytes
+        /// long so that the words after it are aligned in a mapped file.
+        struct header_type {
+            char magic[8];
+            uint32_t version;
+            uint32_t word_size;
+            uint64_t hash;
+            uint32_t num_rows;
+            uint32_t num_first_cols;
+            uint32_t num_follow_cols;
+            uint32_t reserved;
+        };
+
+        const char *dir;
+
+        static void hash_word(uint64_t &h, uint32_t word) throw() {
+            for(unsigned i(0); i < 4U; ++i, word >>= 8U) {
+                h ^= word & 0xFFU;
+                h *= 1099511628211ULL;
+            }
+        }
+
+        /// the FNV-1a hash of the numbered form of a grammar
+        template <typename AlphaT>
+        static uint64_t hash(const fltl::CFG<AlphaT> &cfg) throw() {
+            FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
+
+            uint64_t h(14695981039346656037ULL);
+
+            hash_word(h, VERSION);
+            hash_word(h, cfg.num_variables_capacity());
+            hash_word(h, cfg.num_terminals());
+            hash_word(h, cfg.has_start_variable()
+                ? cfg.get_start_variable().number()
+                : 0U
+            );
+
+            production_type prod;
+            symbol_string_type s;
+            generator_type productions(cfg.search(~prod));
+
+            for(; productions.match_next(); ) {
+                s = prod.symbols();
+
+                hash_word(h, prod.variable().number());
+                hash_word(h, s.length());
+
+                // tag terminals and variables so that they can't collide
+                for(unsigned i(0); i < s.length(); ++i) {
+                    if(s.at(i).is_terminal()) {
+                        hash_word(h, 2U * terminal_type(s.at(i)).number());
+                    } else {
+                        hash_word(h, 2U * variable_type(s.at(i)).number() + 1U);
+                    }
+                }
+            }
+
+            return h;
+        }
+
+        /// fill in the header that the cache file of a grammar must have
+        template <typename AlphaT>
+        static void make_header(
+            const fltl::CFG<AlphaT> &cfg,
+            header_type &header
+        ) throw() {
+            memset(&header, 0, sizeof header);
+            memcpy(header.magic, "GRAILSET", sizeof header.magic);
+            header.version = VERSION;
+            header.word_size = sizeof(word_type);
+            header.hash = hash(cfg);
+            header.num_rows = cfg.num_variables_capacity() + 2U;
+            header.num_first_cols = cfg.num_terminals() + 2U;
+            header.num_follow_cols = cfg.num_terminals() + 2U;
+        }
+
+        /// the number of bytes of a cache file with some header
+        static size_t file_size(const header_type &header) throw() {
+            using fltl::helper::BitMatrix;
+
+            const size_t num_words(
+                BitMatrix::num_words(header.num_rows)
+                + static_cast<size_t>(header.num_rows) * (
+                    BitMatrix::num_words(header.num_first_cols)
+                    + BitMatrix::num_words(header.num_follow_cols)
+                )
+            );
+
+            return sizeof header + num_words * sizeof(word_type);
+        }
+
+        /// the path of the cache file of a grammar
+        std::string path(const header_type &header) const throw() {
+            char name[32];
+            sprintf(
+                name,
+                "/%08lx%08lx.sets",
+                static_cast<unsigned long>(header.hash >> 32U),
+                static_cast<unsigned long>(header.hash & 0xFFFFFFFFU)
+            );
+            return std::string(dir) + name;
+        }
+
+        /// copy the rows of a matrix out of or into a run of words
+        static const word_type *read_matrix(
+            const word_type *words,
+            fltl::helper::BitMatrix &matrix,
+            const unsigned num_rows,
+            const unsigned num_cols
+        ) throw() {
+            matrix.resize(num_rows, num_cols);
+            const unsigned num_words(matrix.num_words_per_row());
+            for(unsigned r(0); r < num_rows; ++r, words += num_words) {
+                memcpy(matrix.row(r), words, num_words * sizeof(word_type));
+            }
+            return words;
+        }
+
+        static bool write_matrix(
+            FILE *fp,
+            const fltl::helper::BitMatrix &matrix
+        ) throw() {
+            const unsigned num_words(matrix.num_words_per_row());
+            for(unsigned r(0); r < matrix.num_rows(); ++r) {
+                if(num_words != fwrite(
+                    matrix.row(r), sizeof(word_type), num_words, fp
+                )) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+
+        /// a cache in some directory. if the directory is 0 then the cache
+        /// is disabled: nothing is ever found in it or stored in it.
+        explicit AnalysisCache(const char *dir_) throw()
+            : dir(dir_)
+        { }
+
+        inline bool is_enabled(void) const throw() {
+            return 0 != dir;
+        }
+
+        /// look for the sets of a grammar in the cache. the file is mapped
+        /// into memory and its words are copied out. returns false if the
+        /// sets are not in the cache or the cache file is stale.
+        template <typename AlphaT>
+        bool load(
+            const fltl::CFG<AlphaT> &cfg,
+            std::vector<bool> &nullable,
+            fltl::helper::BitMatrix &first,
+            fltl::helper::BitMatrix &follow
+        ) const throw() {
+            if(!is_enabled()) {
+                return false;
+            }
+
+            header_type expected;
+            make_header(cfg, expected);
+
+            const std::string file_name(path(expected));
+            const int fd(open(file_name.c_str(), O_RDONLY));
+            if(0 > fd) {
+                return false;
+            }
+
+            struct stat info;
+            const size_t size(file_size(expected));
+            void *data(MAP_FAILED);
+
+            if(0 == fstat(fd, &info)
+            && static_cast<size_t>(info.st_size) == size) {
+                data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+
+            close(fd);
+
+            if(MAP_FAILED == data) {
+                io::verbose("Ignoring stale analysis cache '%s'.\n", file_name.c_str());
+                return false;
+            }
+
+            bool found(0 == memcmp(data, &expected, sizeof expected));
+
+            if(found) {
+                const word_type *words(reinterpret_cast<const word_type *>(
+                    reinterpret_cast<const char *>(data) + sizeof expected
+                ));
+
+                nullable.assign(expected.num_rows, false);
+                for(unsigned V(0); V < expected.num_rows; ++V) {
+                    nullable[V] = fltl::helper::BitMatrix::test(words, V);
+                }
+                words += fltl::helper::BitMatrix::num_words(expected.num_rows);
+
+                words = read_matrix(
+                    words, first, expected.num_rows, expected.num_first_cols
+                );
+                read_matrix(
+                    words, follow, expected.num_rows, expected.num_follow_cols
+                );
+
+                io::verbose("Loaded sets from analysis cache '%s'.\n", file_name.c_str());
+            } else {
+                io::verbose("Ignoring stale analysis cache '%s'.\n", file_name.c_str());
+            }
+
+            munmap(data, size);
+            return found;
+        }
+
+        /// put the sets of a grammar into the cache. the file is written
+        /// under a temporary name and then renamed, so that other runs never
+        /// see a partial file. returns false if the file couldn't be
+        /// written.
+        template <typename AlphaT>
+        bool store(
+            const fltl::CFG<AlphaT> &cfg,
+            const std::vector<bool> &nullable,
+            const fltl::helper::BitMatrix &first,
+            const fltl::helper::BitMatrix &follow
+        ) const throw() {
+            if(!is_enabled()) {
+                return false;
+            }
+
+            header_type header;
+            make_header(cfg, header);
+
+            if(header.num_rows != first.num_rows()
+            || header.num_rows != follow.num_rows()
+            || header.num_first_cols != first.num_cols()
+            || header.num_follow_cols != follow.num_cols()) {
+                return false;
+            }
+
+            if(0 != mkdir(dir, 0777) && EEXIST != errno) {
+                io::verbose("Unable to create analysis cache directory '%s'.\n", dir);
+                return false;
+            }
+
+            const std::string file_name(path(header));
+
+            char suffix[32];
+            sprintf(suffix, ".%ld.tmp", static_cast<long>(getpid()));
+            const std::string temp_name(file_name + suffix);
+
+            FILE *fp(fopen(temp_name.c_str(), "wb"));
+            if(0 == fp) {
+                io::verbose("Unable to write analysis cache '%s'.\n", file_name.c_str());
+                return false;
+            }
+
+            std::vector<word_type> null_words(
+                fltl::helper::BitMatrix::num_words(header.num_rows),
+                0UL
+            );
+            for(unsigned V(0); V < nullable.size() && V < header.num_rows; ++V) {
+                if(nullable[V]) {
+                    fltl::helper::BitMatrix::set(&(null_words[0]), V);
+                }
+            }
+
+            bool written(
+                1U == fwrite(&header, sizeof header, 1U, fp)
+                && null_words.size() == fwrite(
+                    &(null_words[0]), sizeof(word_type), null_words.size(), fp
+                )
+                && write_matrix(fp, first)
+                && write_matrix(fp, follow)
+            );
+
+            written = (0 == fclose(fp)) && written;
+            written = written && 0 == rename(temp_name.c_str(), file_name.c_str());
+
+            if(!written) {
+                unlink(temp_name.c_str());
+                io::verbose("Unable to write analysis cache '%s'.\n", file_name.c_str());
+                return false;
+            }
+
+            io::verbose("Stored sets in analysis cache '%s'.\n", file_name.c_str());
+            return true;
+        }
+    };
+
+    /// fill in the NULL, FIRST, and FOLLOW sets of a grammar, taking them
+    /// from the cache if they are in it, and otherwise computing them and
+    /// adding them to the cache. returns true if the sets came from the
+    /// cache.
+    template <typename AlphaT>
+    bool compute_cached_sets(
+        const fltl::CFG<AlphaT> &cfg,
+        const AnalysisCache &cache,
+        std::vector<bool> &nullable,
+        fltl::helper::BitMatrix &first,
+        fltl::helper::BitMatrix &follow
+    ) throw() {
+        if(cache.load(cfg, nullable, first, follow)) {
+            return true;
+        }
+
+        compute_null_set(cfg, nullable);
+        compute_first_terminals(cfg, nullable, first);
+        compute_follow_set(cfg, nullable, first, follow);
+
+        cache.store(cfg, nullable, first, follow);
+        return false;
+    }
+}}
+
+#endif /* Grail_Plus_ANALYSIS_CACHE_HPP_ */
@@ -0,0 +1,256 @@
+/*
+ * CYKTables.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_CYK_TABLES_HPP_
+#define Grail_Plus_CYK_TABLES_HPP_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+
+namespace grail { namespace cfg {
+
+    /// rule tables of a grammar in Chomsky Normal Form, laid out for a CYK
+    /// recognizer whose chart cells are sets of variables. the tables are
+    /// built from a compiled grammar, so that the terminals of tokens are
+    /// found in the same way as by the other parsers.
+    ///
+    /// the binary productions A --> B C are grouped by their first variable
+    /// B. for each B, the variables C that can follow it are listed, along
+    /// with a row of all variables A such that A --> B C. combining two
+    /// cells is then a matter of or-ing in whole rows of variables.
+    template <typename AlphaT>
+    class CYKTables {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+        typedef bit_matrix_type::word_type word_type;
+
+        /// row t is the set of variables A such that A --> t
+        bit_matrix_type terminal_heads;
+
+        /// the variables A such that A --> t for some variable terminal t;
+        /// any token that is not a terminal of the grammar can begin these.
+        std::vector<word_type> variable_terminal_heads;
+
+        /// the variables B such that A --> B C for some A and C
+        std::vector<word_type> left_variables;
+
+        /// for each variable B, the range binary_right[binary_begin[B]] to
+        /// binary_right[binary_begin[B + 1]] lists the variables C such that
+        /// A --> B C for some A. row k of binary_heads is the set of those
+        /// variables A for the pair (B, binary_right[k]).
+        std::vector<unsigned> binary_begin;
+        std::vector<unsigned> binary_right;
+        bit_matrix_type binary_heads;
+
+        /// row B is the set of variables C such that A --> B C for some A;
+        /// a cell that has none of them can't be combined with B.
+        bit_matrix_type right_variables;
+
+        /// the start variable of the grammar, i.e. not the augmented one
+        unsigned start_variable;
+
+        /// true iff the grammar generates the empty string
+        bool accepts_empty;
+
+        /// true iff any of the variable terminals can begin a variable
+        bool has_variable_terminals;
+
+        /// false if some production of the grammar is not in CNF; such
+        /// productions are ignored.
+        bool is_cnf;
+
+        unsigned num_variables;
+        unsigned num_words;
+
+        explicit CYKTables(const grammar_type &grammar) throw()
+            : terminal_heads(grammar.num_terminals, grammar.num_variables)
+            , variable_terminal_heads()
+            , left_variables()
+            , binary_begin()
+            , binary_right()
+            , binary_heads()
+            , right_variables(grammar.num_variables, grammar.num_variables)
+            , start_variable(0)
+            , accepts_empty(false)
+            , has_variable_terminals(false)
+            , is_cnf(true)
+            , num_variables(grammar.num_variables)
+            , num_words(bit_matrix_type::num_words(grammar.num_variables))
+        {
+            typedef std::map<std::pair<unsigned, unsigned>, unsigned> pair_map;
+
+            variable_terminal_heads.assign(num_words, 0UL);
+            left_variables.assign(num_words, 0UL);
+            binary_begin.assign(num_variables + 1U, 0U);
+
+            if(0 == grammar.num_items()) {
+                binary_heads.resize(0, num_variables);
+                return;
+            }
+
+            start_variable = static_cast<unsigned>(
+                grammar.item_symbol[grammar.start_item]
+            );
+
+            // find the distinct pairs (B, C) of binary productions
+            pair_map pairs;
+            std::vector<unsigned> pair_heads;
+
+            for(unsigned p(0); p < grammar.num_productions(); ++p) {
+                const unsigned item(grammar.production_item[p]);
+                const unsigned A(grammar.item_variable[item]);
+                const symbol_id_type *syms(&(grammar.item_symbol[item]));
+
+                switch(grammar.production_length(p)) {
+                case 0:
+                    if(A == start_variable) {
+                        accepts_empty = true;
+                    } else {
+                        is_cnf = false;
+                    }
+                    break;
+
+                case 1:
+                    if(0 > syms[0]) {
+                        terminal_heads.set(static_cast<unsigned>(-syms[0]), A);
+                    } else {
+                        is_cnf = false;
+                    }
+                    break;
+
+                case 2:
+                    if(0 < syms[0] && 0 < syms[1]) {
+                        const std::pair<unsigned, unsigned> key(
+                            static_cast<unsigned>(syms[0]),
+                            static_cast<unsigned>(syms[1])
+                        );
+
+                        typename pair_map::iterator pos(pairs.find(key));
+                        if(pairs.end() == pos) {
+                            pos = pairs.insert(std::make_pair(
+                                key,
+                                static_cast<unsigned>(pairs.size())
+                            )).first;
+                        }
+
+                        pair_heads.push_back(pos->second);
+                        pair_heads.push_back(A);
+                    } else {
+                        is_cnf = false;
+                    }
+                    break;
+
+                default:
+                    is_cnf = false;
+                    break;
+                }
+            }
+
+            // lay out the pairs grouped by B; the map is ordered by B and
+            // then by C, so the pairs of each B are adjacent.
+            std::vector<unsigned> row_of_pair(pairs.size(), 0U);
+            binary_right.reserve(pairs.size());
+
+            for(typename pair_map::iterator pos(pairs.begin());
+                pairs.end() != pos;
+                ++pos) {
+
+                const unsigned B(pos->first.first);
+                row_of_pair[pos->second] = static_cast<unsigned>(
+                    binary_right.size()
+                );
+                binary_right.push_back(pos->first.second);
+                right_variables.set(B, pos->first.second);
+                ++(binary_begin[B + 1U]);
+                bit_matrix_type::set(&(left_variables[0]), B);
+            }
+
+            for(unsigned v(1); v <= num_variables; ++v) {
+                binary_begin[v] += binary_begin[v - 1U];
+            }
+
+            binary_heads.resize(
+                static_cast<unsigned>(binary_right.size()),
+                num_variables
+            );
+
+            for(unsigned i(0); i < pair_heads.size(); i += 2U) {
+                binary_heads.set(row_of_pair[pair_heads[i]], pair_heads[i + 1U]);
+            }
+
+            // merge the rows of the variable terminals
+            for(unsigned t(1); t < grammar.num_terminals; ++t) {
+                if(!grammar.is_variable_terminal[t]) {
+                    continue;
+                }
+
+                const word_type *heads(terminal_heads.row(t));
+                for(unsigned w(0); w < num_words; ++w) {
+                    has_variable_terminals = has_variable_terminals
+                                          || 0UL != heads[w];
+                }
+
+                bit_matrix_type::or_into(
+                    &(variable_terminal_heads[0]),
+                    heads,
+                    num_words
+                );
+            }
+        }
+
+        /// or into out the set of variables A such that A --> B C, where B
+        /// is in left and C is in right. returns the number of pairs (B, C)
+        /// that were looked at.
+        unsigned combine(
+            const word_type *left,
+            const word_type *right,
+            word_type *out
+        ) const throw() {
+            const word_type *lefts(&(left_variables[0]));
+            unsigned num_pairs(0);
+
+            for(unsigned w(0); w < num_words; ++w) {
+                word_type bits(left[w] & lefts[w]);
+
+                for(; 0UL != bits; bits &= bits - 1UL) {
+                    const unsigned B(
+                        w * bit_matrix_type::BITS_PER_WORD +
+                        bit_matrix_type::lowest_bit(bits)
+                    );
+
+                    for(unsigned k(binary_begin[B]), max_k(binary_begin[B + 1U]);
+                        k < max_k;
+                        ++k) {
+
+                        ++num_pairs;
+                        if(bit_matrix_type::test(right, binary_right[k])) {
+                            bit_matrix_type::or_into(
+                                out,
+                                binary_heads.row(k),
+                                num_words
+                            );
+                        }
+                    }
+                }
+            }
+
+            return num_pairs;
+        }
+    };
+}}
+
+#endif /* Grail_Plus_CYK_TABLES_HPP_ */
@@ -0,0 +1,418 @@
+/*
+ * CompiledGrammar.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+#ifndef Grail_Plus_COMPILED_GRAMMAR_HPP_
+#define Grail_Plus_COMPILED_GRAMMAR_HPP_
+
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+namespace grail { namespace cfg {
+
+    /// a read-only, integer-indexed view of a CFG that is meant to be used
+    /// by parsers. every production gets a number, and every dotted rule
+    /// (production, dot) gets a number, called its item id. the items of a
+    /// production are numbered consecutively, so that sliding the dot is the
+    /// same as adding one to the item id.
+    ///
+    /// symbols are represented in the same way as the CFG represents them
+    /// internally: variables are positive numbers, terminals are negative
+    /// numbers, and 0 marks the end of a production.
+    ///
+    /// the grammar is augmented with a fake start variable, START, and a
+    /// single production START -> S, where S is the start variable of the
+    /// CFG. the CFG itself is never modified.
+    template <typename AlphaT>
+    class CompiledGrammar {
+    public:
+
+        typedef fltl::CFG<AlphaT> CFG;
+
+        FLTL_CFG_USE_TYPES(CFG);
+
+        typedef fltl::cfg::internal_sym_type symbol_id_type;
+
+        enum {
+            END_OF_PRODUCTION = 0
+        };
+
+        /// the symbol after the dot of each item, or END_OF_PRODUCTION if
+        /// the item is complete.
+        std::vector<symbol_id_type> item_symbol;
+
+        /// the number of the variable on the left-hand side of each item
+        std::vector<unsigned> item_variable;
+
+        /// the production that each item is a dotted version of
+        std::vector<unsigned> item_production;
+
+        /// the position of the dot within each item
+        std::vector<unsigned> item_dot;
+
+        /// the id of the first item (dot at 0) of each production, plus one
+        /// extra entry so that the length of production p is
+        /// production_item[p + 1] - production_item[p] - 1.
+        std::vector<unsigned> production_item;
+
+        /// the productions, indexed by production number. the augmented
+        /// start production is not in this list.
+        std::vector<production_type> productions;
+
+        /// for each variable, the range predictions[prediction_begin[V]] to
+        /// predictions[prediction_begin[V + 1]] lists the first items of all
+        /// productions of V.
+        std::vector<unsigned> prediction_begin;
+        std::vector<unsigned> predictions;
+
+        /// for each variable, the range closure[closure_begin[V]] to
+        /// closure[closure_begin[V + 1]] lists V and every variable that is
+        /// predicted, directly or indirectly, when V is predicted. that is,
+        /// all variables X such that V derives X beta by way of leftmost
+        /// derivations, where nullable prefixes are skipped over.
+        std::vector<unsigned> closure_begin;
+        std::vector<unsigned> closure;
+
+        /// nullable variables, indexed by variable number
+        std::vector<bool> is_nullable;
+
+        /// for each nullable variable, the number of a production that
+        /// derives the empty string in the fewest steps. this is used to
+        /// build the parse trees of empty spans of the input.
+        std::vector<unsigned> null_production;
+
+        /// variable terminals, indexed by terminal number
+        std::vector<bool> is_variable_terminal;
+
+        /// the lexemes of the terminals, indexed by terminal number. variable
+        /// terminals have no lexeme.
+        std::vector<alphabet_type> terminal_lexemes;
+
+        /// open-addressed hash table of the terminal numbers, keyed by their
+        /// lexemes. empty slots are 0, which is not a terminal number.
+        std::vector<unsigned> terminal_table;
+
+        /// the terminals and variables of the grammar, indexed by number.
+        /// unused variable numbers map to the start variable.
+        std::vector<terminal_type> terminals;
+        std::vector<variable_type> variables;
+
+        /// number of the augmented start variable
+        unsigned start_variable;
+
+        /// the items START -> . S and START -> S .
+        unsigned start_item;
+        unsigned accept_item;
+
+        unsigned num_variables;
+        unsigned num_terminals;
+
+        CompiledGrammar(
+            const CFG &cfg,
+            const std::vector<bool> &nullable
+        ) throw()
+            : start_variable(cfg.num_variables_capacity())
+            , start_item(0)
+            , accept_item(0)
+            , num_variables(cfg.num_variables_capacity() + 1U)
+            , num_terminals(cfg.num_terminals() + 1U)
+        {
+            production_type prod;
+            variable_type V;
+            terminal_type T;
+
+            // index the symbols
+            terminals.assign(num_terminals, T);
+            is_variable_terminal.assign(num_terminals, false);
+            generator_type terms(cfg.search(~T));
+            terminal_lexemes.assign(num_terminals, alphabet_type());
+            for(; terms.match_next(); ) {
+                terminals[T.number()] = T;
+                is_variable_terminal[T.number()] = cfg.is_variable_terminal(T);
+                if(!is_variable_terminal[T.number()]) {
+                    terminal_lexemes[T.number()] = cfg.get_alpha(T);
+                }
+            }
+
+            hash_terminals();
+
+            is_nullable.assign(num_variables, false);
+
+            if(!cfg.has_start_variable()) {
+                prediction_begin.assign(num_variables + 1U, 0U);
+                closure_begin.assign(num_variables + 1U, 0U);
+                return;
+            }
+
+            variables.assign(num_variables, cfg.get_start_variable());
+            generator_type vars(cfg.search(~V));
+            for(; vars.match_next(); ) {
+                variables[V.number()] = V;
+                is_nullable[V.number()] = nullable[V.number()];
+            }
+
+            is_nullable[start_variable] = is_nullable[
+                cfg.get_start_variable().number()
+            ];
+
+            // count the productions of each variable so that they can be
+            // laid out contiguously and grouped by their variable.
+            std::vector<unsigned> num_prods(num_variables + 1U, 0U);
+            generator_type prods(cfg.search(~prod));
+            unsigned num_prods_total(0);
+            for(; prods.match_next(); ++num_prods_total) {
+                ++(num_prods[prod.variable().number()]);
+            }
+
+            prediction_begin.assign(num_variables + 1U, 0U);
+            for(unsigned v(1); v <= num_variables; ++v) {
+                prediction_begin[v] = prediction_begin[v - 1] + num_prods[v - 1];
+            }
+
+            productions.assign(num_prods_total, prod);
+            predictions.assign(num_prods_total, 0U);
+
+            std::vector<unsigned> next_slot(
+                prediction_begin.begin(),
+                prediction_begin.end()
+            );
+
+            for(prods.rewind(); prods.match_next(); ) {
+                productions[next_slot[prod.variable().number()]++] = prod;
+            }
+
+            // lay out the items; production numbers follow the prediction
+            // order, so the items of a variable's productions are adjacent.
+            for(unsigned p(0); p < num_prods_total; ++p) {
+                add_production_items(p, productions[p]);
+                predictions[p] = production_item[p];
+            }
+
+            // add in the augmented start production
+            start_item = static_cast<unsigned>(item_symbol.size());
+            production_item.push_back(start_item);
+
+            item_symbol.push_back(static_cast<symbol_id_type>(
+                cfg.get_start_variable().number()
+            ));
+            item_variable.push_back(start_variable);
+            item_production.push_back(num_prods_total);
+            item_dot.push_back(0U);
+
+            accept_item = start_item + 1U;
+            item_symbol.push_back(END_OF_PRODUCTION);
+            item_variable.push_back(start_variable);
+            item_production.push_back(num_prods_total);
+            item_dot.push_back(1U);
+
+            production_item.push_back(accept_item + 1U);
+
+            find_null_productions();
+            find_prediction_closures();
+        }
+
+        /// the number of distinct items
+        inline unsigned num_items(void) const throw() {
+            return static_cast<unsigned>(item_symbol.size());
+        }
+
+        /// the number of productions, not including the augmented start
+        /// production
+        inline unsigned num_productions(void) const throw() {
+            return static_cast<unsigned>(productions.size());
+        }
+
+        /// the number of symbols on the right-hand side of a production
+        inline unsigned production_length(const unsigned p) const throw() {
+            return production_item[p + 1U] - production_item[p] - 1U;
+        }
+
+        /// find the number of the terminal whose lexeme is term, or 0 if
+        /// there is no such terminal. variable terminals are never found.
+        unsigned find_terminal(const alphabet_type &term) const throw() {
+            const unsigned mask(
+                static_cast<unsigned>(terminal_table.size()) - 1U
+            );
+            unsigned slot(
+                static_cast<unsigned>(traits_type::hash(term)) & mask
+            );
+
+            for(; 0 != terminal_table[slot];
+                slot = (slot + 1U) & mask) {
+
+                if(traits_type::equal(
+                    terminal_lexemes[terminal_table[slot]],
+                    term
+                )) {
+                    return terminal_table[slot];
+                }
+            }
+
+            return 0U;
+        }
+
+    private:
+
+        /// build the hash table of terminals; the table is kept at most
+        /// half full so that probe sequences stay short.
+        void hash_terminals(void) throw() {
+            unsigned capacity(8U);
+            for(; capacity < num_terminals * 2U; ) {
+                capacity *= 2U;
+            }
+
+            terminal_table.assign(capacity, 0U);
+            const unsigned mask(capacity - 1U);
+
+            for(unsigned t(1); t < num_terminals; ++t) {
+                if(is_variable_terminal[t]) {
+                    continue;
+                }
+
+                unsigned slot(static_cast<unsigned>(
+                    traits_type::hash(terminal_lexemes[t])
+                ) & mask);
+
+                for(; 0 != terminal_table[slot]; ) {
+                    slot = (slot + 1U) & mask;
+                }
+
+                terminal_table[slot] = t;
+            }
+        }
+
+        /// find the shallowest way for each nullable variable to derive the
+        /// empty string. a production can only be used once all of the
+        /// variables on its right-hand side have a known derivation.
+        void find_null_productions(void) throw() {
+            const unsigned NO_HEIGHT(~0U);
+            std::vector<unsigned> height(num_variables, NO_HEIGHT);
+
+            null_production.assign(num_variables, 0U);
+
+            for(bool updated(true); updated; ) {
+                updated = false;
+
+                for(unsigned p(0); p < num_productions(); ++p) {
+                    const unsigned var(item_variable[production_item[p]]);
+                    if(!is_nullable[var]) {
+                        continue;
+                    }
+
+                    unsigned max_height(0);
+                    for(unsigned item(production_item[p]);
+                        END_OF_PRODUCTION != item_symbol[item];
+                        ++item) {
+
+                        const symbol_id_type sym(item_symbol[item]);
+                        if(0 > sym
+                        || NO_HEIGHT == height[static_cast<unsigned>(sym)]) {
+                            max_height = NO_HEIGHT;
+                            break;
+                        }
+
+                        if(max_height < height[static_cast<unsigned>(sym)]) {
+                            max_height = height[static_cast<unsigned>(sym)];
+                        }
+                    }
+
+                    if(NO_HEIGHT != max_height
+                    && max_height + 1U < height[var]) {
+                        height[var] = max_height + 1U;
+                        null_production[var] = p;
+                        updated = true;
+                    }
+                }
+            }
+        }
+
+        /// find the prediction closure of each variable by walking the left
+        /// corners of its productions. a symbol is a left corner if all of
+        /// the symbols before it are nullable variables.
+        void find_prediction_closures(void) throw() {
+            const unsigned NOT_SEEN(~0U);
+            std::vector<unsigned> seen_by(num_variables, NOT_SEEN);
+            std::vector<unsigned> work;
+
+            closure_begin.assign(num_variables + 1U, 0U);
+
+            for(unsigned V(0); V < num_variables; ++V) {
+                closure_begin[V] = static_cast<unsigned>(closure.size());
+
+                work.clear();
+                work.push_back(V);
+                seen_by[V] = V;
+
+                for(; !work.empty(); ) {
+                    const unsigned X(work.back());
+                    work.pop_back();
+                    closure.push_back(X);
+
+                    for(unsigned p(prediction_begin[X]),
+                                 max_p(prediction_begin[X + 1U]);
+                        p < max_p;
+                        ++p) {
+
+                        for(unsigned item(predictions[p]);
+                            0 < item_symbol[item];
+                            ++item) {
+
+                            const unsigned Y(
+                                static_cast<unsigned>(item_symbol[item])
+                            );
+
+                            if(V != seen_by[Y]) {
+                                seen_by[Y] = V;
+                                work.push_back(Y);
+                            }
+
+                            if(!is_nullable[Y]) {
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            closure_begin[num_variables] = static_cast<unsigned>(
+                closure.size()
+            );
+        }
+
+        void add_production_items(
+            const unsigned p,
+            const production_type &prod
+        ) throw() {
+            const unsigned len(prod.length());
+            const unsigned var(prod.variable().number());
+
+            production_item.push_back(
+                static_cast<unsigned>(item_symbol.size())
+            );
+
+            for(unsigned dot(0); dot <= len; ++dot) {
+                symbol_id_type sym(END_OF_PRODUCTION);
+
+                if(dot < len) {
+                    const symbol_type &S(prod.symbol_at(dot));
+                    sym = static_cast<symbol_id_type>(S.number());
+                    if(S.is_terminal()) {
+                        sym = -sym;
+                    }
+                }
+
+                item_symbol.push_back(sym);
+                item_variable.push_back(var);
+                item_production.push_back(p);
+                item_dot.push_back(dot);
+            }
+        }
+    };
+}}
+
+#endif /* Grail_Plus_COMPILED_GRAMMAR_HPP_ */
@@ -0,0 +1,116 @@
+/*
+ * GLLTables.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_GLL_TABLES_HPP_
+#define Grail_Plus_GLL_TABLES_HPP_
+
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+
+namespace grail { namespace cfg {
+
+    /// the select sets of the productions of a compiled grammar, for
+    /// filtering the alternates that a GLL parser tries. the select set of
+    /// A --> w is FIRST(w), along with FOLLOW(A) if w is nullable; column 0
+    /// is the end of the input. unlike in an LL(1) table, a terminal can be
+    /// in the select sets of several productions of the same variable.
+    template <typename AlphaT>
+    class GLLTables {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+
+        enum {
+            END_OF_INPUT = 0
+        };
+
+        /// row p is the select set of production p
+        bit_matrix_type select;
+
+        /// are the variable terminals in the select set of production p?
+        /// any token that is not a terminal of the grammar can begin these
+        /// productions.
+        std::vector<bool> selects_variable_terminal;
+
+        GLLTables(
+            const grammar_type &grammar,
+            const bit_matrix_type &first,
+            const bit_matrix_type &follow
+        ) throw()
+            : select(grammar.num_productions(), grammar.num_terminals)
+            , selects_variable_terminal(grammar.num_productions(), false)
+        {
+            for(unsigned p(0); p < grammar.num_productions(); ++p) {
+                const unsigned item(grammar.production_item[p]);
+                bool is_nullable(true);
+
+                for(unsigned curr(item);
+                    grammar_type::END_OF_PRODUCTION != grammar.item_symbol[curr];
+                    ++curr) {
+
+                    const symbol_id_type sym(grammar.item_symbol[curr]);
+
+                    if(0 > sym) {
+                        select.set(p, static_cast<unsigned>(-sym));
+                        is_nullable = false;
+                        break;
+                    }
+
+                    add_set(p, first, static_cast<unsigned>(sym));
+
+                    if(!grammar.is_nullable[static_cast<unsigned>(sym)]) {
+                        is_nullable = false;
+                        break;
+                    }
+                }
+
+                if(is_nullable) {
+                    add_set(p, follow, grammar.item_variable[item]);
+                }
+
+                for(unsigned t(1); t < grammar.num_terminals; ++t) {
+                    if(grammar.is_variable_terminal[t] && select.test(p, t)) {
+                        selects_variable_terminal[p] = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+    private:
+
+        /// add a FIRST or FOLLOW set into the select set of production p.
+        /// the sets only hold terminals of the grammar, so only the words
+        /// that both rows have need to be looked at.
+        void add_set(
+            const unsigned p,
+            const bit_matrix_type &sets,
+            const unsigned var
+        ) throw() {
+            if(var >= sets.num_rows()) {
+                return;
+            }
+
+            const unsigned num_words(
+                sets.num_words_per_row() < select.num_words_per_row()
+                ? sets.num_words_per_row()
+                : select.num_words_per_row()
+            );
+
+            bit_matrix_type::or_into(select.row(p), sets.row(var), num_words);
+        }
+    };
+}}
+
+#endif /* Grail_Plus_GLL_TABLES_HPP_ */
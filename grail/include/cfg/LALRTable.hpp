@@ -0,0 +1,539 @@
+/*
+ * LALRTable.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_LALR_TABLE_HPP_
+#define Grail_Plus_LALR_TABLE_HPP_
+
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+#include "fltl/include/helper/PackedTable.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LR0Automaton.hpp"
+#include "grail/include/cfg/digraph.hpp"
+
+namespace grail { namespace cfg {
+
+    /// LALR(1) action and goto tables of a compiled grammar. the lookahead
+    /// sets of the reductions are computed from the grammar's LR(0)
+    /// automaton with the relations of DeRemer and Pennello: the sets that
+    /// are directly read after each variable transition are propagated
+    /// along the 'reads' relation, and then along the 'includes' relation,
+    /// and finally handed to the reductions through 'lookback'.
+    ///
+    /// conflicts are resolved in the same way as by yacc: shifts win over
+    /// reductions, and reductions by earlier productions win over later
+    /// ones. each state's most common reduction is made its default action,
+    /// and both tables are compressed by row displacement.
+    ///
+    /// a token that is not a terminal of the grammar can match any of its
+    /// variable terminals, so the actions of the variable terminals are
+    /// also kept in one extra column, UNKNOWN_TERMINAL. a cell of that
+    /// column where variable terminals have different actions holds
+    /// ACTION_AMBIGUOUS.
+    template <typename AlphaT>
+    class LALRTable {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef LR0Automaton<AlphaT> automaton_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+
+        enum {
+            END_OF_INPUT = 0,
+            UNKNOWN_TERMINAL = 0xFFFFFFFEU,
+            NO_STATE = automaton_type::NO_STATE
+        };
+
+        /// actions are stored with their kind in the low bits, and the
+        /// target state or production in the remaining bits
+        enum {
+            ACTION_ERROR = 0,
+            ACTION_SHIFT = 1,
+            ACTION_REDUCE = 2,
+            ACTION_ACCEPT = 3,
+            ACTION_KIND_BITS = 2,
+            ACTION_KIND_MASK = 3,
+
+            // an error whose target is 1
+            ACTION_AMBIGUOUS = 4
+        };
+
+        enum {
+            SHIFT_REDUCE,
+            REDUCE_REDUCE
+        };
+
+        /// two actions of a state that apply to the same lookahead terminal
+        class conflict_type {
+        public:
+            unsigned kind;
+            unsigned state;
+            unsigned terminal;
+            unsigned chosen;
+            unsigned rejected;
+        };
+
+        /// conflicts found while building the action table
+        std::vector<conflict_type> conflicts;
+
+        /// the reductions of state s are the complete items
+        /// reduction_item[reduction_begin[s]] to
+        /// reduction_item[reduction_begin[s + 1]]; row r of lookaheads is
+        /// the set of lookahead terminals of reduction r.
+        std::vector<unsigned> reduction_begin;
+        std::vector<unsigned> reduction_item;
+        bit_matrix_type lookaheads;
+
+        /// the action of each state on lookaheads that have no entry in
+        /// the action table
+        std::vector<unsigned> default_action;
+
+    private:
+
+        fltl::helper::PackedTable actions;
+        fltl::helper::PackedTable gotos;
+
+        // the UNKNOWN_TERMINAL column
+        std::vector<unsigned> variable_terminal_action;
+
+        bool has_variable_terminals_;
+
+    public:
+
+        LALRTable(
+            const grammar_type &grammar,
+            const automaton_type &automaton
+        ) throw()
+            : conflicts()
+            , reduction_begin()
+            , reduction_item()
+            , lookaheads()
+            , default_action(automaton.num_states(), ACTION_ERROR)
+            , actions()
+            , gotos()
+            , variable_terminal_action(automaton.num_states(), ACTION_ERROR)
+            , has_variable_terminals_(false)
+        {
+            find_reductions(grammar, automaton);
+            find_lookaheads(grammar, automaton);
+            build_actions(grammar, automaton);
+            build_gotos(grammar, automaton);
+        }
+
+        inline static unsigned make_action(
+            const unsigned kind,
+            const unsigned target
+        ) throw() {
+            return (target << ACTION_KIND_BITS) | kind;
+        }
+
+        inline static unsigned action_kind(const unsigned action) throw() {
+            return action & ACTION_KIND_MASK;
+        }
+
+        inline static unsigned action_target(const unsigned action) throw() {
+            return action >> ACTION_KIND_BITS;
+        }
+
+        /// the action of state s on the lookahead terminal a, which can be
+        /// UNKNOWN_TERMINAL
+        inline unsigned action(const unsigned s, const unsigned a) const throw() {
+            const unsigned act(UNKNOWN_TERMINAL == a
+                ? variable_terminal_action[s]
+                : actions.get(s, a)
+            );
+            if(ACTION_ERROR == act) {
+                return default_action[s];
+            }
+            return act;
+        }
+
+        /// the state to go to from state s after reducing to variable A
+        inline unsigned next_state(const unsigned s, const unsigned A) const throw() {
+            return gotos.get(s, A);
+        }
+
+        /// can tokens that are not terminals of the grammar be matched?
+        inline bool has_variable_terminals(void) const throw() {
+            return has_variable_terminals_;
+        }
+
+        /// the number of entries in the packed action and goto tables
+        inline unsigned num_entries(void) const throw() {
+            return actions.num_entries() + gotos.num_entries();
+        }
+
+    private:
+
+        /// list the complete items of every state, except for the accept
+        /// item START --> S .
+        void find_reductions(
+            const grammar_type &grammar,
+            const automaton_type &automaton
+        ) throw() {
+            reduction_begin.push_back(0U);
+            for(unsigned s(0); s < automaton.num_states(); ++s) {
+                for(unsigned i(automaton.state_begin[s]);
+                    i < automaton.state_begin[s + 1U];
+                    ++i) {
+
+                    const unsigned item(automaton.items[i]);
+                    if(grammar_type::END_OF_PRODUCTION == grammar.item_symbol[item]
+                    && grammar.accept_item != item) {
+                        reduction_item.push_back(item);
+                    }
+                }
+                reduction_begin.push_back(
+                    static_cast<unsigned>(reduction_item.size())
+                );
+            }
+        }
+
+        /// find the reduction of a complete item in a state
+        unsigned find_reduction(const unsigned s, const unsigned item) const throw() {
+            unsigned r(reduction_begin[s]);
+            for(; reduction_item[r] != item; ++r) {
+                // linear search; states have few reductions
+            }
+            return r;
+        }
+
+        /// compute the DeRemer-Pennello lookahead sets
+        void find_lookaheads(
+            const grammar_type &grammar,
+            const automaton_type &automaton
+        ) throw() {
+            const unsigned num_terminals(grammar.num_terminals);
+            const unsigned num_transitions(static_cast<unsigned>(
+                automaton.transition_symbol.size()
+            ));
+
+            // number the variable transitions (p, A)
+            std::vector<unsigned> ntt_of(num_transitions, NO_STATE);
+            std::vector<unsigned> ntt_state;
+            std::vector<unsigned> ntt_variable;
+            std::vector<unsigned> ntt_target;
+
+            for(unsigned s(0); s < automaton.num_states(); ++s) {
+                for(unsigned k(automaton.transition_begin[s]);
+                    k < automaton.transition_begin[s + 1U];
+                    ++k) {
+
+                    const symbol_id_type sym(automaton.transition_symbol[k]);
+                    if(0 < sym) {
+                        ntt_of[k] = static_cast<unsigned>(ntt_state.size());
+                        ntt_state.push_back(s);
+                        ntt_variable.push_back(static_cast<unsigned>(sym));
+                        ntt_target.push_back(automaton.transition_target[k]);
+                    }
+                }
+            }
+
+            const unsigned num_ntt(static_cast<unsigned>(ntt_state.size()));
+            bit_matrix_type sets(num_ntt, num_terminals);
+            std::vector<std::vector<unsigned> > reads(num_ntt);
+            std::vector<std::vector<unsigned> > includes(num_ntt);
+            std::vector<std::vector<unsigned> > lookback(reduction_item.size());
+
+            // DR(p, A): the terminals that can be shifted right after the
+            // transition, and reads: the transitions on nullable variables
+            // that can follow it
+            for(unsigned x(0); x < num_ntt; ++x) {
+                const unsigned r(ntt_target[x]);
+                for(unsigned k(automaton.transition_begin[r]);
+                    k < automaton.transition_begin[r + 1U];
+                    ++k) {
+
+                    const symbol_id_type sym(automaton.transition_symbol[k]);
+                    if(0 > sym) {
+                        sets.set(x, static_cast<unsigned>(-sym));
+                    } else if(grammar.is_nullable[static_cast<unsigned>(sym)]) {
+                        reads[x].push_back(ntt_of[k]);
+                    }
+                }
+
+                // the start variable is followed by the end of the input
+                if(0U == ntt_state[x]
+                && grammar.item_symbol[grammar.start_item] ==
+                   static_cast<symbol_id_type>(ntt_variable[x])) {
+                    sets.set(x, END_OF_INPUT);
+                }
+            }
+
+            digraph(reads, sets);
+
+            // includes: (q, A) includes (p, B) if B --> beta A gamma, gamma
+            // is nullable, and p reaches q on beta. lookback: the reduction
+            // of B --> omega in state q looks back at (p, B) if p reaches q
+            // on omega.
+            for(unsigned x(0); x < num_ntt; ++x) {
+                const unsigned B(ntt_variable[x]);
+
+                for(unsigned p(grammar.prediction_begin[B]);
+                    p < grammar.prediction_begin[B + 1U];
+                    ++p) {
+
+                    const unsigned first_item(grammar.predictions[p]);
+                    unsigned last_item(first_item);
+                    for(; grammar_type::END_OF_PRODUCTION !=
+                          grammar.item_symbol[last_item]; ) {
+                        ++last_item;
+                    }
+
+                    // the first item whose suffix is nullable
+                    unsigned nullable_from(last_item);
+                    for(; nullable_from > first_item; --nullable_from) {
+                        const symbol_id_type sym(
+                            grammar.item_symbol[nullable_from - 1U]
+                        );
+                        if(0 > sym
+                        || !grammar.is_nullable[static_cast<unsigned>(sym)]) {
+                            break;
+                        }
+                    }
+
+                    unsigned q(ntt_state[x]);
+                    for(unsigned item(first_item); item < last_item; ++item) {
+                        const symbol_id_type sym(grammar.item_symbol[item]);
+                        const unsigned k(automaton.find_transition(q, sym));
+
+                        if(0 < sym && item + 1U >= nullable_from) {
+                            includes[ntt_of[k]].push_back(x);
+                        }
+
+                        q = automaton.transition_target[k];
+                    }
+
+                    lookback[find_reduction(q, last_item)].push_back(x);
+                }
+            }
+
+            digraph(includes, sets);
+
+            // LA(q, A --> omega) is the union of the follow sets of the
+            // transitions that the reduction looks back at
+            lookaheads.resize(
+                static_cast<unsigned>(reduction_item.size()),
+                num_terminals
+            );
+
+            for(unsigned r(0); r < reduction_item.size(); ++r) {
+                for(unsigned i(0); i < lookback[r].size(); ++i) {
+                    bit_matrix_type::or_into(
+                        lookaheads.row(r),
+                        sets.row(lookback[r][i]),
+                        sets.num_words_per_row()
+                    );
+                }
+            }
+        }
+
+        /// record a conflict between two actions of a state
+        void add_conflict(
+            const unsigned kind,
+            const unsigned state,
+            const unsigned terminal,
+            const unsigned chosen,
+            const unsigned rejected
+        ) throw() {
+            conflict_type conflict;
+            conflict.kind = kind;
+            conflict.state = state;
+            conflict.terminal = terminal;
+            conflict.chosen = chosen;
+            conflict.rejected = rejected;
+            conflicts.push_back(conflict);
+        }
+
+        /// add the reduction by production p on lookahead t to the action
+        /// table row of state s, resolving any conflicts
+        void add_reduction(
+            const unsigned s,
+            unsigned *row,
+            const unsigned p,
+            const unsigned t
+        ) throw() {
+            const unsigned reduce(make_action(ACTION_REDUCE, p));
+            const unsigned existing(row[t]);
+
+            if(ACTION_ERROR == existing) {
+                row[t] = reduce;
+
+            } else if(ACTION_REDUCE != action_kind(existing)) {
+                add_conflict(SHIFT_REDUCE, s, t, existing, reduce);
+
+            } else if(p < action_target(existing)) {
+                add_conflict(REDUCE_REDUCE, s, t, reduce, existing);
+                row[t] = reduce;
+
+            } else {
+                add_conflict(REDUCE_REDUCE, s, t, existing, reduce);
+            }
+        }
+
+        /// fill in and compress the action table
+        void build_actions(
+            const grammar_type &grammar,
+            const automaton_type &automaton
+        ) throw() {
+            const unsigned num_states(automaton.num_states());
+            const unsigned num_terminals(grammar.num_terminals);
+
+            std::vector<unsigned> dense(
+                static_cast<std::vector<unsigned>::size_type>(num_states) *
+                num_terminals,
+                static_cast<unsigned>(ACTION_ERROR)
+            );
+
+            std::vector<unsigned> counts(grammar.num_productions() + 1U, 0U);
+
+            for(unsigned s(0); s < num_states; ++s) {
+                unsigned *row(&(dense[s * num_terminals]));
+
+                // shifts
+                for(unsigned k(automaton.transition_begin[s]);
+                    k < automaton.transition_begin[s + 1U];
+                    ++k) {
+
+                    const symbol_id_type sym(automaton.transition_symbol[k]);
+                    if(0 > sym) {
+                        row[static_cast<unsigned>(-sym)] = make_action(
+                            ACTION_SHIFT,
+                            automaton.transition_target[k]
+                        );
+                    }
+                }
+
+                // accept
+                for(unsigned i(automaton.state_begin[s]);
+                    i < automaton.state_begin[s + 1U];
+                    ++i) {
+                    if(grammar.accept_item == automaton.items[i]) {
+                        row[END_OF_INPUT] = make_action(ACTION_ACCEPT, 0U);
+                    }
+                }
+
+                // reductions
+                for(unsigned r(reduction_begin[s]); r < reduction_begin[s + 1U]; ++r) {
+                    const unsigned p(grammar.item_production[reduction_item[r]]);
+                    const typename bit_matrix_type::word_type *la(
+                        lookaheads.row(r)
+                    );
+
+                    // visit only the lookaheads of the reduction
+                    for(unsigned w(0); w < lookaheads.num_words_per_row(); ++w) {
+                        typename bit_matrix_type::word_type bits(la[w]);
+                        for(; 0UL != bits; bits &= bits - 1UL) {
+                            add_reduction(
+                                s, row, p,
+                                w * bit_matrix_type::BITS_PER_WORD +
+                                bit_matrix_type::lowest_bit(bits)
+                            );
+                        }
+                    }
+                }
+
+                // actions on tokens that are not terminals
+                unsigned &unknown(variable_terminal_action[s]);
+                for(unsigned t(1); t < num_terminals; ++t) {
+                    if(!grammar.is_variable_terminal[t]
+                    || ACTION_ERROR == row[t]) {
+                        continue;
+                    }
+
+                    if(ACTION_ERROR == unknown) {
+                        unknown = row[t];
+                    } else if(row[t] != unknown) {
+                        unknown = ACTION_AMBIGUOUS;
+                    }
+                }
+
+                // make the most common reduction the default action
+                unsigned best(ACTION_ERROR);
+                unsigned best_count(0U);
+                for(unsigned t(0); t < num_terminals; ++t) {
+                    if(ACTION_REDUCE != action_kind(row[t])) {
+                        continue;
+                    }
+
+                    const unsigned p(action_target(row[t]));
+                    if(++(counts[p]) > best_count) {
+                        best_count = counts[p];
+                        best = row[t];
+                    }
+                }
+
+                if(ACTION_ERROR != best) {
+                    default_action[s] = best;
+                    for(unsigned t(0); t < num_terminals; ++t) {
+                        if(ACTION_REDUCE == action_kind(row[t])) {
+                            counts[action_target(row[t])] = 0U;
+                        }
+                        if(best == row[t]) {
+                            row[t] = ACTION_ERROR;
+                        }
+                    }
+                }
+            }
+
+            for(unsigned t(1); t < num_terminals; ++t) {
+                if(grammar.is_variable_terminal[t]) {
+                    has_variable_terminals_ = true;
+                }
+            }
+
+            actions.pack(
+                dense,
+                num_states,
+                num_terminals,
+                static_cast<unsigned>(ACTION_ERROR)
+            );
+        }
+
+        /// fill in and compress the goto table
+        void build_gotos(
+            const grammar_type &grammar,
+            const automaton_type &automaton
+        ) throw() {
+            const unsigned num_states(automaton.num_states());
+            const unsigned num_variables(grammar.num_variables);
+
+            std::vector<unsigned> dense(
+                static_cast<std::vector<unsigned>::size_type>(num_states) *
+                num_variables,
+                static_cast<unsigned>(NO_STATE)
+            );
+
+            for(unsigned s(0); s < num_states; ++s) {
+                for(unsigned k(automaton.transition_begin[s]);
+                    k < automaton.transition_begin[s + 1U];
+                    ++k) {
+
+                    const symbol_id_type sym(automaton.transition_symbol[k]);
+                    if(0 < sym) {
+                        dense[s * num_variables + static_cast<unsigned>(sym)] =
+                            automaton.transition_target[k];
+                    }
+                }
+            }
+
+            gotos.pack(
+                dense,
+                num_states,
+                num_variables,
+                static_cast<unsigned>(NO_STATE)
+            );
+        }
+    };
+}}
+
+#endif /* Grail_Plus_LALR_TABLE_HPP_ */
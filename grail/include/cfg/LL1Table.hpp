@@ -0,0 +1,217 @@
+/*
+ * LL1Table.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_LL1_TABLE_HPP_
+#define Grail_Plus_LL1_TABLE_HPP_
+
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+#include "fltl/include/helper/BitSet.hpp"
+#include "fltl/include/helper/PackedTable.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+
+namespace grail { namespace cfg {
+
+    /// LL(1) parse table of a compiled grammar. the table maps a variable
+    /// and a lookahead terminal to the production that should be used to
+    /// expand the variable. column 0 is the end of the input.
+    ///
+    /// a token that is not a terminal of the grammar can match any of its
+    /// variable terminals, so the productions that variable terminals
+    /// select are also kept in one extra column, UNKNOWN_TERMINAL. a cell
+    /// of that column where variable terminals select different
+    /// productions holds AMBIGUOUS_PRODUCTION.
+    ///
+    /// the table is built densely and then compressed by row displacement
+    /// (see PackedTable).
+    template <typename AlphaT>
+    class LL1Table {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef fltl::helper::BitMatrix::word_type word_type;
+
+        enum {
+            END_OF_INPUT = 0,
+            UNKNOWN_TERMINAL = 0xFFFFFFFEU,
+            AMBIGUOUS_PRODUCTION = 0xFFFFFFFEU,
+            NO_PRODUCTION = 0xFFFFFFFFU
+        };
+
+        /// two productions of a variable that can both be used on some
+        /// lookahead terminal
+        class conflict_type {
+        public:
+            unsigned variable;
+            unsigned terminal;
+            unsigned chosen;
+            unsigned rejected;
+        };
+
+        /// conflicts found while building the table; the table holds the
+        /// production that was added to a cell first.
+        std::vector<conflict_type> conflicts;
+
+    private:
+
+        fltl::helper::PackedTable packed;
+
+        // the UNKNOWN_TERMINAL column
+        std::vector<unsigned> variable_terminal_productions;
+
+        bool has_variable_terminals_;
+
+    public:
+
+        LL1Table(
+            const grammar_type &grammar,
+            const fltl::helper::BitMatrix &first,
+            const fltl::helper::BitMatrix &follow
+        ) throw()
+            : conflicts()
+            , packed()
+            , variable_terminal_productions(
+                grammar.num_variables,
+                static_cast<unsigned>(NO_PRODUCTION)
+            )
+            , has_variable_terminals_(false)
+        {
+            const unsigned num_columns(grammar.num_terminals);
+            std::vector<unsigned> dense(
+                static_cast<std::vector<unsigned>::size_type>(
+                    grammar.num_variables
+                ) * num_columns,
+                static_cast<unsigned>(NO_PRODUCTION)
+            );
+
+            fltl::helper::BitSet lookahead(num_columns);
+
+            for(unsigned p(0); p < grammar.num_productions(); ++p) {
+                const unsigned item(grammar.production_item[p]);
+                const unsigned A(grammar.item_variable[item]);
+
+                // the lookahead terminals of A --> w are FIRST(w), along
+                // with FOLLOW(A) if w is nullable
+                lookahead.clear();
+                bool is_nullable(true);
+
+                for(unsigned curr(item);
+                    grammar_type::END_OF_PRODUCTION != grammar.item_symbol[curr];
+                    ++curr) {
+
+                    const symbol_id_type sym(grammar.item_symbol[curr]);
+
+                    if(0 > sym) {
+                        lookahead.set(static_cast<unsigned>(-sym));
+                        is_nullable = false;
+                        break;
+                    }
+
+                    add_set(lookahead, first, static_cast<unsigned>(sym));
+
+                    if(!grammar.is_nullable[static_cast<unsigned>(sym)]) {
+                        is_nullable = false;
+                        break;
+                    }
+                }
+
+                if(is_nullable) {
+                    add_set(lookahead, follow, A);
+                }
+
+                unsigned *row(&(dense[A * num_columns]));
+                const word_type *words(lookahead.data());
+
+                for(unsigned w(0); w < lookahead.num_words(); ++w) {
+                    for(word_type bits(words[w]); 0UL != bits; bits &= bits - 1UL) {
+                        const unsigned t(
+                            w * fltl::helper::BitMatrix::BITS_PER_WORD
+                          + fltl::helper::BitMatrix::lowest_bit(bits)
+                        );
+
+                        if(NO_PRODUCTION == row[t]) {
+                            row[t] = p;
+                        } else if(p != row[t]) {
+                            conflict_type conflict;
+                            conflict.variable = A;
+                            conflict.terminal = t;
+                            conflict.chosen = row[t];
+                            conflict.rejected = p;
+                            conflicts.push_back(conflict);
+                        }
+
+                        if(grammar.is_variable_terminal[t]) {
+                            unsigned &cell(variable_terminal_productions[A]);
+                            if(NO_PRODUCTION == cell) {
+                                cell = p;
+                            } else if(p != cell) {
+                                cell = AMBIGUOUS_PRODUCTION;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for(unsigned t(1); t < grammar.num_terminals; ++t) {
+                if(grammar.is_variable_terminal[t]) {
+                    has_variable_terminals_ = true;
+                }
+            }
+
+            packed.pack(
+                dense,
+                grammar.num_variables,
+                num_columns,
+                static_cast<unsigned>(NO_PRODUCTION)
+            );
+        }
+
+        /// the production to use to expand the variable A on the lookahead
+        /// terminal a, or NO_PRODUCTION if there is none. if a is
+        /// UNKNOWN_TERMINAL then this can also be AMBIGUOUS_PRODUCTION.
+        inline unsigned production(const unsigned A, const unsigned a) const throw() {
+            if(UNKNOWN_TERMINAL == a) {
+                return variable_terminal_productions[A];
+            }
+            return packed.get(A, a);
+        }
+
+        /// can tokens that are not terminals of the grammar be matched?
+        inline bool has_variable_terminals(void) const throw() {
+            return has_variable_terminals_;
+        }
+
+        /// the number of entries in the packed table
+        inline unsigned num_entries(void) const throw() {
+            return packed.num_entries();
+        }
+
+        /// the packed table itself, e.g. to write it out as code
+        inline const fltl::helper::PackedTable &packed_table(void) const throw() {
+            return packed;
+        }
+
+    private:
+
+        static void add_set(
+            fltl::helper::BitSet &lookahead,
+            const fltl::helper::BitMatrix &sets,
+            const unsigned var
+        ) throw() {
+            if(var < sets.num_rows()) {
+                lookahead.union_with(sets.row(var), sets.num_words_per_row());
+            }
+        }
+    };
+}}
+
+#endif /* Grail_Plus_LL1_TABLE_HPP_ */
@@ -0,0 +1,178 @@
+/*
+ * LR0Automaton.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_LR0_AUTOMATON_HPP_
+#define Grail_Plus_LR0_AUTOMATON_HPP_
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+
+namespace grail { namespace cfg {
+
+    /// the LR(0) automaton of a compiled grammar. each state is a set of
+    /// item ids: its kernel items, followed by the items X --> . alpha that
+    /// the kernel items predict. state 0 is the closure of the augmented
+    /// start item START --> . S.
+    ///
+    /// the transitions of each state are sorted by symbol, so terminal
+    /// transitions (negative symbols) come before variable transitions.
+    template <typename AlphaT>
+    class LR0Automaton {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+
+        enum {
+            NO_STATE = 0xFFFFFFFFU
+        };
+
+        /// the items of state s are items[state_begin[s]] to
+        /// items[state_begin[s + 1]]; the first num_kernel_items[s] of them
+        /// are the kernel items.
+        std::vector<unsigned> state_begin;
+        std::vector<unsigned> items;
+        std::vector<unsigned> num_kernel_items;
+
+        /// the transitions of state s are transition_symbol[k] and
+        /// transition_target[k] for transition_begin[s] <= k <
+        /// transition_begin[s + 1].
+        std::vector<unsigned> transition_begin;
+        std::vector<symbol_id_type> transition_symbol;
+        std::vector<unsigned> transition_target;
+
+        explicit LR0Automaton(const grammar_type &grammar) throw() {
+            typedef std::map<std::vector<unsigned>, unsigned> state_map;
+            typedef std::map<symbol_id_type, std::vector<unsigned> > kernel_map;
+
+            state_begin.push_back(0U);
+            transition_begin.push_back(0U);
+
+            if(0 == grammar.num_items()) {
+                return;
+            }
+
+            state_map states;
+            std::vector<std::vector<unsigned> > kernels;
+            std::vector<unsigned> predicted_in(grammar.num_variables, NO_STATE);
+
+            kernels.push_back(std::vector<unsigned>(1U, grammar.start_item));
+            states.insert(std::make_pair(kernels.back(), 0U));
+
+            // states are numbered in the order that they are found, and
+            // their items and transitions are laid out in that order too
+            for(unsigned s(0); s < kernels.size(); ++s) {
+                const unsigned first_item(static_cast<unsigned>(items.size()));
+
+                items.insert(items.end(), kernels[s].begin(), kernels[s].end());
+                num_kernel_items.push_back(
+                    static_cast<unsigned>(kernels[s].size())
+                );
+
+                // closure
+                for(unsigned i(first_item); i < items.size(); ++i) {
+                    const symbol_id_type sym(grammar.item_symbol[items[i]]);
+                    if(0 >= sym) {
+                        continue;
+                    }
+
+                    const unsigned B(static_cast<unsigned>(sym));
+                    if(s == predicted_in[B]) {
+                        continue;
+                    }
+
+                    predicted_in[B] = s;
+                    for(unsigned p(grammar.prediction_begin[B]),
+                                 max_p(grammar.prediction_begin[B + 1U]);
+                        p < max_p;
+                        ++p) {
+                        items.push_back(grammar.predictions[p]);
+                    }
+                }
+
+                state_begin.push_back(static_cast<unsigned>(items.size()));
+
+                // group the items by the symbol after the dot; each group is
+                // the kernel of a successor state
+                kernel_map next_kernels;
+                for(unsigned i(first_item); i < items.size(); ++i) {
+                    const symbol_id_type sym(grammar.item_symbol[items[i]]);
+                    if(grammar_type::END_OF_PRODUCTION != sym) {
+                        next_kernels[sym].push_back(items[i] + 1U);
+                    }
+                }
+
+                for(typename kernel_map::iterator pos(next_kernels.begin());
+                    next_kernels.end() != pos;
+                    ++pos) {
+
+                    std::vector<unsigned> &kernel(pos->second);
+                    std::sort(kernel.begin(), kernel.end());
+                    kernel.erase(
+                        std::unique(kernel.begin(), kernel.end()),
+                        kernel.end()
+                    );
+
+                    typename state_map::iterator target(states.find(kernel));
+                    if(states.end() == target) {
+                        target = states.insert(std::make_pair(
+                            kernel,
+                            static_cast<unsigned>(kernels.size())
+                        )).first;
+                        kernels.push_back(kernel);
+                    }
+
+                    transition_symbol.push_back(pos->first);
+                    transition_target.push_back(target->second);
+                }
+
+                transition_begin.push_back(
+                    static_cast<unsigned>(transition_symbol.size())
+                );
+            }
+        }
+
+        /// the number of states
+        inline unsigned num_states(void) const throw() {
+            return static_cast<unsigned>(num_kernel_items.size());
+        }
+
+        /// the index of the transition of state s on symbol sym, or
+        /// NO_STATE if there is no such transition
+        unsigned find_transition(
+            const unsigned s,
+            const symbol_id_type sym
+        ) const throw() {
+            const symbol_id_type *all(&(transition_symbol[0]));
+            const symbol_id_type *begin(all + transition_begin[s]);
+            const symbol_id_type *end(all + transition_begin[s + 1U]);
+            const symbol_id_type *pos(std::lower_bound(begin, end, sym));
+
+            if(end == pos || sym != *pos) {
+                return NO_STATE;
+            }
+
+            return static_cast<unsigned>(pos - all);
+        }
+
+        /// the state reached from state s on symbol sym, or NO_STATE
+        unsigned next_state(const unsigned s, const symbol_id_type sym) const throw() {
+            const unsigned k(find_transition(s, sym));
+            if(NO_STATE == k) {
+                return NO_STATE;
+            }
+            return transition_target[k];
+        }
+    };
+}}
+
+#endif /* Grail_Plus_LR0_AUTOMATON_HPP_ */
@@ -0,0 +1,254 @@
+/*
+ * LR0EpsilonAutomaton.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_LR0_EPSILON_AUTOMATON_HPP_
+#define Grail_Plus_LR0_EPSILON_AUTOMATON_HPP_
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+
+namespace grail { namespace cfg {
+
+    /// the split epsilon-LR(0) automaton of a compiled grammar, as used by
+    /// the Earley parser of Aycock and Horspool. this differs from the
+    /// LR(0) automaton in two ways:
+    ///
+    ///   1) every state is closed under sliding the dot over nullable
+    ///      variables, i.e. if A --> alpha . B beta is in a state and B is
+    ///      nullable then so is A --> alpha B . beta.
+    ///
+    ///   2) the items X --> . gamma that the items of a state predict are
+    ///      kept apart in a non-kernel state, which is reached from the
+    ///      state by an epsilon transition. an Earley item made from a
+    ///      kernel state keeps the origin of the items that it advanced,
+    ///      whereas the items of a non-kernel state always start in the
+    ///      Earley set that predicted them.
+    ///
+    /// state 0 is the kernel state of START --> . S. as in the LR(0)
+    /// automaton, the transitions of each state are sorted by symbol.
+    template <typename AlphaT>
+    class LR0EpsilonAutomaton {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+
+        enum {
+            NO_STATE = 0xFFFFFFFFU
+        };
+
+        /// the items of state s are items[state_begin[s]] to
+        /// items[state_begin[s + 1]], sorted by item id.
+        std::vector<unsigned> state_begin;
+        std::vector<unsigned> items;
+
+        /// the transitions of state s are transition_symbol[k] and
+        /// transition_target[k] for transition_begin[s] <= k <
+        /// transition_begin[s + 1].
+        std::vector<unsigned> transition_begin;
+        std::vector<symbol_id_type> transition_symbol;
+        std::vector<unsigned> transition_target;
+
+        /// the non-kernel state predicted by each state, or NO_STATE if the
+        /// state predicts nothing that it doesn't already contain
+        std::vector<unsigned> epsilon_target;
+
+        /// the variables A of the complete items A --> alpha . of state s
+        /// are reduction_variable[reduction_begin[s]] to
+        /// reduction_variable[reduction_begin[s + 1]]. the fake start
+        /// variable is left out.
+        std::vector<unsigned> reduction_begin;
+        std::vector<unsigned> reduction_variable;
+
+        /// does the state contain the accept item START --> S . ?
+        std::vector<bool> is_accepting;
+
+        explicit LR0EpsilonAutomaton(const grammar_type &grammar) throw() {
+            typedef std::map<std::vector<unsigned>, unsigned> state_map;
+            typedef std::map<symbol_id_type, std::vector<unsigned> > kernel_map;
+
+            state_begin.push_back(0U);
+            transition_begin.push_back(0U);
+            reduction_begin.push_back(0U);
+
+            if(0 == grammar.num_items()) {
+                return;
+            }
+
+            state_map states;
+            std::vector<std::vector<unsigned> > state_items;
+            std::vector<unsigned> predicted_in(grammar.num_variables, NO_STATE);
+            std::vector<unsigned> reduced_in(grammar.num_variables, NO_STATE);
+            std::vector<unsigned> predicted;
+
+            std::vector<unsigned> start(1U, grammar.start_item);
+            close_over_nullables(grammar, start);
+            add_state(states, state_items, start);
+
+            // states are numbered in the order that they are found, and
+            // their items and transitions are laid out in that order too
+            for(unsigned s(0); s < state_items.size(); ++s) {
+                const std::vector<unsigned> curr(state_items[s]);
+
+                items.insert(items.end(), curr.begin(), curr.end());
+                state_begin.push_back(static_cast<unsigned>(items.size()));
+
+                // the variables predicted by the state, and everything
+                // that they predict in turn
+                predicted.clear();
+                for(unsigned i(0); i < curr.size(); ++i) {
+                    const symbol_id_type sym(grammar.item_symbol[curr[i]]);
+                    if(0 >= sym) {
+                        continue;
+                    }
+
+                    const unsigned B(static_cast<unsigned>(sym));
+                    for(unsigned c(grammar.closure_begin[B]),
+                                 max_c(grammar.closure_begin[B + 1U]);
+                        c < max_c;
+                        ++c) {
+
+                        const unsigned X(grammar.closure[c]);
+                        if(s == predicted_in[X]) {
+                            continue;
+                        }
+
+                        predicted_in[X] = s;
+                        for(unsigned p(grammar.prediction_begin[X]),
+                                     max_p(grammar.prediction_begin[X + 1U]);
+                            p < max_p;
+                            ++p) {
+                            predicted.push_back(grammar.predictions[p]);
+                        }
+                    }
+                }
+
+                close_over_nullables(grammar, predicted);
+
+                // non-kernel states are closed under prediction, so they
+                // contain everything that they predict
+                if(predicted.empty()
+                || std::includes(
+                    curr.begin(), curr.end(),
+                    predicted.begin(), predicted.end()
+                )) {
+                    epsilon_target.push_back(NO_STATE);
+                } else {
+                    epsilon_target.push_back(
+                        add_state(states, state_items, predicted)
+                    );
+                }
+
+                // group the items by the symbol after the dot; each group is
+                // the kernel of a successor state. complete items are
+                // reductions.
+                kernel_map next_kernels;
+                is_accepting.push_back(false);
+
+                for(unsigned i(0); i < curr.size(); ++i) {
+                    const symbol_id_type sym(grammar.item_symbol[curr[i]]);
+                    if(grammar_type::END_OF_PRODUCTION != sym) {
+                        next_kernels[sym].push_back(curr[i] + 1U);
+                        continue;
+                    }
+
+                    const unsigned A(grammar.item_variable[curr[i]]);
+                    if(grammar.accept_item == curr[i]) {
+                        is_accepting[s] = true;
+                    } else if(s != reduced_in[A]) {
+                        reduced_in[A] = s;
+                        reduction_variable.push_back(A);
+                    }
+                }
+
+                reduction_begin.push_back(
+                    static_cast<unsigned>(reduction_variable.size())
+                );
+
+                for(typename kernel_map::iterator pos(next_kernels.begin());
+                    next_kernels.end() != pos;
+                    ++pos) {
+
+                    close_over_nullables(grammar, pos->second);
+                    transition_symbol.push_back(pos->first);
+                    transition_target.push_back(
+                        add_state(states, state_items, pos->second)
+                    );
+                }
+
+                transition_begin.push_back(
+                    static_cast<unsigned>(transition_symbol.size())
+                );
+            }
+        }
+
+        /// the number of states
+        inline unsigned num_states(void) const throw() {
+            return static_cast<unsigned>(epsilon_target.size());
+        }
+
+        /// the state reached from state s on symbol sym, or NO_STATE
+        unsigned next_state(const unsigned s, const symbol_id_type sym) const throw() {
+            const symbol_id_type *all(&(transition_symbol[0]));
+            const symbol_id_type *begin(all + transition_begin[s]);
+            const symbol_id_type *end(all + transition_begin[s + 1U]);
+            const symbol_id_type *pos(std::lower_bound(begin, end, sym));
+
+            if(end == pos || sym != *pos) {
+                return NO_STATE;
+            }
+
+            return transition_target[static_cast<unsigned>(pos - all)];
+        }
+
+    private:
+
+        /// slide the dot over nullable variables until no new items are
+        /// found, then sort the items
+        static void close_over_nullables(
+            const grammar_type &grammar,
+            std::vector<unsigned> &set
+        ) throw() {
+            for(unsigned i(0); i < set.size(); ++i) {
+                const symbol_id_type sym(grammar.item_symbol[set[i]]);
+                if(0 < sym && grammar.is_nullable[static_cast<unsigned>(sym)]) {
+                    set.push_back(set[i] + 1U);
+                }
+            }
+
+            std::sort(set.begin(), set.end());
+            set.erase(std::unique(set.begin(), set.end()), set.end());
+        }
+
+        /// find the state with some items, adding it if it's new
+        static unsigned add_state(
+            std::map<std::vector<unsigned>, unsigned> &states,
+            std::vector<std::vector<unsigned> > &state_items,
+            const std::vector<unsigned> &set
+        ) throw() {
+            typename std::map<std::vector<unsigned>, unsigned>::iterator pos(
+                states.find(set)
+            );
+
+            if(states.end() != pos) {
+                return pos->second;
+            }
+
+            const unsigned s(static_cast<unsigned>(state_items.size()));
+            states.insert(std::make_pair(set, s));
+            state_items.push_back(set);
+            return s;
+        }
+    };
+}}
+
+#endif /* Grail_Plus_LR0_EPSILON_AUTOMATON_HPP_ */
@@ -0,0 +1,299 @@
+/*
+ * LookaheadSets.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+#ifndef Grail_Plus_LOOKAHEAD_SETS_HPP_
+#define Grail_Plus_LOOKAHEAD_SETS_HPP_
+
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/digraph.hpp"
+
+namespace grail { namespace cfg {
+
+    /// FIRST sets of a compiled grammar, laid out for filtering the
+    /// predictions of a parser. the lookahead is the same for every
+    /// prediction of an Earley set, so the sets are stored by terminal:
+    /// row a of a matrix is the set of variables that can begin with a. a
+    /// prediction of the variable B is then a single bit test on a row that
+    /// is shared by the whole Earley set.
+    ///
+    /// FIRST_2 sets can be very large (all pairs of terminals that can
+    /// begin a variable), so instead of storing them, the set of variables
+    /// whose FIRST_2 set contains a particular pair of terminals is found
+    /// on demand by first2().
+    template <typename AlphaT>
+    class LookaheadSets {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+        typedef bit_matrix_type::word_type word_type;
+
+        enum {
+            END_OF_INPUT = 0
+        };
+
+        /// row a is the set of variables that have a in their FIRST set
+        bit_matrix_type first;
+
+        /// row a is the set of variables that derive the one-token string a
+        bit_matrix_type single;
+
+    private:
+
+        const grammar_type *grammar;
+
+        /// for each symbol X, the items A --> alpha * X beta where alpha is
+        /// nullable. variable V is at index V, and terminal a is at index
+        /// num_variables + a.
+        std::vector<unsigned> occurrence_begin;
+        std::vector<unsigned> occurrences;
+
+    public:
+
+        LookaheadSets(
+            const grammar_type &grammar_,
+            const bit_matrix_type &first_terminals
+        ) throw()
+            : grammar(&grammar_)
+        {
+            const unsigned num_variables(grammar->num_variables);
+            const unsigned num_terminals(grammar->num_terminals);
+
+            first.resize(num_terminals, num_variables);
+            for(unsigned v(0); v < num_variables && v < first_terminals.num_rows(); ++v) {
+                const word_type *terms(first_terminals.row(v));
+                const unsigned num_words(first_terminals.num_words_per_row());
+
+                for(unsigned w(0); w < num_words; ++w) {
+                    for(word_type bits(terms[w]); 0UL != bits; bits &= bits - 1UL) {
+                        const unsigned t(
+                            w * bit_matrix_type::BITS_PER_WORD
+                          + bit_matrix_type::lowest_bit(bits)
+                        );
+
+                        if(0U < t && t < num_terminals) {
+                            first.set(t, v);
+                        }
+                    }
+                }
+            }
+
+            find_single_terminals();
+            find_occurrences();
+        }
+
+        /// the number of words in a row of variables
+        inline unsigned num_words(void) const throw() {
+            return first.num_words_per_row();
+        }
+
+        /// fill in a row with the variables that derive a non-empty string
+        /// that can begin the input a b ..., i.e. the variables whose
+        /// FIRST_2 set contains either a b or just a. b is END_OF_INPUT if a
+        /// is the last token of the input.
+        void first2(
+            const unsigned a,
+            const unsigned b,
+            word_type *row
+        ) const throw() {
+            const unsigned len(num_words());
+            const word_type *single_row(single.row(a));
+            std::vector<word_type> marked_words(len, 0UL);
+            word_type *marked(&(marked_words[0]));
+            std::vector<unsigned> work;
+
+            // a variable that derives just a can be followed by anything
+            for(unsigned i(0); i < len; ++i) {
+                row[i] = single_row[i];
+            }
+
+            if(END_OF_INPUT == b) {
+                return;
+            }
+
+            // find the productions where a (or a variable that derives just
+            // a) is followed by something that begins with b
+            find_pairs(grammar->num_variables + a, b, row, marked, work);
+            for(unsigned v(1); v < grammar->num_variables; ++v) {
+                if(bit_matrix_type::test(single_row, v)) {
+                    find_pairs(v, b, row, marked, work);
+                }
+            }
+
+            // if C begins with a b, then so does any A --> alpha C beta
+            // where alpha is nullable
+            for(; !work.empty(); ) {
+                const unsigned C(work.back());
+                work.pop_back();
+
+                for(unsigned i(occurrence_begin[C]);
+                    i < occurrence_begin[C + 1U];
+                    ++i) {
+                    add(grammar->item_variable[occurrences[i]], row, marked, work);
+                }
+            }
+        }
+
+    private:
+
+        void add(
+            const unsigned var,
+            word_type *row,
+            word_type *marked,
+            std::vector<unsigned> &work
+        ) const throw() {
+            if(!bit_matrix_type::test(marked, var)) {
+                bit_matrix_type::set(marked, var);
+                bit_matrix_type::set(row, var);
+                work.push_back(var);
+            }
+        }
+
+        /// add in the variables of the items A --> alpha * X beta where
+        /// beta begins with b
+        void find_pairs(
+            const unsigned symbol,
+            const unsigned b,
+            word_type *row,
+            word_type *marked,
+            std::vector<unsigned> &work
+        ) const throw() {
+            for(unsigned i(occurrence_begin[symbol]);
+                i < occurrence_begin[symbol + 1U];
+                ++i) {
+
+                const unsigned item(occurrences[i]);
+                if(begins_with(item + 1U, b)) {
+                    add(grammar->item_variable[item], row, marked, work);
+                }
+            }
+        }
+
+        /// check if the symbols from the dot of an item onward can derive a
+        /// string that begins with the terminal b
+        bool begins_with(unsigned item, const unsigned b) const throw() {
+            for(;; ++item) {
+                const symbol_id_type sym(grammar->item_symbol[item]);
+
+                if(grammar_type::END_OF_PRODUCTION == sym) {
+                    return false;
+                } else if(0 > sym) {
+                    return static_cast<unsigned>(-sym) == b;
+                } else if(first.test(b, static_cast<unsigned>(sym))) {
+                    return true;
+                } else if(!grammar->is_nullable[static_cast<unsigned>(sym)]) {
+                    return false;
+                }
+            }
+        }
+
+        /// find the variables that derive one-token strings. a production
+        /// derives a one-token string if one of its symbols does and all of
+        /// the others are nullable, so each variable is related to the
+        /// variables of its productions that can derive its one-token
+        /// strings, and the sets are found by the digraph algorithm.
+        void find_single_terminals(void) throw() {
+            const grammar_type &g(*grammar);
+            bit_matrix_type by_variable(g.num_variables, g.num_terminals);
+            std::vector<std::vector<unsigned> > relation(g.num_variables);
+
+            for(unsigned p(0); p < g.num_productions(); ++p) {
+                const unsigned A(g.item_variable[g.production_item[p]]);
+                const unsigned begin(g.production_item[p]);
+                const unsigned end(begin + g.production_length(p));
+                unsigned num_non_nullable(0);
+
+                for(unsigned item(begin); item < end; ++item) {
+                    const symbol_id_type sym(g.item_symbol[item]);
+                    if(0 > sym || !g.is_nullable[static_cast<unsigned>(sym)]) {
+                        ++num_non_nullable;
+                    }
+                }
+
+                if(1U < num_non_nullable) {
+                    continue;
+                }
+
+                for(unsigned item(begin); item < end; ++item) {
+                    const symbol_id_type sym(g.item_symbol[item]);
+
+                    if(0 > sym) {
+                        by_variable.set(A, static_cast<unsigned>(-sym));
+                    } else if(0 == num_non_nullable
+                           || !g.is_nullable[static_cast<unsigned>(sym)]) {
+                        relation[A].push_back(static_cast<unsigned>(sym));
+                    }
+                }
+            }
+
+            digraph(relation, by_variable);
+            by_variable.transpose_into(single);
+        }
+
+        /// index the items A --> alpha * X beta where alpha is nullable by
+        /// their symbol X
+        void find_occurrences(void) throw() {
+            const grammar_type &g(*grammar);
+            const unsigned num_slots(g.num_variables + g.num_terminals);
+
+            occurrence_begin.assign(num_slots + 1U, 0U);
+
+            for(unsigned pass(0); pass < 2U; ++pass) {
+                std::vector<unsigned> next_slot;
+
+                if(1U == pass) {
+                    for(unsigned s(1); s <= num_slots; ++s) {
+                        occurrence_begin[s] += occurrence_begin[s - 1U];
+                    }
+                    occurrences.assign(occurrence_begin[num_slots], 0U);
+                    next_slot.assign(
+                        occurrence_begin.begin(),
+                        occurrence_begin.end() - 1
+                    );
+                }
+
+                for(unsigned item(0); item < g.num_items(); ++item) {
+
+                    // only look at the start of each production
+                    if(0 != g.item_dot[item]) {
+                        continue;
+                    }
+
+                    for(unsigned curr(item);
+                        grammar_type::END_OF_PRODUCTION != g.item_symbol[curr];
+                        ++curr) {
+
+                        const symbol_id_type curr_sym(g.item_symbol[curr]);
+                        const unsigned slot(0 > curr_sym
+                            ? g.num_variables + static_cast<unsigned>(-curr_sym)
+                            : static_cast<unsigned>(curr_sym)
+                        );
+
+                        if(0U == pass) {
+                            ++(occurrence_begin[slot + 1U]);
+                        } else {
+                            occurrences[next_slot[slot]++] = curr;
+                        }
+
+                        if(0 > curr_sym
+                        || !g.is_nullable[static_cast<unsigned>(curr_sym)]) {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    };
+}}
+
+#endif /* Grail_Plus_LOOKAHEAD_SETS_HPP_ */
@@ -0,0 +1,174 @@
+/*
+ * ParseForest.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+#ifndef Grail_Plus_PARSE_FOREST_HPP_
+#define Grail_Plus_PARSE_FOREST_HPP_
+
+#include <cstring>
+#include <vector>
+
+#include "grail/include/cfg/CompiledGrammar.hpp"
+
+namespace grail { namespace cfg {
+
+    /// a shared packed parse forest (SPPF) over a compiled grammar. all
+    /// nodes and packed nodes live in two flat arrays and refer to each
+    /// other by index, so that building a forest costs a handful of
+    /// amortized vector pushes per node.
+    ///
+    /// there are three kinds of nodes:
+    ///     - symbol nodes, (A, i, j), meaning that the variable A derives
+    ///       tokens i through j - 1 of the input;
+    ///     - terminal nodes, (a, i, i + 1), meaning that token i was
+    ///       matched as the terminal a;
+    ///     - intermediate nodes, (A --> alpha * beta, i, j), meaning that
+    ///       alpha derives tokens i through j - 1. these binarize the
+    ///       productions, and are shared between all derivations that use
+    ///       the same prefix of a production over the same span.
+    ///
+    /// each symbol or intermediate node has one packed node for each way
+    /// that it can be derived. a packed node names the dotted item that it
+    /// derives and has a left child (the prefix of the item, which is
+    /// NO_NODE when the dot is at the first symbol) and a right child (the
+    /// symbol before the dot, which is NO_NODE for epsilon productions).
+    ///
+    /// spans of the input that are derived by nullable variables are only
+    /// given one derivation, chosen by the compiled grammar.
+    template <typename AlphaT>
+    class ParseForest {
+    public:
+
+        typedef CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+
+        enum {
+            NO_NODE = 0xFFFFFFFFU
+        };
+
+        class node_type {
+        public:
+
+            // the variable (positive) or terminal (negative) of this
+            // node, or 0 if this is an intermediate node
+            symbol_id_type symbol;
+
+            // for intermediate nodes, the dotted item whose prefix is
+            // derived by this node
+            unsigned item;
+
+            // the span [start, end) of tokens derived by this node
+            unsigned start;
+            unsigned end;
+
+            // the range of this node's packed nodes
+            unsigned first_packed;
+            unsigned num_packed;
+        };
+
+        class packed_node_type {
+        public:
+            unsigned item;
+            unsigned left;
+            unsigned right;
+        };
+
+        /// the grammar whose item and symbol numbers are used by this
+        /// forest
+        const grammar_type *grammar;
+
+        std::vector<node_type> nodes;
+        std::vector<packed_node_type> packed_nodes;
+
+        /// the node of the start variable that spans all of the input, or
+        /// NO_NODE if there is no forest
+        unsigned root;
+
+    private:
+
+        // the text of each token of the input, in one pool
+        std::vector<char> lexeme_data;
+        std::vector<unsigned> lexeme_offset;
+
+    public:
+
+        ParseForest(const grammar_type &grammar_) throw()
+            : grammar(&grammar_)
+            , root(NO_NODE)
+        { }
+
+        void clear(void) throw() {
+            nodes.clear();
+            packed_nodes.clear();
+            lexeme_data.clear();
+            lexeme_offset.clear();
+            root = NO_NODE;
+        }
+
+        inline bool is_empty(void) const throw() {
+            return NO_NODE == root;
+        }
+
+        inline unsigned num_nodes(void) const throw() {
+            return static_cast<unsigned>(nodes.size());
+        }
+
+        /// add a node with no packed nodes, and return its index
+        unsigned add_node(
+            const symbol_id_type symbol,
+            const unsigned item,
+            const unsigned start,
+            const unsigned end
+        ) throw() {
+            node_type node;
+            node.symbol = symbol;
+            node.item = item;
+            node.start = start;
+            node.end = end;
+            node.first_packed = 0;
+            node.num_packed = 0;
+            nodes.push_back(node);
+            return static_cast<unsigned>(nodes.size() - 1U);
+        }
+
+        /// add a packed node to a node. the packed nodes of a node must all
+        /// be added one after the other.
+        void add_packed(
+            const unsigned node,
+            const unsigned item,
+            const unsigned left,
+            const unsigned right
+        ) throw() {
+            packed_node_type packed;
+            packed.item = item;
+            packed.left = left;
+            packed.right = right;
+
+            if(0 == nodes[node].num_packed) {
+                nodes[node].first_packed = static_cast<unsigned>(
+                    packed_nodes.size()
+                );
+            }
+
+            ++(nodes[node].num_packed);
+            packed_nodes.push_back(packed);
+        }
+
+        /// save a copy of the text of the next token of the input
+        void add_lexeme(const char *token) throw() {
+            lexeme_offset.push_back(static_cast<unsigned>(lexeme_data.size()));
+            lexeme_data.insert(lexeme_data.end(), token, token + strlen(token) + 1U);
+        }
+
+        /// get the text of some token of the input
+        inline const char *lexeme(const unsigned pos) const throw() {
+            return &(lexeme_data[lexeme_offset[pos]]);
+        }
+    };
+}}
+
+#endif /* Grail_Plus_PARSE_FOREST_HPP_ */
@@ -0,0 +1,358 @@
+/*
+ * TerminalStringTrie.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_TERMINAL_STRING_TRIE_HPP_
+#define Grail_Plus_TERMINAL_STRING_TRIE_HPP_
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace grail { namespace cfg {
+
+    /// the strings of at most k terminals that make up FIRST_k and
+    /// FOLLOW_k sets. every string is stored once, as a node of a trie, and
+    /// is named by the number of its node; sets of strings are then sorted
+    /// vectors of node numbers. the string of one terminal a is a child of
+    /// the empty string, the string a b is a child of a, and so on.
+    ///
+    /// terminal 0 stands for the end of the input. a string is complete if
+    /// it has k terminals or ends with the end of the input; nothing can be
+    /// appended to a complete string.
+    class TerminalStringTrie {
+    public:
+
+        enum {
+            EMPTY_STRING = 0U,
+            END_OF_INPUT = 0U
+        };
+
+        /// a set of strings, as sorted node numbers
+        typedef std::vector<unsigned> string_set_type;
+
+    private:
+
+        /// an open-addressing hash table from pairs of numbers to numbers
+        class pair_map_type {
+        private:
+
+            enum {
+                NO_KEY = ~0U
+            };
+
+            std::vector<unsigned> first;
+            std::vector<unsigned> second;
+            std::vector<unsigned> values;
+            unsigned num_entries;
+
+            inline static unsigned hash(const unsigned a, const unsigned b) throw() {
+                return (a * 2654435761U) ^ (b * 2246822519U) ^ (b >> 15U);
+            }
+
+            /// the slot of a pair, or of the empty slot where it would go
+            unsigned find_slot(const unsigned a, const unsigned b) const throw() {
+                const unsigned mask(static_cast<unsigned>(first.size()) - 1U);
+                unsigned slot(hash(a, b) & mask);
+
+                for(; NO_KEY != first[slot]
+                   && (a != first[slot] || b != second[slot]);
+                    slot = (slot + 1U) & mask) {
+                    // linear probing
+                }
+
+                return slot;
+            }
+
+            void grow(void) throw() {
+                std::vector<unsigned> old_first;
+                std::vector<unsigned> old_second;
+                std::vector<unsigned> old_values;
+
+                old_first.swap(first);
+                old_second.swap(second);
+                old_values.swap(values);
+
+                const unsigned capacity(old_first.empty()
+                    ? 64U
+                    : static_cast<unsigned>(old_first.size()) * 2U
+                );
+
+                first.assign(capacity, NO_KEY);
+                second.assign(capacity, 0U);
+                values.assign(capacity, 0U);
+
+                for(unsigned i(0); i < old_first.size(); ++i) {
+                    if(NO_KEY != old_first[i]) {
+                        const unsigned slot(find_slot(old_first[i], old_second[i]));
+                        first[slot] = old_first[i];
+                        second[slot] = old_second[i];
+                        values[slot] = old_values[i];
+                    }
+                }
+            }
+
+        public:
+
+            pair_map_type(void) throw()
+                : first()
+                , second()
+                , values()
+                , num_entries(0)
+            {
+                grow();
+            }
+
+            /// look up the value of a pair; returns false if there is none
+            bool find(const unsigned a, const unsigned b, unsigned &value) const throw() {
+                const unsigned slot(find_slot(a, b));
+                if(NO_KEY == first[slot]) {
+                    return false;
+                }
+                value = values[slot];
+                return true;
+            }
+
+            void insert(const unsigned a, const unsigned b, const unsigned value) throw() {
+                if((num_entries + 1U) * 2U > first.size()) {
+                    grow();
+                }
+
+                const unsigned slot(find_slot(a, b));
+                if(NO_KEY == first[slot]) {
+                    ++num_entries;
+                }
+
+                first[slot] = a;
+                second[slot] = b;
+                values[slot] = value;
+            }
+        };
+
+        /// a fixed-size, direct-mapped cache from pairs of numbers to
+        /// numbers. a pair that collides with another pair replaces it, so
+        /// the cache never grows.
+        class pair_cache_type {
+        private:
+
+            enum {
+                NUM_SLOTS = 1U << 16U,
+                NO_KEY = ~0U
+            };
+
+            std::vector<unsigned> first;
+            std::vector<unsigned> second;
+            std::vector<unsigned> values;
+
+            inline static unsigned slot(const unsigned a, const unsigned b) throw() {
+                return ((a * 2654435761U) ^ (b * 2246822519U)) >> 16U;
+            }
+
+        public:
+
+            pair_cache_type(void) throw()
+                : first(static_cast<unsigned>(NUM_SLOTS), static_cast<unsigned>(NO_KEY))
+                , second(static_cast<unsigned>(NUM_SLOTS), 0U)
+                , values(static_cast<unsigned>(NUM_SLOTS), 0U)
+            { }
+
+            bool find(const unsigned a, const unsigned b, unsigned &value) const throw() {
+                const unsigned i(slot(a, b));
+                if(a != first[i] || b != second[i]) {
+                    return false;
+                }
+                value = values[i];
+                return true;
+            }
+
+            void insert(const unsigned a, const unsigned b, const unsigned value) throw() {
+                const unsigned i(slot(a, b));
+                first[i] = a;
+                second[i] = b;
+                values[i] = value;
+            }
+        };
+
+        const unsigned k;
+
+        // the string that each string extends by one terminal, that
+        // terminal, and the length of each string
+        std::vector<unsigned> parent;
+        std::vector<unsigned> last;
+        std::vector<unsigned> lengths;
+
+        // (string, terminal) to the string extended by that terminal
+        pair_map_type children;
+
+        // recently used (string, string) pairs and their k-truncated
+        // concatenations. the pairs of all strings that are ever
+        // concatenated can take far more memory than the strings, so only
+        // some are remembered.
+        pair_cache_type concatenations;
+
+    public:
+
+        explicit TerminalStringTrie(const unsigned k_) throw()
+            : k(k_)
+            , parent(1U, EMPTY_STRING)
+            , last(1U, END_OF_INPUT)
+            , lengths(1U, 0U)
+            , children()
+            , concatenations()
+        { }
+
+        /// the maximum length of a string
+        inline unsigned max_length(void) const throw() {
+            return k;
+        }
+
+        inline unsigned num_strings(void) const throw() {
+            return static_cast<unsigned>(parent.size());
+        }
+
+        inline unsigned length(const unsigned str) const throw() {
+            return lengths[str];
+        }
+
+        /// can nothing more be appended to a string?
+        inline bool is_complete(const unsigned str) const throw() {
+            return k <= lengths[str]
+                || (0U < lengths[str] && END_OF_INPUT == last[str]);
+        }
+
+        /// the string made by appending a terminal to an incomplete string
+        unsigned append(const unsigned str, const unsigned terminal) throw() {
+            unsigned child(0);
+            if(children.find(str, terminal, child)) {
+                return child;
+            }
+
+            child = static_cast<unsigned>(parent.size());
+            parent.push_back(str);
+            last.push_back(terminal);
+            lengths.push_back(lengths[str] + 1U);
+            children.insert(str, terminal, child);
+
+            return child;
+        }
+
+        /// the first k terminals of the concatenation of two strings
+        unsigned concat(const unsigned x, const unsigned y) throw() {
+            if(EMPTY_STRING == y || is_complete(x)) {
+                return x;
+            } else if(EMPTY_STRING == x) {
+                return y;
+            }
+
+            unsigned xy(0);
+            if(concatenations.find(x, y, xy)) {
+                return xy;
+            }
+
+            // x followed by all but the last terminal of y, and then the
+            // last terminal of y if there is still room for it
+            xy = concat(x, parent[y]);
+            if(!is_complete(xy)) {
+                xy = append(xy, last[y]);
+            }
+
+            concatenations.insert(x, y, xy);
+            return xy;
+        }
+
+        /// the terminals of a string, in order
+        void terminals(unsigned str, std::vector<unsigned> &out) const throw() {
+            out.assign(lengths[str], 0U);
+            for(unsigned i(lengths[str]); i-- > 0U; str = parent[str]) {
+                out[i] = last[str];
+            }
+        }
+
+        /// the set of the k-truncated concatenations of every string of xs
+        /// with every string of ys
+        void concat(
+            const string_set_type &xs,
+            const string_set_type &ys,
+            string_set_type &out
+        ) throw() {
+            out.clear();
+
+            for(unsigned i(0); i < xs.size(); ++i) {
+                if(is_complete(xs[i])) {
+                    out.push_back(xs[i]);
+                    continue;
+                }
+
+                for(unsigned j(0); j < ys.size(); ++j) {
+                    out.push_back(concat(xs[i], ys[j]));
+                }
+            }
+
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+
+        /// are all strings of a set complete?
+        bool is_complete(const string_set_type &xs) const throw() {
+            for(unsigned i(0); i < xs.size(); ++i) {
+                if(!is_complete(xs[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// remove the complete strings from a set
+        void remove_complete(string_set_type &xs) const throw() {
+            unsigned j(0);
+            for(unsigned i(0); i < xs.size(); ++i) {
+                if(!is_complete(xs[i])) {
+                    xs[j++] = xs[i];
+                }
+            }
+            xs.resize(j);
+        }
+
+        /// add the strings of one set to another; returns true if the
+        /// destination set changed. if added is given then the strings that
+        /// were not already in the destination set are put into it.
+        static bool union_into(
+            string_set_type &dest,
+            const string_set_type &source,
+            string_set_type *added
+        ) throw() {
+            string_set_type new_strings;
+            std::set_difference(
+                source.begin(), source.end(),
+                dest.begin(), dest.end(),
+                std::back_inserter(new_strings)
+            );
+
+            if(new_strings.empty()) {
+                return false;
+            }
+
+            string_set_type merged;
+            merged.reserve(dest.size() + new_strings.size());
+            std::merge(
+                dest.begin(), dest.end(),
+                new_strings.begin(), new_strings.end(),
+                std::back_inserter(merged)
+            );
+            dest.swap(merged);
+
+            if(0 != added) {
+                added->swap(new_strings);
+            }
+
+            return true;
+        }
+    };
+}}
+
+#endif /* Grail_Plus_TERMINAL_STRING_TRIE_HPP_ */
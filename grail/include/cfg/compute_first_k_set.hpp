@@ -0,0 +1,224 @@
+/*
+ * compute_first_k_set.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_COMPUTE_FIRST_K_SET_HPP_
+#define Grail_Plus_COMPUTE_FIRST_K_SET_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/TerminalStringTrie.hpp"
+
+namespace grail { namespace cfg {
+
+    namespace detail {
+
+        typedef TerminalStringTrie::string_set_type string_set_type;
+
+        /// concatenate the FIRST_k sets of the symbols begin to end - 1 onto
+        /// the end of each string of product. this stops early once every
+        /// string is complete, as the remaining symbols can't change them.
+        inline void first_k_product(
+            TerminalStringTrie &strings,
+            const std::vector<const string_set_type *> &symbol_sets,
+            const unsigned begin,
+            const unsigned end,
+            string_set_type &product
+        ) throw() {
+            string_set_type next;
+
+            for(unsigned i(begin); i < end; ++i) {
+                if(product.empty() || strings.is_complete(product)) {
+                    return;
+                }
+
+                strings.concat(product, *(symbol_sets[i]), next);
+                product.swap(next);
+            }
+        }
+
+        /// make the single-string FIRST_k set of every terminal
+        template <typename AlphaT>
+        void make_terminal_sets(
+            const fltl::CFG<AlphaT> &cfg,
+            TerminalStringTrie &strings,
+            std::vector<string_set_type> &terminal_sets
+        ) throw() {
+            terminal_sets.assign(cfg.num_terminals() + 2U, string_set_type());
+            for(unsigned t(0); t < terminal_sets.size(); ++t) {
+                terminal_sets[t].assign(
+                    1U,
+                    strings.append(TerminalStringTrie::EMPTY_STRING, t)
+                );
+            }
+        }
+    }
+
+    /// compute the FIRST_k set of every variable, i.e. the set of the
+    /// k-terminal prefixes of the strings that each variable generates, and
+    /// of the strings of fewer than k terminals that it generates. the
+    /// strings live in the trie, which fixes k; entry V of first is the
+    /// set of the variable V.
+    ///
+    /// every production is first evaluated once. after that, only the
+    /// strings that are new to the set of a variable B are pushed through
+    /// the occurrences of B: for A --> alpha B beta, the new strings of A
+    /// are the incomplete strings of FIRST_k(alpha), followed by the new
+    /// strings of B and by FIRST_k(beta). concatenation distributes over
+    /// union, so this finds the same sets as re-evaluating whole
+    /// productions, without repeatedly rebuilding large sets. an
+    /// incomplete concatenation only comes from incomplete strings, so the
+    /// incomplete strings of every set are also kept on their own.
+    template <typename AlphaT>
+    void compute_first_k_set(
+        const fltl::CFG<AlphaT> &cfg,
+        TerminalStringTrie &strings,
+        std::vector<TerminalStringTrie::string_set_type> &first
+    ) throw() {
+        FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
+
+        typedef TerminalStringTrie::string_set_type string_set_type;
+
+        const unsigned num_vars(cfg.num_variables_capacity() + 2U);
+
+        first.assign(num_vars, string_set_type());
+
+        std::vector<string_set_type> terminal_sets;
+        detail::make_terminal_sets(cfg, strings, terminal_sets);
+
+        std::vector<string_set_type> short_first(num_vars);
+        std::vector<string_set_type> short_terminal_sets(terminal_sets);
+        for(unsigned t(0); t < short_terminal_sets.size(); ++t) {
+            strings.remove_complete(short_terminal_sets[t]);
+        }
+
+        // the head of each production, the sets of its symbols and their
+        // incomplete strings, and the (production, position) pairs where
+        // each variable occurs
+        std::vector<unsigned> heads;
+        std::vector<std::vector<const string_set_type *> > bodies;
+        std::vector<std::vector<const string_set_type *> > short_bodies;
+        std::vector<std::vector<std::pair<unsigned, unsigned> > > occurrences(
+            num_vars
+        );
+
+        production_type prod;
+        symbol_string_type s;
+        generator_type productions(cfg.search(~prod));
+
+        for(; productions.match_next(); ) {
+            s = prod.symbols();
+
+            const unsigned P(static_cast<unsigned>(heads.size()));
+            heads.push_back(prod.variable().number());
+            bodies.push_back(std::vector<const string_set_type *>());
+            short_bodies.push_back(std::vector<const string_set_type *>());
+
+            std::vector<const string_set_type *> &body(bodies.back());
+            std::vector<const string_set_type *> &short_body(short_bodies.back());
+            body.reserve(s.length());
+            short_body.reserve(s.length());
+
+            for(unsigned i(0); i < s.length(); ++i) {
+                if(s.at(i).is_terminal()) {
+                    const unsigned t(terminal_type(s.at(i)).number());
+                    body.push_back(&(terminal_sets[t]));
+                    short_body.push_back(&(short_terminal_sets[t]));
+                } else {
+                    const unsigned V(variable_type(s.at(i)).number());
+                    body.push_back(&(first[V]));
+                    short_body.push_back(&(short_first[V]));
+                    occurrences[V].push_back(std::make_pair(P, i));
+                }
+            }
+        }
+
+        // the strings of each variable that have not yet been pushed
+        // through its occurrences
+        std::vector<string_set_type> pending(num_vars);
+        std::vector<unsigned> work_list;
+        std::vector<bool> in_work_list(num_vars, false);
+
+        string_set_type product;
+        string_set_type added;
+        string_set_type delta;
+
+        for(unsigned P(0); P < heads.size(); ++P) {
+            product.assign(1U, TerminalStringTrie::EMPTY_STRING);
+            detail::first_k_product(
+                strings,
+                bodies[P],
+                0U,
+                static_cast<unsigned>(bodies[P].size()),
+                product
+            );
+
+            const unsigned A(heads[P]);
+            if(TerminalStringTrie::union_into(first[A], product, &added)) {
+                TerminalStringTrie::union_into(pending[A], added, 0);
+                strings.remove_complete(added);
+                TerminalStringTrie::union_into(short_first[A], added, 0);
+                if(!in_work_list[A]) {
+                    in_work_list[A] = true;
+                    work_list.push_back(A);
+                }
+            }
+        }
+
+        for(; !work_list.empty(); ) {
+            const unsigned B(work_list.back());
+            work_list.pop_back();
+            in_work_list[B] = false;
+
+            delta.swap(pending[B]);
+            pending[B].clear();
+
+            for(unsigned j(0); j < occurrences[B].size(); ++j) {
+                const unsigned P(occurrences[B][j].first);
+                const unsigned i(occurrences[B][j].second);
+                const std::vector<const string_set_type *> &body(bodies[P]);
+
+                product.assign(1U, TerminalStringTrie::EMPTY_STRING);
+                detail::first_k_product(
+                    strings, short_bodies[P], 0U, i, product
+                );
+                strings.remove_complete(product);
+
+                if(product.empty()) {
+                    continue;
+                }
+
+                strings.concat(product, delta, added);
+                product.swap(added);
+                detail::first_k_product(
+                    strings,
+                    body,
+                    i + 1U,
+                    static_cast<unsigned>(body.size()),
+                    product
+                );
+
+                const unsigned A(heads[P]);
+                if(TerminalStringTrie::union_into(first[A], product, &added)) {
+                    TerminalStringTrie::union_into(pending[A], added, 0);
+                    strings.remove_complete(added);
+                    TerminalStringTrie::union_into(short_first[A], added, 0);
+                    if(!in_work_list[A]) {
+                        in_work_list[A] = true;
+                        work_list.push_back(A);
+                    }
+                }
+            }
+        }
+    }
+}}
+
+#endif /* Grail_Plus_COMPUTE_FIRST_K_SET_HPP_ */
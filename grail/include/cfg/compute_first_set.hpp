@@ -29,201 +29,109 @@
 #ifndef FLTL_COMPUTE_FIRST_SET_HPP_
 #define FLTL_COMPUTE_FIRST_SET_HPP_
 
-#include <cassert>
 #include <vector>
 
 #include "fltl/include/CFG.hpp"
 
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/digraph.hpp"
+
 namespace grail { namespace cfg {
 
     namespace detail {
 
-        template <typename T>
-        inline bool insert(std::vector<bool> *vec, T term) throw() {
-            std::vector<bool>::reference bit(vec->operator[](term.number()));
-            if(!bit) {
-                bit = true;
-                return true;
-            } else {
-                return false;
-            }
-        }
+        /// relate each variable A to the variables B such that
+        /// A --> alpha B beta and alpha is nullable, i.e. the variables
+        /// whose FIRST sets are part of the FIRST set of A. the variables B
+        /// are also added to the base sets if variables_into is given, and
+        /// the terminals t such that A --> alpha t beta are added to the
+        /// base sets if terminals_into is given.
+        template <typename AlphaT>
+        void relate_first(
+            const fltl::CFG<AlphaT> &cfg,
+            const std::vector<bool> &nullable,
+            std::vector<std::vector<unsigned> > &relation,
+            fltl::helper::BitMatrix *terminals_into,
+            fltl::helper::BitMatrix *variables_into
+        ) throw() {
+            FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
+
+            production_type prod;
+            generator_type productions(cfg.search(~prod));
+            symbol_string_type str;
+            variable_type W;
+
+            for(; productions.match_next(); ) {
+                str = prod.symbols();
+                const unsigned A(prod.variable().number());
 
-        bool union_into(std::vector<bool> *dest, const std::vector<bool> *sub) throw() {
-            if(0 == dest || 0 == sub) {
-                return false;
-            }
+                for(unsigned i(0); i < str.length(); ++i) {
 
-            assert(dest->size() == sub->size());
+                    // found a terminal, add it in; can't move past it
+                    if(str.at(i).is_terminal()) {
+                        if(0 != terminals_into) {
+                            terminals_into->set(
+                                A,
+                                terminal_type(str.at(i)).number()
+                            );
+                        }
+                        break;
+                    }
+
+                    // found a variable, relate it, try to move past it
+                    W = str.at(i);
+                    relation[A].push_back(W.number());
 
-            bool updated(false);
+                    if(0 != variables_into) {
+                        variables_into->set(A, W.number());
+                    }
 
-            for(size_t i(0), len(dest->size()); i < len; ++i) {
-                std::vector<bool>::reference ith(dest->operator[](i));
-                if(sub->operator[](i) && !ith) {
-                    ith = true;
-                    updated = true;
+                    if(!nullable[W.number()]) {
+                        break;
+                    }
                 }
             }
-
-            return updated;
         }
-
     }
 
-    /// compute the first sets of termianls for the variables of a CFG.
+    /// compute the first sets of terminals for the variables of a CFG. row
+    /// V of first is the FIRST set of the variable V, and column t is the
+    /// terminal t. the FIRST set of A is the union of the terminals that
+    /// directly begin its productions (after some nullable variables) and
+    /// of the FIRST sets of the variables that do, so all sets are found in
+    /// one pass of the digraph algorithm.
     template <typename AlphaT>
     void compute_first_terminals(
         const fltl::CFG<AlphaT> &cfg,
         const std::vector<bool> &nullable,
-        std::vector<std::vector<bool> *> &first
+        fltl::helper::BitMatrix &first
     ) throw() {
+        const unsigned num_vars(cfg.num_variables_capacity() + 2);
 
-        FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
-
-        typedef std::vector<bool> terminal_set_type;
-
-        first.assign(cfg.num_variables_capacity() + 2, 0);
-
-        // allocate the sets
-        variable_type V;
-        generator_type variables(cfg.search(~V));
-        for(; variables.match_next(); ) {
-            first[V.number()] = new std::vector<bool>(
-                cfg.num_terminals() + 2, false
-            );
-        }
-
-        // base case, all productions with a terminal as the first symbol on
-        // their RHS
-        terminal_type T;
-        generator_type first_subsets(cfg.search((~V) --->* ~T + cfg.__));
-        bool updated(false);
-        for(; first_subsets.match_next(); ) {
-            detail::insert(first[V.number()], T);
-            updated = true;
-        }
-
-        // induction step. note: base case won't necessarily yield anything
-        // if every production has a form like "A -> alpha t beta" where
-        // alpha is a sequence of one or more nullable variables and t is a
-        // terminal.
-        variable_type A;
-        variable_type reached;
-        production_type prod;
-        generator_type next_subsets(cfg.search(~prod, V --->* ~A + cfg.__));
-        terminal_set_type *curr_set(0);
-        terminal_set_type *reached_set(0);
-
-        updated = true;
-        for(; updated; ) {
-            updated = false;
-
-            for(variables.rewind(); variables.match_next(); ) {
-
-                curr_set = first[V.number()];
-
-                for(next_subsets.rewind(); next_subsets.match_next(); ) {
-
-                    for(unsigned i(0), len(prod.symbols().length());
-                        i < len;
-                        ++i) {
-
-                        // found a terminal, add it in; can't move past it
-                        if(prod.symbol_at(i).is_terminal()) {
-
-                            updated = detail::insert(
-                                curr_set,
-                                terminal_type(prod.symbol_at(i))
-                            ) || updated;
-
-                            break;
-
-                        // found a variable, union in, try to move past
-                        } else {
-                            reached = prod.symbol_at(i);
-                            reached_set = first[reached.number()];
-
-                            assert(0 != reached_set);
-
-                            updated = detail::union_into(
-                                curr_set,
-                                reached_set
-                            ) || updated;
+        std::vector<std::vector<unsigned> > relation(num_vars);
+        first.resize(num_vars, cfg.num_terminals() + 2);
 
-                            // can't move past
-                            if(!nullable[reached.number()]) {
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-        }
+        detail::relate_first(cfg, nullable, relation, &first, 0);
+        digraph(relation, first);
     }
 
-
-    /// compute the first sets of variables for the variables of a CFG.
+    /// compute the first sets of variables for the variables of a CFG. row
+    /// V of first is the set of variables that can begin a string derived
+    /// from V.
     template <typename AlphaT>
     void compute_first_variables(
         fltl::CFG<AlphaT> &cfg,
         const std::vector<bool> &nullable,
-        std::vector<std::vector<bool> *> &first
+        fltl::helper::BitMatrix &first
     ) throw() {
-
-        FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
-
-        typedef std::vector<bool> terminal_set_type;
-
         const unsigned num_vars(cfg.num_variables_capacity() + 2);
 
-        first.assign(num_vars, 0);
-
-        // allocate the sets
-        variable_type V, W;
-        generator_type variables(cfg.search(~V));
-        for(; variables.match_next(); ) {
-            first[V.number()] = new std::vector<bool>(num_vars, false);
-        }
-
-        production_type production;
-        generator_type productions(cfg.search(~production));
-
-        terminal_set_type *source_set(0);
-        terminal_set_type *reached_set(0);
-
-        symbol_string_type str;
-
-        bool updated(true);
-        for(; updated; ) {
-            updated = false;
+        std::vector<std::vector<unsigned> > relation(num_vars);
+        first.resize(num_vars, num_vars);
 
-            for(productions.rewind(); productions.match_next(); ) {
-
-                str = production.symbols();
-                V = production.variable();
-                source_set = first[V.number()];
-
-                for(unsigned i(0); i < str.length(); ++i) {
-
-                    // can't walk past a terminal
-                    if(str.at(i).is_terminal()) {
-                        break;
-                    }
-
-                    W = str.at(i);
-                    reached_set = first[W.number()];
-
-                    updated = detail::insert(source_set, W) || updated;
-                    updated = detail::union_into(source_set, reached_set) || updated;
-
-                    // can't walk past a non-nullable non-terminal
-                    if(!(nullable[W.number()])) {
-                        break;
-                    }
-                }
-            }
-        }
+        detail::relate_first(cfg, nullable, relation, 0, &first);
+        digraph(relation, first);
     }
 
 }}
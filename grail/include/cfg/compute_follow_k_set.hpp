@@ -0,0 +1,167 @@
+/*
+ * compute_follow_k_set.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_COMPUTE_FOLLOW_K_SET_HPP_
+#define Grail_Plus_COMPUTE_FOLLOW_K_SET_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/TerminalStringTrie.hpp"
+#include "grail/include/cfg/compute_first_k_set.hpp"
+
+namespace grail { namespace cfg {
+
+    /// compute the FOLLOW_k set of every variable from the FIRST_k sets
+    /// found by compute_first_k_set with the same trie. the strings of the
+    /// FOLLOW_k sets have k terminals or end with the end of the input.
+    ///
+    /// for every occurrence of a variable B in a production
+    /// A --> alpha B beta, FOLLOW_k(B) contains FIRST_k(beta) concatenated
+    /// with FOLLOW_k(A). FIRST_k(beta) is found once per occurrence. its
+    /// complete strings can't be changed by FOLLOW_k(A), so they go straight
+    /// into FOLLOW_k(B). if some strings are incomplete then the occurrence
+    /// is also an edge from A to B. only the strings that are new to
+    /// FOLLOW_k(A) are pushed along the edges out of A.
+    template <typename AlphaT>
+    void compute_follow_k_set(
+        const fltl::CFG<AlphaT> &cfg,
+        TerminalStringTrie &strings,
+        const std::vector<TerminalStringTrie::string_set_type> &first,
+        std::vector<TerminalStringTrie::string_set_type> &follow
+    ) throw() {
+        FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
+
+        typedef TerminalStringTrie::string_set_type string_set_type;
+
+        const unsigned num_vars(cfg.num_variables_capacity() + 2U);
+
+        follow.assign(num_vars, string_set_type());
+
+        if(!cfg.has_start_variable()) {
+            return;
+        }
+
+        std::vector<string_set_type> terminal_sets;
+        detail::make_terminal_sets(cfg, strings, terminal_sets);
+
+        // the start variable can be followed by the end of the input
+        follow[cfg.get_start_variable().number()] = terminal_sets[0];
+
+        // edges[A] holds the pairs (B, index of FIRST_k(beta) in tails)
+        std::vector<std::vector<std::pair<unsigned, unsigned> > > edges(num_vars);
+        std::vector<string_set_type> tails;
+
+        production_type prod;
+        symbol_string_type s;
+        generator_type productions(cfg.search(~prod));
+        std::vector<const string_set_type *> body;
+        string_set_type tail;
+        string_set_type complete;
+        string_set_type incomplete;
+
+        for(; productions.match_next(); ) {
+            s = prod.symbols();
+
+            body.clear();
+            for(unsigned i(0); i < s.length(); ++i) {
+                if(s.at(i).is_terminal()) {
+                    body.push_back(
+                        &(terminal_sets[terminal_type(s.at(i)).number()])
+                    );
+                } else {
+                    body.push_back(&(first[variable_type(s.at(i)).number()]));
+                }
+            }
+
+            const unsigned A(prod.variable().number());
+
+            for(unsigned i(0); i < s.length(); ++i) {
+                if(s.at(i).is_terminal()) {
+                    continue;
+                }
+
+                const unsigned B(variable_type(s.at(i)).number());
+
+                tail.assign(1U, TerminalStringTrie::EMPTY_STRING);
+                detail::first_k_product(
+                    strings,
+                    body,
+                    i + 1U,
+                    static_cast<unsigned>(body.size()),
+                    tail
+                );
+
+                complete.clear();
+                incomplete.clear();
+                for(unsigned j(0); j < tail.size(); ++j) {
+                    if(strings.is_complete(tail[j])) {
+                        complete.push_back(tail[j]);
+                    } else {
+                        incomplete.push_back(tail[j]);
+                    }
+                }
+
+                TerminalStringTrie::union_into(follow[B], complete, 0);
+
+                if(!incomplete.empty()) {
+                    edges[A].push_back(std::make_pair(
+                        B,
+                        static_cast<unsigned>(tails.size())
+                    ));
+                    tails.push_back(incomplete);
+                }
+            }
+        }
+
+        // the strings of each FOLLOW_k set that have not yet been pushed
+        // along the edges
+        std::vector<string_set_type> pending(follow);
+        std::vector<unsigned> work_list;
+        std::vector<bool> in_work_list(num_vars, false);
+
+        for(unsigned A(num_vars); A-- > 0U; ) {
+            if(!pending[A].empty()) {
+                in_work_list[A] = true;
+                work_list.push_back(A);
+            }
+        }
+
+        string_set_type delta;
+        string_set_type extended;
+        string_set_type added;
+
+        for(; !work_list.empty(); ) {
+            const unsigned A(work_list.back());
+            work_list.pop_back();
+            in_work_list[A] = false;
+
+            delta.swap(pending[A]);
+            pending[A].clear();
+
+            for(unsigned i(0); i < edges[A].size(); ++i) {
+                const unsigned B(edges[A][i].first);
+
+                strings.concat(tails[edges[A][i].second], delta, extended);
+
+                if(TerminalStringTrie::union_into(follow[B], extended, &added)) {
+                    TerminalStringTrie::union_into(pending[B], added, 0);
+                    if(!in_work_list[B]) {
+                        in_work_list[B] = true;
+                        work_list.push_back(B);
+                    }
+                }
+            }
+        }
+    }
+}}
+
+#endif /* Grail_Plus_COMPUTE_FOLLOW_K_SET_HPP_ */
@@ -9,72 +9,91 @@
 #ifndef Grail_Plus_COMPUTE_FOLLOW_SET_HPP_
 #define Grail_Plus_COMPUTE_FOLLOW_SET_HPP_
 
-#include <cassert>
 #include <vector>
 
 #include "fltl/include/CFG.hpp"
 
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/cfg/digraph.hpp"
+
 namespace grail { namespace cfg {
 
-    /// compute the follow sets for a CFG.
+    /// compute the follow sets for a CFG from the FIRST sets found by
+    /// compute_first_terminals. row V of follow is the FOLLOW set of the
+    /// variable V. column 0, which is not the number of any
+    /// terminal, stands for the end of the input.
+    ///
+    /// for every occurrence of a variable V in a production
+    /// A --> alpha V beta, FIRST(beta) is part of the base set of V, and
+    /// if beta is nullable then V is related to A, because FOLLOW(A) is
+    /// part of FOLLOW(V). all sets are then found in one pass of the
+    /// digraph algorithm.
     template <typename AlphaT>
     void compute_follow_set(
         const fltl::CFG<AlphaT> &cfg,
         const std::vector<bool> &nullable,
-        const std::vector<std::vector<bool> *> &first,
-        std::vector<std::vector<bool> *> &follow
+        const fltl::helper::BitMatrix &first,
+        fltl::helper::BitMatrix &follow
     ) throw() {
         FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
 
-        follow.assign(cfg.num_variables_capacity() + 2, 0);
+        const unsigned num_vars(cfg.num_variables_capacity() + 2U);
 
-        variable_type V;
-        variable_type A;
-        symbol_string_type s;
+        std::vector<std::vector<unsigned> > relation(num_vars);
+        follow.resize(num_vars, cfg.num_terminals() + 2U);
 
-        generator_type variables(cfg.search(~V));
-        generator_type syms_following_V(cfg.search((~A) --->* cfg.__ + V + ~s));
+        const unsigned num_words(follow.num_words_per_row());
 
-        // initialize each follow bitset as the empty set of the appropriate
-        // size.
-        for(; variables.match_next(); ) {
-            follow[V.number()] = new std::vector<bool>(cfg.num_terminals() + 2U, false);
+        if(!cfg.has_start_variable()) {
+            return;
         }
 
-        for(bool updated(true); updated; ) {
-            updated = false;
-
-            for(variables.rewind(); variables.match_next(); ) {
+        // the start variable can be followed by the end of the input
+        follow.set(cfg.get_start_variable().number(), 0U);
 
-                for(syms_following_V.rewind(); syms_following_V.match_next(); ) {
-                    for(unsigned i(0); i < s.length(); ++i) {
-                        if(s.at(i).is_terminal()) {
-                            terminal_type u(s.at(i));
-                            (*(follow[V.number()]))[u.number()] = true;
-                            goto next_production;
-                        }
+        production_type prod;
+        symbol_string_type s;
+        generator_type productions(cfg.search(~prod));
 
-                        variable_type U(s.at(i));
+        for(; productions.match_next(); ) {
+            s = prod.symbols();
 
-                        if(U == V) {
-                            continue;
-                        }
+            for(unsigned i(0); i < s.length(); ++i) {
+                if(s.at(i).is_terminal()) {
+                    continue;
+                }
 
-                        updated = detail::union_into(follow[V.number()], first[U.number()]) || updated;
+                const unsigned V(variable_type(s.at(i)).number());
 
-                        if(!nullable[U.number()]) {
-                            goto next_production;
-                        }
+                for(unsigned j(i + 1U); j < s.length(); ++j) {
+                    if(s.at(j).is_terminal()) {
+                        follow.set(V, terminal_type(s.at(j)).number());
+                        goto next_occurrence;
                     }
 
-                    // reached the end of the production
-                    updated = detail::union_into(follow[V.number()], first[A.number()]) || updated;
+                    variable_type U(s.at(j));
 
-                next_production:
-                    continue;
+                    fltl::helper::BitMatrix::or_into(
+                        follow.row(V),
+                        first.row(U.number()),
+                        num_words
+                    );
+
+                    if(!nullable[U.number()]) {
+                        goto next_occurrence;
+                    }
                 }
+
+                // reached the end of the production
+                relation[V].push_back(prod.variable().number());
+
+            next_occurrence:
+                continue;
             }
         }
+
+        digraph(relation, follow);
     }
 
 }}
@@ -35,7 +35,13 @@
 
 namespace grail { namespace cfg {
 
-    /// compute all nullable variables
+    /// compute all nullable variables. each production without terminals
+    /// counts the symbols of its right-hand side that are not yet known to
+    /// be nullable, and each variable lists the productions that it
+    /// appears in. when a variable is found to be nullable, the counters of
+    /// those productions go down, and a production whose counter reaches
+    /// zero makes its variable nullable. every symbol of the grammar is
+    /// looked at a constant number of times.
     template <typename AlphaT>
     void compute_null_set(
         const fltl::CFG<AlphaT> &cfg,
@@ -44,53 +50,64 @@ namespace grail { namespace cfg {
 
         FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
 
-        variable_type V;
-        variable_type Q;
+        const unsigned num_vars(cfg.num_variables_capacity() + 2);
 
-        nullable.assign(cfg.num_variables_capacity() + 2, false);
+        nullable.assign(num_vars, false);
 
-        // base case: directly nullable productions
-        generator_type null_prods(cfg.search((~V) --->* cfg.epsilon()));
-        for(; null_prods.match_next(); ) {
-            nullable[V.number()] = true;
-        }
-
-        if(nullable.empty()) {
-            return;
-        }
+        // the variable of each production, the number of symbols of the
+        // production that aren't known to be nullable, and the productions
+        // that each variable appears in, once per appearance
+        std::vector<unsigned> production_variable;
+        std::vector<unsigned> num_unknown;
+        std::vector<std::vector<unsigned> > occurrences(num_vars);
+        std::vector<unsigned> work;
 
-        bool found_nullable(true);
+        production_type prod;
         symbol_string_type str;
-        variable_type S;
-        generator_type productions(cfg.search((~V) --->* ~Q + ~str));
-        unsigned i(0);
-
-        // inductive step, build up the set of nullable variables
-        // incrementally
-        for(; found_nullable; productions.rewind()) {
-            found_nullable = false;
-            for(; productions.match_next(); ) {
-
-                // either this isn't a nullable production, or we know
-                // that this variable is nullable
-                if(nullable[V.number()] || !nullable[Q.number()]) {
-                    continue;
-                }
+        generator_type productions(cfg.search(~prod));
 
-                for(i = 0; i < str.length(); ++i) {
-                    if(str.at(i).is_terminal()) {
-                        break;
-                    }
+        for(; productions.match_next(); ) {
+            str = prod.symbols();
+            const unsigned V(prod.variable().number());
+            unsigned i(0);
 
-                    S = str.at(i);
-                    if(!nullable[S.number()]) {
-                        break;
-                    }
+            // a production with a terminal is never nullable
+            for(; i < str.length() && str.at(i).is_variable(); ++i) { }
+            if(i < str.length()) {
+                continue;
+            }
+
+            // base case: directly nullable productions
+            if(0 == str.length()) {
+                if(!nullable[V]) {
+                    nullable[V] = true;
+                    work.push_back(V);
                 }
+                continue;
+            }
+
+            const unsigned p(static_cast<unsigned>(num_unknown.size()));
+            production_variable.push_back(V);
+            num_unknown.push_back(str.length());
+
+            for(i = 0; i < str.length(); ++i) {
+                occurrences[variable_type(str.at(i)).number()].push_back(p);
+            }
+        }
+
+        // inductive step, each newly nullable variable brings the
+        // productions that it appears in closer to being nullable
+        for(; !work.empty(); ) {
+            const unsigned V(work.back());
+            work.pop_back();
+
+            for(unsigned i(0); i < occurrences[V].size(); ++i) {
+                const unsigned p(occurrences[V][i]);
+                const unsigned A(production_variable[p]);
 
-                if(str.length() == i) {
-                    nullable[V.number()] = true;
-                    found_nullable = true;
+                if(0U == --(num_unknown[p]) && !nullable[A]) {
+                    nullable[A] = true;
+                    work.push_back(A);
                 }
             }
         }
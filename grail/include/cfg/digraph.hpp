@@ -0,0 +1,132 @@
+/*
+ * digraph.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_DIGRAPH_HPP_
+#define Grail_Plus_DIGRAPH_HPP_
+
+#include <vector>
+
+#include "fltl/include/helper/BitMatrix.hpp"
+
+namespace grail { namespace cfg {
+
+    namespace detail {
+
+        /// a node of the digraph algorithm that is being visited
+        class digraph_frame_type {
+        public:
+            unsigned node;
+            unsigned edge;
+            unsigned depth;
+        };
+
+        /// the step of the digraph algorithm where x learns about y
+        inline void digraph_merge(
+            std::vector<unsigned> &depth,
+            fltl::helper::BitMatrix &sets,
+            const unsigned num_words,
+            const unsigned x,
+            const unsigned y
+        ) throw() {
+            if(depth[y] < depth[x]) {
+                depth[x] = depth[y];
+            }
+            fltl::helper::BitMatrix::or_into(sets.row(x), sets.row(y), num_words);
+        }
+    }
+
+    /// the digraph algorithm of DeRemer and Pennello. on entry, row x of
+    /// sets is the base set of node x; on exit, it is the union of the base
+    /// sets of all nodes reachable from x through the relation, including
+    /// x itself. the strongly connected components of the relation are
+    /// found as in Tarjan's algorithm, and all nodes of a component end up
+    /// with the same set, so every edge is followed once. a work list is
+    /// used instead of recursion.
+    inline void digraph(
+        const std::vector<std::vector<unsigned> > &relation,
+        fltl::helper::BitMatrix &sets
+    ) throw() {
+        const unsigned INFINITY_(~0U);
+        const unsigned num_nodes(static_cast<unsigned>(relation.size()));
+        const unsigned num_words(sets.num_words_per_row());
+
+        std::vector<unsigned> depth(num_nodes, 0U);
+        std::vector<unsigned> stack;
+        std::vector<detail::digraph_frame_type> frames;
+
+        for(unsigned root(0); root < num_nodes; ++root) {
+            if(0U != depth[root]) {
+                continue;
+            }
+
+            detail::digraph_frame_type frame;
+            frame.node = root;
+            frame.edge = 0U;
+            stack.push_back(root);
+            frame.depth = depth[root] = static_cast<unsigned>(stack.size());
+            frames.push_back(frame);
+
+            for(; !frames.empty(); ) {
+                detail::digraph_frame_type &curr(frames.back());
+                const unsigned x(curr.node);
+
+                // visit the next related node
+                if(curr.edge < relation[x].size()) {
+                    const unsigned y(relation[x][curr.edge++]);
+
+                    if(0U == depth[y]) {
+                        detail::digraph_frame_type next;
+                        next.node = y;
+                        next.edge = 0U;
+                        stack.push_back(y);
+                        next.depth = depth[y] = static_cast<unsigned>(
+                            stack.size()
+                        );
+                        frames.push_back(next);
+                    } else {
+                        detail::digraph_merge(depth, sets, num_words, x, y);
+                    }
+
+                    continue;
+                }
+
+                // done with x; if it is the root of a strongly connected
+                // component then all nodes of the component get its set
+                const unsigned x_depth(curr.depth);
+                frames.pop_back();
+
+                if(depth[x] == x_depth) {
+                    for(;;) {
+                        const unsigned top(stack.back());
+                        stack.pop_back();
+                        depth[top] = INFINITY_;
+
+                        if(top == x) {
+                            break;
+                        }
+
+                        fltl::helper::BitMatrix::or_into(
+                            sets.row(top),
+                            sets.row(x),
+                            num_words
+                        );
+                    }
+                }
+
+                if(!frames.empty()) {
+                    detail::digraph_merge(
+                        depth, sets, num_words, frames.back().node, x
+                    );
+                }
+            }
+        }
+    }
+}}
+
+#endif /* Grail_Plus_DIGRAPH_HPP_ */
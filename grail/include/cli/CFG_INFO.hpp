@@ -9,16 +9,28 @@
 #ifndef Grail_Plus_CFG_INFO_HPP_
 #define Grail_Plus_CFG_INFO_HPP_
 
+#include <algorithm>
+#include <cctype>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #include "fltl/include/CFG.hpp"
 
+#include "fltl/include/helper/BitMatrix.hpp"
+
 #include "grail/include/io/CommandLineOptions.hpp"
+#include "grail/include/io/fprint_cfg.hpp"
 #include "grail/include/io/fread_cfg.hpp"
+#include "grail/include/io/verbose.hpp"
 
+#include "grail/include/cfg/AnalysisCache.hpp"
+#include "grail/include/cfg/TerminalStringTrie.hpp"
 #include "grail/include/cfg/compute_first_set.hpp"
+#include "grail/include/cfg/compute_first_k_set.hpp"
 #include "grail/include/cfg/compute_null_set.hpp"
-#include "grail/include/cfg/compute_follow_set.hpp"
+#include "grail/include/cfg/compute_follow_k_set.hpp"
 
 namespace grail { namespace cli {
 
@@ -28,14 +40,17 @@ namespace grail { namespace cli {
 
         FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
 
+        typedef cfg::TerminalStringTrie::string_set_type string_set_type;
+
         static const char * const TOOL_NAME;
 
         static void declare(io::CommandLineOptions &opt, bool in_help) throw() {
             opt.declare("stats", io::opt::OPTIONAL, io::opt::NO_VAL);
-            opt.declare("first", io::opt::OPTIONAL, io::opt::NO_VAL);
-            opt.declare("follow", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("first", io::opt::OPTIONAL, io::opt::OPTIONAL_VAL);
+            opt.declare("follow", io::opt::OPTIONAL, io::opt::OPTIONAL_VAL);
             opt.declare("null", io::opt::OPTIONAL, io::opt::NO_VAL);
             opt.declare("lead", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("cache", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
             if(!in_help) {
                 opt.declare_min_num_positional(1);
                 opt.declare_max_num_positional(1);
@@ -51,19 +66,237 @@ namespace grail { namespace cli {
                 "    --stats                        print out the number of variables, terminals,\n"
                 "                                   variable terminals, and productions of the\n"
                 "                                   grammar.\n"
-                "    --first                        print out the FIRST set for every variable.\n"
-                "    --follow                       print out the FOLLOW set for every variable.\n"
+                "    --first[=k]                    print out the FIRST_k set for every variable,\n"
+                "                                   i.e. the strings of at most k terminals\n"
+                "                                   that begin the strings generated by the\n"
+                "                                   variable. k defaults to 1.\n"
+                "    --follow[=k]                   print out the FOLLOW_k set for every variable,\n"
+                "                                   i.e. the strings of at most k terminals\n"
+                "                                   that can follow the variable, where '$' is\n"
+                "                                   the end of the input. k defaults to 1.\n"
                 "    --null                         print out the set of NULL variables (i.e. the\n"
                 "                                   language generated by the variable contains\n"
                 "                                   the empty string.)\n"
                 "    --lead                         print ouf the LEAD set for every variable.\n"
+                "    --cache=<dir>                  keep the NULL, FIRST, and FOLLOW sets of\n"
+                "                                   the grammar in <dir>, keyed by a hash of\n"
+                "                                   the grammar, and reuse them on later runs.\n"
+                "                                   Only FIRST_1 and FOLLOW_1 are cached.\n"
                 "    <file>                         read in a CFG from <file>.\n\n",
                 TOOL_NAME, TOOL_NAME
             );
         }
 
+    private:
+
+        /// get the k of a --first or --follow option; returns 0 if the
+        /// value is not valid
+        static unsigned get_k(
+            io::CommandLineOptions &options,
+            io::option_type &opt
+        ) throw() {
+            if(!opt.has_value()) {
+                return 1U;
+            }
+
+            const char *value(opt.value());
+            char *end(0);
+            const unsigned long k(strtoul(value, &end, 10));
+
+            if(!isdigit(static_cast<unsigned char>(*value))
+            || '\0' != *end
+            || k != static_cast<unsigned>(k)) {
+                options.error(
+                    "The length of the strings in the FIRST and FOLLOW sets "
+                    "must be a positive integer, but '%s' was given.",
+                    value
+                );
+                options.note("Error was cause by this option:", opt);
+                return 0U;
+
+            } else if(0UL == k) {
+                options.error(
+                    "The length of the strings in the FIRST and FOLLOW sets "
+                    "must be at least 1."
+                );
+                options.note("Error was cause by this option:", opt);
+                return 0U;
+            }
+
+            return static_cast<unsigned>(k);
+        }
+
+        /// print a set of variables on one line
+        static void print_variables(
+            const cfg_type &cfg,
+            const std::vector<variable_type> &vars,
+            const char *prefix,
+            const fltl::helper::BitMatrix *matrix,
+            const unsigned row,
+            const std::vector<bool> *set
+        ) throw() {
+            const char *sep("");
+
+            printf("%s = {", prefix);
+            for(unsigned i(0); i < vars.size(); ++i) {
+                const unsigned V(vars[i].number());
+                if((0 != matrix && matrix->test(row, V))
+                || (0 != set && (*set)[V])) {
+                    printf("%s%s", sep, cfg.get_name(vars[i]));
+                    sep = ", ";
+                }
+            }
+            printf("}\n");
+        }
+
+        /// print out the FIRST_1 or FOLLOW_1 set of every variable from the
+        /// bit matrix of the sets, in the same form as for other k. the
+        /// nullable variables, if given, also have the empty string.
+        static void print_bit_sets(
+            const cfg_type &cfg,
+            const std::vector<variable_type> &vars,
+            const std::vector<terminal_type> &terminals,
+            const std::vector<bool> *nullable,
+            const fltl::helper::BitMatrix &sets,
+            const char *name
+        ) throw() {
+            for(unsigned i(0); i < vars.size(); ++i) {
+                const unsigned V(vars[i].number());
+                const char *sep("");
+
+                printf("%s_1(%s) = {", name, cfg.get_name(vars[i]));
+
+                if(0 != nullable && (*nullable)[V]) {
+                    printf("epsilon");
+                    sep = ", ";
+                }
+
+                for(unsigned t(0); t < sets.num_cols(); ++t) {
+                    if(!sets.test(V, t)) {
+                        continue;
+                    }
+
+                    printf("%s", sep);
+                    sep = ", ";
+
+                    if(cfg::TerminalStringTrie::END_OF_INPUT == t) {
+                        printf("$");
+                    } else {
+                        io::fprint(stdout, cfg, terminals[t]);
+                    }
+                }
+
+                printf("}\n");
+            }
+        }
+
+        /// print out the FIRST_k or FOLLOW_k set of every variable. the
+        /// strings of each set are sorted by their terminals.
+        static void print_string_sets(
+            const cfg_type &cfg,
+            const std::vector<variable_type> &vars,
+            const std::vector<terminal_type> &terminals,
+            const cfg::TerminalStringTrie &strings,
+            const std::vector<string_set_type> &sets,
+            const char *name
+        ) throw() {
+            std::vector<std::vector<unsigned> > sorted;
+
+            for(unsigned i(0); i < vars.size(); ++i) {
+                const string_set_type &set(sets[vars[i].number()]);
+
+                sorted.resize(set.size());
+                for(unsigned j(0); j < set.size(); ++j) {
+                    strings.terminals(set[j], sorted[j]);
+                }
+                std::sort(sorted.begin(), sorted.end());
+
+                printf(
+                    "%s_%u(%s) = {",
+                    name,
+                    strings.max_length(),
+                    cfg.get_name(vars[i])
+                );
+
+                for(unsigned j(0); j < sorted.size(); ++j) {
+                    if(0U < j) {
+                        printf(", ");
+                    }
+
+                    if(sorted[j].empty()) {
+                        printf("epsilon");
+                        continue;
+                    }
+
+                    for(unsigned t(0); t < sorted[j].size(); ++t) {
+                        if(0U < t) {
+                            printf(" ");
+                        }
+
+                        if(cfg::TerminalStringTrie::END_OF_INPUT == sorted[j][t]) {
+                            printf("$");
+                        } else {
+                            io::fprint(stdout, cfg, terminals[sorted[j][t]]);
+                        }
+                    }
+                }
+
+                printf("}\n");
+            }
+        }
+
+        /// compute and print out the FIRST_k and/or FOLLOW_k sets for one k
+        static void print_k_sets(
+            const cfg_type &cfg,
+            const std::vector<variable_type> &vars,
+            const std::vector<terminal_type> &terminals,
+            const unsigned k,
+            const bool print_first,
+            const bool print_follow
+        ) throw() {
+            cfg::TerminalStringTrie strings(k);
+            std::vector<string_set_type> first;
+
+            io::verbose("Computing FIRST_%u sets...\n", k);
+            cfg::compute_first_k_set(cfg, strings, first);
+
+            if(print_first) {
+                print_string_sets(cfg, vars, terminals, strings, first, "FIRST");
+            }
+
+            if(print_follow) {
+                std::vector<string_set_type> follow;
+
+                io::verbose("Computing FOLLOW_%u sets...\n", k);
+                cfg::compute_follow_k_set(cfg, strings, first, follow);
+                print_string_sets(cfg, vars, terminals, strings, follow, "FOLLOW");
+            }
+
+            io::verbose("Used %u distinct strings.\n", strings.num_strings());
+        }
+
+    public:
+
         static int main(io::CommandLineOptions &options) throw() {
 
+            io::option_type opt_stats(options["stats"]);
+            io::option_type opt_first(options["first"]);
+            io::option_type opt_follow(options["follow"]);
+            io::option_type opt_null(options["null"]);
+            io::option_type opt_lead(options["lead"]);
+            io::option_type opt_cache(options["cache"]);
+
+            unsigned first_k(0);
+            unsigned follow_k(0);
+
+            if(opt_first.is_valid() && 0U == (first_k = get_k(options, opt_first))) {
+                return 1;
+            }
+
+            if(opt_follow.is_valid() && 0U == (follow_k = get_k(options, opt_follow))) {
+                return 1;
+            }
+
             // run the tool
             io::option_type file(options[0U]);
             const char *file_name(file.value());
@@ -83,28 +316,86 @@ namespace grail { namespace cli {
 
             if(io::fread(fp, cfg, file_name)) {
 
-                io::option_type opt_stats(options["stats"]);
-                io::option_type opt_first(options["first"]);
-                io::option_type opt_follow(options["follow"]);
-                io::option_type opt_null(options["null"]);
-                io::option_type opt_lead(options["lead"]);
+                variable_type V;
+                terminal_type T;
+                std::vector<variable_type> vars;
+                std::vector<terminal_type> terminals(cfg.num_terminals() + 2U);
 
-                bool need_first(false);
-                bool need_follow(false);
-                bool need_null(false);
+                generator_type all_vars(cfg.search(~V));
+                for(; all_vars.match_next(); ) {
+                    vars.push_back(V);
+                }
 
-                if(opt_first.is_valid()) {
-                    need_first = need_null = true;
+                generator_type all_terminals(cfg.search(~T));
+                for(; all_terminals.match_next(); ) {
+                    terminals[T.number()] = T;
                 }
 
-                if(opt_follow.is_valid()) {
-                    need_first = need_follow = need_null = true;
+                if(opt_stats.is_valid()) {
+                    printf(
+                        "variables: %u\n"
+                        "terminals: %u\n"
+                        "variable terminals: %u\n"
+                        "productions: %u\n",
+                        cfg.num_variables(),
+                        cfg.num_terminals(),
+                        cfg.num_variable_terminals(),
+                        cfg.num_productions()
+                    );
+                }
+
+                // the NULL, FIRST_1, and FOLLOW_1 sets are found together
+                // with bit sets, so that they can be cached
+                std::vector<bool> nullable;
+                fltl::helper::BitMatrix first;
+                fltl::helper::BitMatrix follow;
+
+                if(opt_null.is_valid() || opt_lead.is_valid()
+                || 1U == first_k || 1U == follow_k) {
+                    const cfg::AnalysisCache cache(
+                        opt_cache.is_valid() ? opt_cache.value() : 0
+                    );
+                    cfg::compute_cached_sets(cfg, cache, nullable, first, follow);
                 }
 
                 if(opt_null.is_valid()) {
-                    need_null = true;
+                    print_variables(cfg, vars, "NULL", 0, 0U, &nullable);
                 }
 
+                if(opt_lead.is_valid()) {
+                    fltl::helper::BitMatrix lead;
+                    cfg::compute_first_variables(cfg, nullable, lead);
+
+                    for(unsigned i(0); i < vars.size(); ++i) {
+                        const char *name(cfg.get_name(vars[i]));
+                        std::vector<char> prefix(strlen(name) + 7U);
+                        sprintf(&(prefix[0]), "LEAD(%s)", name);
+                        print_variables(
+                            cfg, vars, &(prefix[0]), &lead, vars[i].number(), 0
+                        );
+                    }
+                }
+
+                if(1U == first_k) {
+                    print_bit_sets(cfg, vars, terminals, &nullable, first, "FIRST");
+                }
+
+                if(1U == follow_k) {
+                    print_bit_sets(cfg, vars, terminals, 0, follow, "FOLLOW");
+                }
+
+                // FOLLOW_k needs FIRST_k for the same k, so both sets are
+                // found together when the lengths agree
+                if(1U < first_k && first_k == follow_k) {
+                    print_k_sets(cfg, vars, terminals, first_k, true, true);
+                } else {
+                    if(1U < first_k) {
+                        print_k_sets(cfg, vars, terminals, first_k, true, false);
+                    }
+                    if(1U < follow_k) {
+                        print_k_sets(cfg, vars, terminals, follow_k, false, true);
+                    }
+                }
 
             } else {
                 ret = 1;
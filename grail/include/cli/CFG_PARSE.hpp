@@ -31,78 +31,1503 @@
 
 #include <set>
 #include <vector>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
 #include <cstring>
 
 #include "fltl/include/CFG.hpp"
 
 #include "fltl/include/helper/Array.hpp"
+#include "fltl/include/helper/BitMatrix.hpp"
+
+#include "grail/include/helper/PhaseTimer.hpp"
+#include "grail/include/helper/Thread.hpp"
 
 #include "grail/include/io/CommandLineOptions.hpp"
+#include "grail/include/io/error.hpp"
 #include "grail/include/io/fread_cfg.hpp"
+#include "grail/include/io/StatsPrinter.hpp"
+#include "grail/include/io/LocalSocket.hpp"
 #include "grail/include/io/verbose.hpp"
 #include "grail/include/io/UTF8FileTokBuffer.hpp"
 
-#include "grail/include/cfg/compute_null_set.hpp"
-#include "grail/include/cfg/compute_first_set.hpp"
-#include "grail/include/cfg/ParseTree.hpp"
+#include "grail/include/cfg/AnalysisCache.hpp"
+#include "grail/include/cfg/compute_null_set.hpp"
+#include "grail/include/cfg/compute_first_set.hpp"
+#include "grail/include/cfg/compute_follow_set.hpp"
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LookaheadSets.hpp"
+#include "grail/include/cfg/ParseForest.hpp"
+
+#include "grail/include/io/fprint_parse_tree.hpp"
+
+#include "grail/include/algorithm/CFG_TO_CNF.hpp"
+#include "grail/include/algorithm/CFG_PARSE_EARLEY.hpp"
+#include "grail/include/algorithm/CFG_PARSE_EARLEY_LR0.hpp"
+#include "grail/include/algorithm/CFG_PARSE_CYK.hpp"
+#include "grail/include/algorithm/CFG_PARSE_VALIANT.hpp"
+#include "grail/include/algorithm/CFG_PARSE_LL1.hpp"
+#include "grail/include/algorithm/CFG_PARSE_LALR.hpp"
+#include "grail/include/algorithm/CFG_PARSE_GLL.hpp"
+
+namespace grail { namespace cli {
+
+    template <typename AlphaT>
+    class CFG_PARSE {
+    public:
+
+        typedef fltl::CFG<AlphaT> CFG;
+        typedef typename CFG::terminal_type terminal_type;
+        typedef algorithm::CFG_PARSE_EARLEY<AlphaT, 1024U> parser_type;
+        typedef algorithm::CFG_PARSE_EARLEY_LR0<AlphaT, 1024U> lr0_parser_type;
+        typedef algorithm::CFG_PARSE_CYK<AlphaT, 1024U> cyk_parser_type;
+        typedef algorithm::CFG_PARSE_VALIANT<AlphaT, 1024U> valiant_parser_type;
+        typedef algorithm::CFG_PARSE_LL1<AlphaT, 1024U> ll1_parser_type;
+        typedef algorithm::CFG_PARSE_LALR<AlphaT, 1024U> lalr_parser_type;
+        typedef algorithm::CFG_PARSE_GLL<AlphaT, 1024U> gll_parser_type;
+
+        /// the parsing engines that can be selected with --engine
+        enum engine_type {
+            ENGINE_EARLEY,
+            ENGINE_EARLEY_LR0,
+            ENGINE_CYK,
+            ENGINE_VALIANT,
+            ENGINE_LL1,
+            ENGINE_LALR,
+            ENGINE_GLL,
+            ENGINE_UNKNOWN
+        };
+
+        static const char * const TOOL_NAME;
+
+        /// set once a signal asks the parse server to stop
+        static volatile sig_atomic_t stop_serving;
+
+        /// the socket on which the parse server accepts requests
+        static int serve_fd;
+
+        /// the token files to parse. these are either standard input, the
+        /// positional files that follow the grammar, or the files listed in
+        /// the file given to --batch. when there is more than one possible
+        /// input, each result is prefixed with the name of its file.
+        /// inputs can be parsed out of order by several threads; their
+        /// results are still printed in order.
+        class input_list_type {
+        private:
+
+            enum result_type {
+                RESULT_PENDING,
+                RESULT_ACCEPTED,
+                RESULT_REJECTED,
+                RESULT_SKIPPED
+            };
+
+            std::vector<char *> names;
+            std::vector<result_type> results;
+            const char *delim_chars;
+            unsigned next_result;
+            bool is_stdin;
+            bool is_batch;
+            bool had_error;
+            helper::Mutex mutex;
+
+            /// print out the results that are ready, up to the first input
+            /// that has not been parsed yet; the mutex must be locked
+            void flush(void) throw() {
+                for(; next_result < results.size(); ++next_result) {
+                    const result_type result(results[next_result]);
+                    if(RESULT_PENDING == result) {
+                        break;
+                    } else if(RESULT_SKIPPED == result) {
+                        continue;
+                    }
+
+                    if(is_batch) {
+                        printf("%s: ", names[next_result]);
+                    }
+
+                    if(RESULT_ACCEPTED == result) {
+                        printf("Yes.\n");
+                    } else {
+                        printf("No.\n");
+                    }
+                }
+            }
+
+        public:
+
+            input_list_type(const char *delim_chars_) throw()
+                : names()
+                , results()
+                , delim_chars(delim_chars_)
+                , next_result(0U)
+                , is_stdin(false)
+                , is_batch(false)
+                , had_error(false)
+                , mutex()
+            { }
+
+            ~input_list_type(void) throw() {
+                for(unsigned i(0); i < names.size(); ++i) {
+                    delete [] names[i];
+                    names[i] = 0;
+                }
+            }
+
+            /// read the tokens from standard input
+            void add_stdin(void) throw() {
+                add_file("<stdin>");
+                is_stdin = true;
+            }
+
+            /// parse the tokens in the file with this name. the name is
+            /// copied.
+            void add_file(const char *name) throw() {
+                char *copy(new char[strlen(name) + 1U]);
+                strcpy(copy, name);
+                names.push_back(copy);
+                results.push_back(RESULT_PENDING);
+                is_batch = is_batch || 1U < names.size();
+            }
+
+            /// add every file listed, one per line, in a batch file. returns
+            /// false if the batch file cannot be read.
+            bool add_batch(const char *batch_name) throw() {
+                FILE *fp(fopen(batch_name, "r"));
+                if(0 == fp) {
+                    return false;
+                }
+
+                io::UTF8FileTokBuffer<1024U> list(fp);
+                list.reset();
+
+                for(const char *name(list.read());
+                    '\0' != *name;
+                    name = list.read()) {
+                    add_file(name);
+                }
+
+                fclose(fp);
+                is_batch = true;
+                return true;
+            }
+
+            /// the number of inputs
+            unsigned size(void) const throw() {
+                return static_cast<unsigned>(names.size());
+            }
+
+            /// the delimiters that separate tokens in each input
+            const char *delimiters(void) const throw() {
+                return delim_chars;
+            }
+
+            /// open the ith input. if it cannot be opened then this reports
+            /// an error, skips the input, and returns null.
+            FILE *open(const unsigned i) throw() {
+                if(is_stdin) {
+                    return stdin;
+                }
+
+                FILE *fp(fopen(names[i], "r"));
+                if(0 != fp) {
+                    return fp;
+                }
+
+                io::error(
+                    "Unable to open file '%s' containing tokens to be "
+                    "parsed.",
+                    names[i]
+                );
+                skip(i);
+
+                return 0;
+            }
+
+            /// the name of the ith input
+            const char *name(const unsigned i) const throw() {
+                return names[i];
+            }
+
+            /// skip the ith input because it could not be parsed; the
+            /// reason must already have been reported
+            void skip(const unsigned i) throw() {
+                mutex.lock();
+                had_error = true;
+                results[i] = RESULT_SKIPPED;
+                flush();
+                mutex.unlock();
+            }
+
+            /// close an input that was opened with open
+            void close(FILE *fp) throw() {
+                if(stdin != fp) {
+                    fclose(fp);
+                }
+            }
+
+            /// record whether or not the ith input was accepted, and print
+            /// out all results that are now ready
+            void report(const unsigned i, const bool accepted) throw() {
+                mutex.lock();
+                results[i] = accepted ? RESULT_ACCEPTED : RESULT_REJECTED;
+                flush();
+                mutex.unlock();
+            }
+
+            /// the exit code of the tool, given that parsing went ahead
+            int exit_code(void) const throw() {
+                return had_error ? 1 : 0;
+            }
+        };
+
+        typedef io::UTF8FileTokBuffer<1024U> reader_type;
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+
+        /// the parts common to all jobs. a job parses single inputs using
+        /// one engine and the tables that the engine built for the grammar.
+        /// jobs are shared by all worker threads, so parsing must only read
+        /// from them; each worker has its own counters.
+        class job_base_type {
+        public:
+
+            /// print out anything extra after an input has been reported;
+            /// only called when inputs are parsed one at a time
+            void print(const bool) const throw() { }
+        };
+
+        class earley_job_type : public job_base_type {
+        public:
+
+            typedef typename parser_type::stats_type stats_type;
+
+            const CFG &cfg;
+            const grammar_type &grammar;
+            const typename parser_type::lookahead_sets_type *lookahead_sets;
+            unsigned lookahead;
+            bool use_leo;
+            bool print_tree;
+            bool print_forest;
+            bool print_dot;
+            typename parser_type::forest_type *forest;
+
+            earley_job_type(
+                const CFG &cfg_,
+                const grammar_type &grammar_
+            ) throw()
+                : cfg(cfg_)
+                , grammar(grammar_)
+                , lookahead_sets(0)
+                , lookahead(1U)
+                , use_leo(false)
+                , print_tree(false)
+                , print_forest(false)
+                , print_dot(false)
+                , forest(0)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                return parser_type::run(
+                    cfg,
+                    grammar,
+                    lookahead_sets,
+                    lookahead,
+                    use_leo,
+                    reader,
+                    stats,
+                    forest
+                );
+            }
+
+            void print(const bool accepted) const throw() {
+                if(!accepted) {
+                    return;
+                }
+
+                if(print_tree) {
+                    io::fprint(stdout, cfg, *forest, io::lisp_language());
+                }
+
+                if(print_forest) {
+                    if(print_dot) {
+                        io::fprint(stdout, cfg, *forest, io::dot_language());
+                    } else {
+                        io::fprint(stdout, cfg, *forest, io::tree_language());
+                    }
+                }
+            }
+        };
+
+        /// prints out the prefixes of a stream that are sentences
+        class prefix_printer_type {
+        public:
+            void accept_prefix(const unsigned num_tokens) throw() {
+                printf("Prefix of %u tokens accepted.\n", num_tokens);
+                fflush(stdout);
+            }
+        };
+
+        class earley_lr0_job_type : public job_base_type {
+        public:
+
+            typedef typename lr0_parser_type::stats_type stats_type;
+
+            const CFG &cfg;
+            const grammar_type &grammar;
+            const typename lr0_parser_type::automaton_type &automaton;
+            const bool stream;
+
+            earley_lr0_job_type(
+                const CFG &cfg_,
+                const grammar_type &grammar_,
+                const typename lr0_parser_type::automaton_type &automaton_,
+                const bool stream_
+            ) throw()
+                : cfg(cfg_)
+                , grammar(grammar_)
+                , automaton(automaton_)
+                , stream(stream_)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                if(stream) {
+                    prefix_printer_type printer;
+                    return lr0_parser_type::run_stream(
+                        cfg,
+                        grammar,
+                        automaton,
+                        reader,
+                        stats,
+                        printer
+                    );
+                }
+
+                return lr0_parser_type::run(
+                    cfg,
+                    grammar,
+                    automaton,
+                    reader,
+                    stats
+                );
+            }
+        };
+
+        class cyk_job_type : public job_base_type {
+        public:
+
+            typedef typename cyk_parser_type::stats_type stats_type;
+
+            const grammar_type &grammar;
+            const typename cyk_parser_type::tables_type &tables;
+            const unsigned num_threads;
+
+            cyk_job_type(
+                const grammar_type &grammar_,
+                const typename cyk_parser_type::tables_type &tables_,
+                const unsigned num_threads_
+            ) throw()
+                : grammar(grammar_)
+                , tables(tables_)
+                , num_threads(num_threads_)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                return cyk_parser_type::run(
+                    grammar,
+                    tables,
+                    num_threads,
+                    reader,
+                    stats
+                );
+            }
+        };
+
+        class valiant_job_type : public job_base_type {
+        public:
+
+            typedef typename valiant_parser_type::stats_type stats_type;
+
+            const grammar_type &grammar;
+            const typename valiant_parser_type::tables_type &tables;
+            const unsigned num_threads;
+
+            valiant_job_type(
+                const grammar_type &grammar_,
+                const typename valiant_parser_type::tables_type &tables_,
+                const unsigned num_threads_
+            ) throw()
+                : grammar(grammar_)
+                , tables(tables_)
+                , num_threads(num_threads_)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                return valiant_parser_type::run(
+                    grammar,
+                    tables,
+                    num_threads,
+                    reader,
+                    stats
+                );
+            }
+        };
+
+        class ll1_job_type : public job_base_type {
+        public:
+
+            typedef typename ll1_parser_type::stats_type stats_type;
+
+            const grammar_type &grammar;
+            const typename ll1_parser_type::table_type &table;
+
+            ll1_job_type(
+                const grammar_type &grammar_,
+                const typename ll1_parser_type::table_type &table_
+            ) throw()
+                : grammar(grammar_)
+                , table(table_)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                return ll1_parser_type::run(grammar, table, reader, stats);
+            }
+        };
+
+        class lalr_job_type : public job_base_type {
+        public:
+
+            typedef typename lalr_parser_type::stats_type stats_type;
+
+            const grammar_type &grammar;
+            const typename lalr_parser_type::table_type &table;
+
+            lalr_job_type(
+                const grammar_type &grammar_,
+                const typename lalr_parser_type::table_type &table_
+            ) throw()
+                : grammar(grammar_)
+                , table(table_)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                return lalr_parser_type::run(grammar, table, reader, stats);
+            }
+        };
+
+        class gll_job_type : public job_base_type {
+        public:
+
+            typedef typename gll_parser_type::stats_type stats_type;
+
+            const CFG &cfg;
+            const grammar_type &grammar;
+            const typename gll_parser_type::tables_type &tables;
+
+            gll_job_type(
+                const CFG &cfg_,
+                const grammar_type &grammar_,
+                const typename gll_parser_type::tables_type &tables_
+            ) throw()
+                : cfg(cfg_)
+                , grammar(grammar_)
+                , tables(tables_)
+            { }
+
+            bool parse(reader_type &reader, stats_type &stats) const throw() {
+                return gll_parser_type::run(
+                    cfg,
+                    grammar,
+                    tables,
+                    reader,
+                    stats
+                );
+            }
+        };
+
+        /// a thread that parses inputs handed out by a task pool
+        template <typename JobT>
+        class worker_type {
+        public:
+
+            const JobT *job;
+            input_list_type *inputs;
+            helper::TaskPool *pool;
+            unsigned id;
+            typename JobT::stats_type stats;
+
+            worker_type(void) throw()
+                : job(0)
+                , inputs(0)
+                , pool(0)
+                , id(0)
+                , stats()
+            { }
+
+            static void run(void *self_) throw() {
+                worker_type<JobT> *self(
+                    reinterpret_cast<worker_type<JobT> *>(self_)
+                );
+
+                for(unsigned i(0); self->pool->next(self->id, i); ) {
+                    parse_input(*(self->job), *(self->inputs), i, self->stats);
+                }
+            }
+        };
+
+        /// runs a job, once the tables of a grammar are built, over the
+        /// token files given on the command line
+        class batch_runner_type {
+        public:
+
+            io::CommandLineOptions &options;
+            input_list_type &inputs;
+            helper::PhaseTimer timer;
+
+            batch_runner_type(
+                io::CommandLineOptions &options_,
+                input_list_type &inputs_
+            ) throw()
+                : options(options_)
+                , inputs(inputs_)
+                , timer()
+            { }
+
+            template <typename JobT>
+            int operator()(const JobT &job) throw() {
+                return parse_inputs(options, inputs, job, timer);
+            }
+        };
+
+        /// the grammars served by --serve. each grammar is read in and its
+        /// tables are built by the same code that parses token files, so
+        /// the grammars are loaded one inside the other: a job is only
+        /// handed to the server once the jobs of all earlier grammars exist,
+        /// and all of them stay alive until the server stops.
+        class server_type {
+        public:
+
+            io::CommandLineOptions &options;
+            const engine_type engine;
+            const char *delim_chars;
+            std::vector<const void *> jobs;
+            std::vector<char *> names;
+            helper::PhaseTimer timer;
+
+            server_type(
+                io::CommandLineOptions &options_,
+                const engine_type engine_,
+                const char *delim_chars_
+            ) throw()
+                : options(options_)
+                , engine(engine_)
+                , delim_chars(delim_chars_)
+                , jobs()
+                , names()
+                , timer()
+            { }
+
+            ~server_type(void) throw() {
+                for(unsigned i(0); i < names.size(); ++i) {
+                    delete [] names[i];
+                    names[i] = 0;
+                }
+            }
+
+            /// read in the next grammar and build its tables
+            int load_next(void) throw() {
+                const unsigned i(static_cast<unsigned>(jobs.size()));
+                io::option_type file(options[i]);
+
+                CFG cfg;
+                timer.start("load");
+                if(!read_grammar(options, i, cfg)) {
+                    return 1;
+                }
+
+                char *copy(new char[strlen(file.value()) + 1U]);
+                strcpy(copy, file.value());
+                names.push_back(copy);
+
+                io::verbose("Loaded grammar #%u from '%s'.\n", i, copy);
+
+                return parse_with_engine(engine, options, cfg, *this);
+            }
+
+            /// find the job of a grammar, given either the name of its file,
+            /// with or without its directory, or its position on the
+            /// command line. returns null if there is no such grammar.
+            const void *find(const char *id) const throw() {
+                for(unsigned i(0); i < names.size(); ++i) {
+                    const char *base(strrchr(names[i], '/'));
+                    if(0 == strcmp(id, names[i])
+                    || (0 != base && 0 == strcmp(id, base + 1))) {
+                        return jobs[i];
+                    }
+                }
+
+                if('\0' == *id || '\0' != id[strspn(id, "0123456789")]) {
+                    return 0;
+                }
+
+                const unsigned long i(strtoul(id, 0, 10));
+                return i < jobs.size() ? jobs[i] : 0;
+            }
+
+            template <typename JobT>
+            int operator()(const JobT &job) throw() {
+                jobs.push_back(&job);
+
+                if(options[static_cast<unsigned>(jobs.size())].is_valid()) {
+                    return load_next();
+                }
+
+                return serve(*this, job);
+            }
+        };
+
+        /// a thread that answers parse requests sent to the server. all
+        /// workers block in accept on the same socket, so each connection
+        /// is answered by whichever worker is idle.
+        template <typename JobT>
+        class server_worker_type {
+        public:
+
+            const server_type *server;
+            typename JobT::stats_type stats;
+
+            server_worker_type(void) throw()
+                : server(0)
+                , stats()
+            { }
+
+            /// send a line back to the client
+            static void respond(const int fd, const char *line) throw() {
+                io::write_all(fd, line, strlen(line));
+            }
+
+            /// answer one request. a request is the id of a grammar on its
+            /// own line, followed by the tokens to parse, followed by the
+            /// end of the client's side of the connection.
+            void answer(const int fd) throw() {
+                FILE *fp(fdopen(fd, "r"));
+                if(0 == fp) {
+                    close(fd);
+                    return;
+                }
+
+                char id[1024];
+                if(0 == fgets(id, sizeof id, fp)) {
+                    respond(fd, "Missing grammar id.\n");
+                    fclose(fp);
+                    return;
+                }
+
+                id[strcspn(id, "\r\n")] = '\0';
+
+                const JobT *job(reinterpret_cast<const JobT *>(
+                    server->find(id)
+                ));
+
+                if(0 == job) {
+                    respond(fd, "Unknown grammar '");
+                    respond(fd, id);
+                    respond(fd, "'.\n");
+                } else {
+                    reader_type reader(fp, server->delim_chars);
+                    reader.reset();
+                    respond(fd, job->parse(reader, stats) ? "Yes.\n" : "No.\n");
+                }
+
+                fclose(fp);
+            }
+
+            static void run(void *self_) throw() {
+                server_worker_type<JobT> *self(
+                    reinterpret_cast<server_worker_type<JobT> *>(self_)
+                );
+
+                for(;;) {
+                    const int fd(accept(serve_fd, 0, 0));
+
+                    if(0 != stop_serving) {
+                        if(0 <= fd) {
+                            close(fd);
+                        }
+                        return;
+                    } else if(0 <= fd) {
+                        self->answer(fd);
+                    } else if(EINTR != errno && ECONNABORTED != errno) {
+                        io::verbose("Unable to accept connection.\n");
+                        return;
+                    }
+                }
+            }
+        };
+
+        static void declare(io::CommandLineOptions &opt, bool in_help) throw() {
+
+            opt.declare("engine", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+            opt.declare("threads", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+            opt.declare("jobs", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+            opt.declare("predict", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("lookahead", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+            opt.declare("cache", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+            opt.declare("stats", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("stats-json", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("leo", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("stream", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("tree", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("forest", io::opt::OPTIONAL, io::opt::OPTIONAL_VAL);
+            opt.declare("delim", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+
+            io::option_type in(opt.declare(
+                "stdin",
+                io::opt::OPTIONAL,
+                io::opt::NO_VAL
+            ));
+
+            io::option_type batch(opt.declare(
+                "batch",
+                io::opt::OPTIONAL,
+                io::opt::REQUIRES_VAL
+            ));
+
+            io::option_type serve(opt.declare(
+                "serve",
+                io::opt::OPTIONAL,
+                io::opt::REQUIRES_VAL
+            ));
+
+            opt.declare("connect", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+
+            if(!in_help) {
+                if(serve.is_valid()) {
+                    opt.declare_min_num_positional(1);
+                } else if(in.is_valid()) {
+                    opt.declare_min_num_positional(1);
+                    opt.declare_max_num_positional(1);
+                } else if(batch.is_valid()) {
+                    opt.declare_min_num_positional(1);
+                } else {
+                    opt.declare_min_num_positional(2);
+                }
+            }
+        }
+
+        static void help(void) throw() {
+            //  "  | |                              |                                             |"
+            printf(
+                "  %s:\n"
+                "    Parses a token stream according to a context-free grammar (CFG).\n\n"
+                "  basic use options for %s:\n"
+                "    --engine=<name>                the parsing engine to use, one of:\n"
+                "                                     earley: Earley's algorithm; this is\n"
+                "                                             the default.\n"
+                "                                     earley-lr0: Earley's algorithm on the\n"
+                "                                             states of the grammar's LR(0)\n"
+                "                                             automaton, as described by\n"
+                "                                             Aycock and Horspool.\n"
+                "                                     cyk:    the CYK algorithm on the CNF\n"
+                "                                             of the grammar; only useful\n"
+                "                                             for short inputs.\n"
+                "                                     valiant: the CYK chart filled tile\n"
+                "                                             by tile as in Valiant's\n"
+                "                                             algorithm; scales to longer\n"
+                "                                             inputs and more threads.\n"
+                "                                     ll1:    a table-driven LL(1) parser;\n"
+                "                                             the grammar's LL(1) table must\n"
+                "                                             not have conflicts. A token that\n"
+                "                                             isn't a terminal matches any\n"
+                "                                             variable terminal, but is\n"
+                "                                             rejected where variable\n"
+                "                                             terminals select different\n"
+                "                                             productions.\n"
+                "                                     lalr:   a table-driven LALR(1) parser;\n"
+                "                                             the grammar's LALR(1) table\n"
+                "                                             must not have conflicts. A token\n"
+                "                                             that isn't a terminal matches\n"
+                "                                             any variable terminal, but is\n"
+                "                                             rejected where variable\n"
+                "                                             terminals have different\n"
+                "                                             actions.\n"
+                "                                     gll:    a generalised LL parser;\n"
+                "                                             accepts any CFG, including\n"
+                "                                             left-recursive and ambiguous\n"
+                "                                             ones.\n"
+                "                                   The options --predict, --lookahead,\n"
+                "                                   --leo, --tree, and --forest only apply\n"
+                "                                   to the Earley engine.\n"
+                "    --threads=<n>                  the number of threads that fill in the\n"
+                "                                   chart of the cyk and valiant engines.\n"
+                "                                   The default is 1.\n"
+                "    --jobs=<n>                     the number of token files to parse at the\n"
+                "                                   same time. Idle threads steal files from\n"
+                "                                   busy ones. Results are still printed in\n"
+                "                                   order. The default is 1. Cannot be used\n"
+                "                                   with --tree or --forest.\n"
+                "    --predict                      compute the FIRST sets of all\n"
+                "                                   variables and only predict variables\n"
+                "                                   that can begin with the next token.\n"
+                "                                   This can speed up parsing.\n"
+                "    --lookahead=<k>                the number of tokens, 1 or 2, that\n"
+                "                                   --predict looks at when skipping\n"
+                "                                   predictions. Two tokens of lookahead\n"
+                "                                   skip more predictions on highly\n"
+                "                                   ambiguous grammars. Implies --predict.\n"
+                "    --cache=<dir>                  keep the NULL, FIRST, and FOLLOW sets of\n"
+                "                                   the grammar in <dir>, keyed by a hash of\n"
+                "                                   the grammar, and reuse them on later runs\n"
+                "                                   of the ll1 and gll engines and of\n"
+                "                                   --predict.\n"
+                "    --leo                          use Leo's deterministic reduction paths\n"
+                "                                   so that right-recursive grammars are\n"
+                "                                   parsed in linear time.\n"
+                "    --stream                       recognize token streams of any length\n"
+                "                                   with the earley-lr0 engine, which is\n"
+                "                                   the default with this option. Earley\n"
+                "                                   sets that can no longer be completed\n"
+                "                                   into are thrown away, and each prefix\n"
+                "                                   of the input that is a sentence is\n"
+                "                                   printed as soon as it is found.\n"
+                "    --tree                         print out a parse tree of the input as an\n"
+                "                                   s-expression.\n"
+                "    --forest[=dot]                 print out the shared packed parse forest\n"
+                "                                   of the input, i.e. all of its parse trees.\n"
+                "                                   With --forest=dot the forest is printed\n"
+                "                                   as a graphviz digraph instead; no other\n"
+                "                                   value is accepted. Both --tree and\n"
+                "                                   --forest disable --leo.\n"
+                "    --stats                        print out counters collected while\n"
+                "                                   parsing, and the time spent in each\n"
+                "                                   phase, to <stderr>. Entry k of the\n"
+                "                                   Earley set size histogram counts the\n"
+                "                                   sets with 2^k to 2^(k+1) - 1 items.\n"
+                "    --stats-json                   like --stats, but print out the counters\n"
+                "                                   as a JSON object.\n"
+                "    --stdin                        Take the input tokens from standard input.\n"
+                "                                   Each token should be separated by a new\n"
+                "                                   line. Typing a new line followed by Ctrl-D\n"
+                "                                   or Ctrl-Z will close stdin.\n"
+                "    --delim                        Change the delimiter of tokens from newlines\n"
+                "                                   to any character present in delim.\n"
+                "    --batch=<file>                 parse each token file named, one per line,\n"
+                "                                   in <file>. The grammar is read and analysed\n"
+                "                                   only once. Each result line is prefixed\n"
+                "                                   with the name of its token file, and\n"
+                "                                   --stats prints totals over all files.\n"
+                "    --serve=<socket>               read in every CFG given and build its\n"
+                "                                   tables once, then answer parse requests\n"
+                "                                   sent to the Unix domain socket <socket>\n"
+                "                                   until interrupted. --jobs requests are\n"
+                "                                   answered at the same time. A request is\n"
+                "                                   the file name or position of a grammar\n"
+                "                                   on its own line followed by the tokens;\n"
+                "                                   the answer is a single line. --stats\n"
+                "                                   prints totals once the server stops.\n"
+                "                                   A stale socket at <socket> is replaced,\n"
+                "                                   but any other file there is an error.\n"
+                "    --connect=<socket>             send the token files to a server started\n"
+                "                                   with --serve instead of parsing them.\n"
+                "                                   <file0> then names the grammar on the\n"
+                "                                   server, and the parsing options are\n"
+                "                                   those of the server.\n"
+                "    <file0>                        read in a CFG from <file>.\n"
+                "    <file1> ...                    read in a newline-separated list of tokens\n"
+                "                                   from <file1> if --stdin is not used. If\n"
+                "                                   several token files are given then each\n"
+                "                                   is parsed as with --batch. With --serve,\n"
+                "                                   these are further CFGs to serve.\n\n",
+                TOOL_NAME, TOOL_NAME
+            );
+        }
+
+        /// print out the counters collected by the parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename parser_type::stats_type &stats
+        ) throw() {
+            typedef typename parser_type::stats_type stats_type;
+
+            unsigned num_buckets(stats_type::NUM_SET_SIZE_BUCKETS);
+            for(; 0 < num_buckets
+                && 0 == stats.set_size_histogram[num_buckets - 1U]; ) {
+                --num_buckets;
+            }
+
+            printer.field("items", stats.num_items);
+            printer.field("sets", stats.num_sets);
+            printer.field("max set items", stats.max_set_items);
+            printer.field(
+                "set size histogram",
+                stats.set_size_histogram,
+                num_buckets
+            );
+            printer.field("predictions", stats.num_predictions);
+            printer.field("scans", stats.num_scans);
+            printer.field("completions", stats.num_completions);
+            printer.field("duplicates", stats.num_duplicates);
+            printer.field("completer items visited", stats.num_completer_visits);
+            printer.field("completer items skipped", stats.num_completer_skips);
+            printer.field("Leo completions", stats.num_leo_completions);
+            printer.field("max live items", stats.max_live_items);
+            printer.field("max live bytes", stats.max_live_bytes);
+        }
+
+        /// print out the counters collected by the LR(0) Earley parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename lr0_parser_type::stats_type &stats
+        ) throw() {
+            printer.field("items", stats.num_items);
+            printer.field("completions", stats.num_completions);
+            printer.field("completer items visited", stats.num_completer_visits);
+            printer.field("collections", stats.num_collections);
+            printer.field("max items kept", stats.max_kept_items);
+            printer.field(
+                "max items after collection",
+                stats.max_items_after_collection
+            );
+        }
+
+        /// print out the counters collected by the CYK parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename cyk_parser_type::stats_type &stats
+        ) throw() {
+            printer.field("chart cells filled", stats.num_cells);
+            printer.field("rule pairs visited", stats.num_pairs);
+            printer.field("threads", stats.num_threads);
+        }
+
+        /// print out the counters collected by the Valiant parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename valiant_parser_type::stats_type &stats
+        ) throw() {
+            printer.field("chart tiles filled", stats.num_tiles);
+            printer.field("tile products", stats.num_products);
+            printer.field("rule pairs visited", stats.num_pairs);
+            printer.field("threads", stats.num_threads);
+        }
+
+        /// print out the counters collected by the LL(1) parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename ll1_parser_type::stats_type &stats
+        ) throw() {
+            printer.field("tokens scanned", stats.num_scans);
+            printer.field("variables expanded", stats.num_expansions);
+            printer.field("max stack size", stats.max_stack_size);
+        }
+
+        /// print out the counters collected by the LALR(1) parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename lalr_parser_type::stats_type &stats
+        ) throw() {
+            printer.field("tokens shifted", stats.num_shifts);
+            printer.field("reductions", stats.num_reductions);
+            printer.field("max stack size", stats.max_stack_size);
+        }
+
+        /// print out the counters collected by the GLL parser
+        static void print_stats(
+            io::StatsPrinter &printer,
+            const typename gll_parser_type::stats_type &stats
+        ) throw() {
+            printer.field("descriptors", stats.num_descriptors);
+            printer.field("GSS nodes", stats.num_gss_nodes);
+            printer.field("GSS edges", stats.num_gss_edges);
+            printer.field("pops", stats.num_pops);
+        }
+
+        /// print out the counters of a parser and the time spent in each
+        /// phase, if asked to by --stats or --stats-json
+        template <typename StatsT>
+        static void report_stats(
+            io::CommandLineOptions &options,
+            const StatsT &stats,
+            helper::PhaseTimer &timer
+        ) throw() {
+            timer.stop();
+
+            const bool as_json(options["stats-json"].is_valid());
+            if(!as_json && !options["stats"].is_valid()) {
+                return;
+            }
+
+            io::StatsPrinter printer(stderr, as_json);
+            printer.begin();
+            print_stats(printer, stats);
+            timer.print(printer);
+            printer.end();
+        }
+
+        /// figure out which parsing engine to use
+        static engine_type get_engine(io::CommandLineOptions &options) throw() {
+            io::option_type engine(options["engine"]);
+
+            io::option_type stream(options["stream"]);
+
+            if(!engine.is_valid() && stream.is_valid()) {
+                return ENGINE_EARLEY_LR0;
+            } else if(!engine.is_valid()
+                   || 0 == strcmp("earley", engine.value())) {
+                return ENGINE_EARLEY;
+            } else if(0 == strcmp("earley-lr0", engine.value())) {
+                return ENGINE_EARLEY_LR0;
+            } else if(0 == strcmp("cyk", engine.value())) {
+                return ENGINE_CYK;
+            } else if(0 == strcmp("valiant", engine.value())) {
+                return ENGINE_VALIANT;
+            } else if(0 == strcmp("ll1", engine.value())) {
+                return ENGINE_LL1;
+            } else if(0 == strcmp("lalr", engine.value())) {
+                return ENGINE_LALR;
+            } else if(0 == strcmp("gll", engine.value())) {
+                return ENGINE_GLL;
+            }
+
+            options.error(
+                "Unknown parsing engine '%s'. The supported engines are "
+                "'earley', 'earley-lr0', 'cyk', 'valiant', 'll1', 'lalr', and "
+                "'gll'.",
+                engine.value()
+            );
+            options.note("Error was cause by this option:", engine);
+
+            return ENGINE_UNKNOWN;
+        }
+
+        /// make sure that none of the options that only apply to the
+        /// Earley engine were given
+        static void check_earley_only_options(
+            io::CommandLineOptions &options
+        ) throw() {
+            const char *earley_only[] = {
+                "predict", "lookahead", "leo", "tree", "forest", 0
+            };
+
+            for(unsigned i(0); 0 != earley_only[i]; ++i) {
+                io::option_type opt(options[earley_only[i]]);
+                if(opt.is_valid()) {
+                    options.error(
+                        "The --%s option only applies to the Earley engine.",
+                        earley_only[i]
+                    );
+                    options.note("Error was cause by this option:", opt);
+                }
+            }
+        }
+
+        /// get the number of threads to use
+        static unsigned get_num_threads(io::CommandLineOptions &options) throw() {
+            io::option_type threads(options["threads"]);
+            if(!threads.is_valid()) {
+                return 1U;
+            }
+
+            const int num_threads(atoi(threads.value()));
+            if(0 >= num_threads) {
+                options.error("The number of threads must be at least 1.");
+                options.note("Error was cause by this option:", threads);
+                return 1U;
+            }
+
+            return static_cast<unsigned>(num_threads);
+        }
+
+        /// get the number of token files to parse at the same time
+        static unsigned get_num_jobs(io::CommandLineOptions &options) throw() {
+            io::option_type jobs(options["jobs"]);
+            if(!jobs.is_valid()) {
+                return 1U;
+            }
+
+            const int num_jobs(atoi(jobs.value()));
+            if(0 >= num_jobs) {
+                options.error("The number of jobs must be at least 1.");
+                options.note("Error was cause by this option:", jobs);
+                return 1U;
+            }
+
+            if(1 < num_jobs) {
+                const char *single_only[] = {"tree", "forest", "stream", 0};
+                for(unsigned i(0); 0 != single_only[i]; ++i) {
+                    io::option_type opt(options[single_only[i]]);
+                    if(opt.is_valid()) {
+                        options.error(
+                            "The --%s option cannot be used with more than "
+                            "one job.",
+                            single_only[i]
+                        );
+                        options.note("Error was cause by this option:", opt);
+                    }
+                }
+            }
+
+            return static_cast<unsigned>(num_jobs);
+        }
+
+        /// parse the ith input with a job
+        template <typename JobT>
+        static bool parse_input(
+            const JobT &job,
+            input_list_type &inputs,
+            const unsigned i,
+            typename JobT::stats_type &stats
+        ) throw() {
+            FILE *fp(inputs.open(i));
+            if(0 == fp) {
+                return false;
+            }
+
+            reader_type reader(fp, inputs.delimiters());
+            reader.reset();
+
+            const bool accepted(job.parse(reader, stats));
+            inputs.close(fp);
+            inputs.report(i, accepted);
+
+            return accepted;
+        }
+
+        /// parse all inputs with a job. with --jobs, the inputs are split
+        /// among several threads, with the current thread acting as the
+        /// first worker.
+        template <typename JobT>
+        static int parse_inputs(
+            io::CommandLineOptions &options,
+            input_list_type &inputs,
+            const JobT &job,
+            helper::PhaseTimer &timer
+        ) throw() {
+            typedef typename JobT::stats_type stats_type;
+
+            timer.start("parse");
+
+            stats_type stats;
+            unsigned num_workers(get_num_jobs(options));
+            if(inputs.size() < num_workers) {
+                num_workers = inputs.size();
+            }
+
+            if(1U >= num_workers) {
+                for(unsigned i(0); i < inputs.size(); ++i) {
+                    job.print(parse_input(job, inputs, i, stats));
+                }
+
+            } else {
+                helper::TaskPool pool(inputs.size(), num_workers);
+                worker_type<JobT> *workers(new worker_type<JobT>[num_workers]);
+                helper::Thread *threads(new helper::Thread[num_workers]);
+
+                for(unsigned w(0); w < num_workers; ++w) {
+                    workers[w].job = &job;
+                    workers[w].inputs = &inputs;
+                    workers[w].pool = &pool;
+                    workers[w].id = w;
+                }
+
+                // a worker whose thread cannot be started leaves its
+                // inputs to be stolen by the others
+                for(unsigned w(1U); w < num_workers; ++w) {
+                    if(!threads[w].start(
+                        &(worker_type<JobT>::run),
+                        &(workers[w])
+                    )) {
+                        io::verbose("Unable to start parser thread.\n");
+                    }
+                }
+
+                worker_type<JobT>::run(&(workers[0]));
+
+                for(unsigned w(0); w < num_workers; ++w) {
+                    threads[w].join();
+                    stats.merge(workers[w].stats);
+                }
+
+                delete [] threads;
+                delete [] workers;
+            }
+
+            report_stats(options, stats, timer);
+
+            return inputs.exit_code();
+        }
+
+        /// compute the NULL, FIRST, and FOLLOW sets of the grammar, or take
+        /// them from the analysis cache if --cache is given. FOLLOW sets are
+        /// only computed if follow is given, or to be added to the cache.
+        template <typename RunnerT>
+        static void compute_sets(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run,
+            std::vector<bool> &is_nullable,
+            fltl::helper::BitMatrix &first,
+            fltl::helper::BitMatrix *follow
+        ) throw() {
+            io::option_type cache_dir(options["cache"]);
+            const cfg::AnalysisCache cache(
+                cache_dir.is_valid() ? cache_dir.value() : 0
+            );
+
+            fltl::helper::BitMatrix scratch_follow;
+            if(0 == follow) {
+                follow = &scratch_follow;
+            }
 
-#include "grail/include/algorithm/CFG_PARSE_EARLEY.hpp"
+            if(cache.is_enabled()) {
+                run.timer.start("cache");
+                if(cache.load(cfg, is_nullable, first, *follow)) {
+                    return;
+                }
+            }
 
-namespace grail { namespace cli {
+            io::verbose("Computing NULL, FIRST, and FOLLOW sets...\n");
+            run.timer.start("NULL");
+            cfg::compute_null_set(cfg, is_nullable);
+            run.timer.start("FIRST");
+            cfg::compute_first_terminals(cfg, is_nullable, first);
 
-    template <typename AlphaT>
-    class CFG_PARSE {
-    public:
+            if(follow == &scratch_follow && !cache.is_enabled()) {
+                return;
+            }
 
-        typedef fltl::CFG<AlphaT> CFG;
-        typedef typename CFG::terminal_type terminal_type;
+            run.timer.start("FOLLOW");
+            cfg::compute_follow_set(cfg, is_nullable, first, *follow);
 
-        static const char * const TOOL_NAME;
+            if(cache.is_enabled()) {
+                run.timer.start("cache");
+                cache.store(cfg, is_nullable, first, *follow);
+            }
+        }
 
-        static void declare(io::CommandLineOptions &opt, bool in_help) throw() {
+        /// parse the tokens with the Earley engine that works on the states
+        /// of the grammar's split epsilon-LR(0) automaton
+        template <typename RunnerT>
+        static int parse_earley_lr0(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            std::vector<bool> is_nullable;
+            run.timer.start("NULL");
+            cfg::compute_null_set(cfg, is_nullable);
 
-            opt.declare("predict", io::opt::OPTIONAL, io::opt::NO_VAL);
-            opt.declare("delim", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
 
-            io::option_type in(opt.declare(
-                "stdin",
-                io::opt::OPTIONAL,
-                io::opt::NO_VAL
-            ));
+            io::verbose("Building epsilon-LR(0) automaton...\n");
+            const typename lr0_parser_type::automaton_type automaton(grammar);
 
-            if(!in_help) {
-                if(in.is_valid()) {
-                    opt.declare_min_num_positional(1);
-                    opt.declare_max_num_positional(1);
-                } else {
-                    opt.declare_min_num_positional(2);
-                    opt.declare_max_num_positional(2);
+            const earley_lr0_job_type job(
+                cfg,
+                grammar,
+                automaton,
+                options["stream"].is_valid()
+            );
+            return run(job);
+        }
+
+        /// parse the tokens with the CYK engine. the CFG is converted into
+        /// CNF in place.
+        template <typename RunnerT>
+        static int parse_cyk(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            run.timer.start("CNF");
+            io::verbose("Converting grammar to CNF...\n");
+            algorithm::CFG_TO_CNF<AlphaT>::run(cfg);
+
+            std::vector<bool> is_nullable;
+            run.timer.start("NULL");
+            cfg::compute_null_set(cfg, is_nullable);
+
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
+            const typename cyk_parser_type::tables_type tables(grammar);
+
+            if(!tables.is_cnf) {
+                io::error(
+                    "The grammar could not be converted into Chomsky normal "
+                    "form, so the cyk engine can't parse with it."
+                );
+                return 1;
+            }
+
+            const cyk_job_type job(grammar, tables, get_num_threads(options));
+            return run(job);
+        }
+
+        /// parse the tokens with the Valiant engine. like the CYK engine, the
+        /// CFG is converted into CNF in place.
+        template <typename RunnerT>
+        static int parse_valiant(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            run.timer.start("CNF");
+            io::verbose("Converting grammar to CNF...\n");
+            algorithm::CFG_TO_CNF<AlphaT>::run(cfg);
+
+            std::vector<bool> is_nullable;
+            run.timer.start("NULL");
+            cfg::compute_null_set(cfg, is_nullable);
+
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
+            const typename valiant_parser_type::tables_type tables(grammar);
+
+            if(!tables.is_cnf) {
+                io::error(
+                    "The grammar could not be converted into Chomsky normal "
+                    "form, so the valiant engine can't parse with it."
+                );
+                return 1;
+            }
+
+            const valiant_job_type job(grammar, tables, get_num_threads(options));
+            return run(job);
+        }
+
+        /// report the conflicts of an LL(1) table
+        static void print_conflicts(
+            CFG &cfg,
+            const cfg::CompiledGrammar<AlphaT> &grammar,
+            const typename ll1_parser_type::table_type &table
+        ) throw() {
+            for(unsigned i(0); i < table.conflicts.size(); ++i) {
+                const typename ll1_parser_type::table_type::conflict_type &
+                    conflict(table.conflicts[i]);
+
+                const char *lookahead("<end of input>");
+                if(0 != conflict.terminal) {
+                    const terminal_type &t(grammar.terminals[conflict.terminal]);
+                    lookahead = cfg.is_variable_terminal(t)
+                              ? cfg.get_name(t)
+                              : cfg.get_alpha(t);
                 }
+
+                io::error(
+                    "The following two productions of '%s' conflict on the "
+                    "lookahead '%s'.",
+                    cfg.get_name(grammar.variables[conflict.variable]),
+                    lookahead
+                );
+
+                fprintf(stderr, "         #0: ");
+                io::fprint(stderr, cfg, grammar.productions[conflict.chosen]);
+                fprintf(stderr, "         #1: ");
+                io::fprint(stderr, cfg, grammar.productions[conflict.rejected]);
+                fprintf(stderr, "\n");
             }
         }
 
-        static void help(void) throw() {
-            //  "  | |                              |                                             |"
-            printf(
-                "  %s:\n"
-                "    Parses a token stream according to a context-free grammar (CFG).\n\n"
-                "  basic use options for %s:\n"
-                "    --predict                      compute the FIRST sets of all\n"
-                "                                   variables. This computation can\n"
-                "                                   take a long time for larger\n"
-                "                                   grammars, but can also speed up\n"
-                "                                   parsing.\n"
-                "    --stdin                        Take the input tokens from standard input.\n"
-                "                                   Each token should be separated by a new\n"
-                "                                   line. Typing a new line followed by Ctrl-D\n"
-                "                                   or Ctrl-Z will close stdin.\n"
-                "    --delim                        Change the delimiter of tokens from newlines\n"
-                "                                   to any character present in delim.\n"
-                "    <file0>                        read in a CFG from <file>.\n"
-                "    <file1>                        read in a newline-separated list of tokens\n"
-                "                                   from <file1> if --stdin is not used.\n\n",
-                TOOL_NAME, TOOL_NAME
+        /// parse the tokens with the table-driven LL(1) engine. grammars
+        /// whose LL(1) table has conflicts are rejected.
+        template <typename RunnerT>
+        static int parse_ll1(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            std::vector<bool> is_nullable;
+            fltl::helper::BitMatrix first;
+            fltl::helper::BitMatrix follow;
+
+            compute_sets(options, cfg, run, is_nullable, first, &follow);
+
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
+
+            io::verbose("Building LL(1) table...\n");
+            const typename ll1_parser_type::table_type table(
+                grammar,
+                first,
+                follow
+            );
+
+            if(!table.conflicts.empty()) {
+                print_conflicts(cfg, grammar, table);
+                return 1;
+            }
+
+            const ll1_job_type job(grammar, table);
+            return run(job);
+        }
+
+        /// parse the tokens with the table-driven LALR(1) engine. grammars
+        /// whose LALR(1) table has conflicts are rejected; cfg-to-lalr
+        /// describes the conflicting states.
+        template <typename RunnerT>
+        static int parse_lalr(
+            io::CommandLineOptions &,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            typedef typename lalr_parser_type::table_type table_type;
+
+            std::vector<bool> is_nullable;
+            run.timer.start("NULL");
+            cfg::compute_null_set(cfg, is_nullable);
+
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
+
+            io::verbose("Building LR(0) automaton...\n");
+            const typename table_type::automaton_type automaton(grammar);
+
+            io::verbose("Building LALR(1) table...\n");
+            const table_type table(grammar, automaton);
+
+            if(!table.conflicts.empty()) {
+                io::error(
+                    "The LALR(1) table of the grammar has %u conflicts. Use "
+                    "cfg-to-lalr to find the conflicting states.",
+                    static_cast<unsigned>(table.conflicts.size())
+                );
+                return 1;
+            }
+
+            const lalr_job_type job(grammar, table);
+            return run(job);
+        }
+
+        /// parse the tokens with the GLL engine
+        template <typename RunnerT>
+        static int parse_gll(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            std::vector<bool> is_nullable;
+            fltl::helper::BitMatrix first;
+            fltl::helper::BitMatrix follow;
+
+            compute_sets(options, cfg, run, is_nullable, first, &follow);
+
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
+            const typename gll_parser_type::tables_type tables(
+                grammar,
+                first,
+                follow
             );
+
+            const gll_job_type job(cfg, grammar, tables);
+            return run(job);
         }
 
         /// interpret the delimiter string
@@ -144,115 +1569,474 @@ namespace grail { namespace cli {
             return ret;
         }
 
-        static int main(io::CommandLineOptions &options) throw() {
+        /// parse the tokens with the Earley engine
+        template <typename RunnerT>
+        static int parse_earley(
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            std::vector<bool> is_nullable;
+            fltl::helper::BitMatrix first_terminals;
 
-            // run the tool
-            io::option_type file[2];
-            const char *file_name[2] = {0};
-            FILE *fp[2] = {0};
+            bool use_first_sets(false);
+            unsigned lookahead(1U);
+
+            io::option_type lookahead_opt(options["lookahead"]);
+            if(lookahead_opt.is_valid()) {
+                if(0 == strcmp("1", lookahead_opt.value())) {
+                    lookahead = 1U;
+                } else if(0 == strcmp("2", lookahead_opt.value())) {
+                    lookahead = 2U;
+                } else {
+                    options.error(
+                        "The amount of lookahead must be either 1 or 2."
+                    );
+                    options.note(
+                        "Error was cause by this option:",
+                        lookahead_opt
+                    );
+                    return 1;
+                }
+            }
+
+            // fill the first and nullable sets
+            if(options["predict"].is_valid() || lookahead_opt.is_valid()) {
+                use_first_sets = true;
+                compute_sets(options, cfg, run, is_nullable, first_terminals, 0);
+            } else {
+                io::verbose("Computing NULL set of variables...\n");
+                run.timer.start("NULL");
+                cfg::compute_null_set(cfg, is_nullable);
+            }
+
+            run.timer.start("tables");
+            io::verbose("Compiling grammar...\n");
+            const cfg::CompiledGrammar<AlphaT> grammar(cfg, is_nullable);
+
+            typename parser_type::lookahead_sets_type *lookahead_sets(0);
+            if(use_first_sets) {
+                lookahead_sets = new typename parser_type::lookahead_sets_type(
+                    grammar,
+                    first_terminals
+                );
+            }
+
+            typename parser_type::forest_type forest(grammar);
+
+            io::option_type print_tree(options["tree"]);
+            io::option_type print_forest(options["forest"]);
+
+            earley_job_type job(cfg, grammar);
+            job.lookahead_sets = lookahead_sets;
+            job.lookahead = lookahead;
+            job.use_leo = options["leo"].is_valid();
+            job.print_tree = print_tree.is_valid();
+            job.print_forest = print_forest.is_valid();
+            job.print_dot = print_forest.is_valid()
+                         && print_forest.has_value()
+                         && 0 == strcmp("dot", print_forest.value());
 
-            file[0] = options[0U];
-            file_name[0] = file[0].value();
-            fp[0] = fopen(file_name[0], "r");
+            if(job.print_tree || job.print_forest) {
+                job.forest = &forest;
+            }
+
+            io::verbose("Parsing...\n");
+
+            const int ret(run(job));
+
+            if(0 != lookahead_sets) {
+                delete lookahead_sets;
+                lookahead_sets = 0;
+            }
+
+            return ret;
+        }
 
-            if(0 == fp[0]) {
+        /// read in the CFG in the ith positional file
+        static bool read_grammar(
+            io::CommandLineOptions &options,
+            const unsigned i,
+            CFG &cfg
+        ) throw() {
+            io::option_type file(options[i]);
+            const char *file_name(file.value());
+            FILE *fp(fopen(file_name, "r"));
+
+            if(0 == fp) {
                 options.error(
                     "Unable to open file containing context-free "
                     "grammar for reading."
                 );
-                options.note("File specified here:", file[0]);
+                options.note("File specified here:", file);
+
+                return false;
+            }
+
+            const bool ok(io::fread(fp, cfg, file_name));
+            fclose(fp);
+
+            return ok;
+        }
 
+        /// build the tables that an engine needs for a grammar, and hand
+        /// the resulting job to a runner
+        template <typename RunnerT>
+        static int parse_with_engine(
+            const engine_type engine,
+            io::CommandLineOptions &options,
+            CFG &cfg,
+            RunnerT &run
+        ) throw() {
+            switch(engine) {
+            case ENGINE_EARLEY:
+                return parse_earley(options, cfg, run);
+            case ENGINE_EARLEY_LR0:
+                return parse_earley_lr0(options, cfg, run);
+            case ENGINE_CYK:
+                return parse_cyk(options, cfg, run);
+            case ENGINE_VALIANT:
+                return parse_valiant(options, cfg, run);
+            case ENGINE_LL1:
+                return parse_ll1(options, cfg, run);
+            case ENGINE_LALR:
+                return parse_lalr(options, cfg, run);
+            case ENGINE_GLL:
+                return parse_gll(options, cfg, run);
+            default:
                 return 1;
             }
+        }
 
-            file[1] = options["stdin"];
-            if(file[1].is_valid()) {
-                fp[1] = stdin;
-                file_name[1] = "<stdin>";
-            } else {
-                file[1] = options[1U];
-                file_name[1] = file[1].value();
-                fp[1] = fopen(file_name[1], "r");
+        /// stop the server; called on SIGINT and SIGTERM. shutting down
+        /// the listening socket wakes up every worker blocked in accept.
+        static void stop_server(int) throw() {
+            stop_serving = 1;
+            shutdown(serve_fd, SHUT_RDWR);
+        }
+
+        /// answer parse requests for the loaded grammars until the server
+        /// is stopped. the current thread acts as the first worker.
+        template <typename JobT>
+        static int serve(server_type &server, const JobT &) throw() {
+            io::option_type socket_opt(server.options["serve"]);
+            const char *path(socket_opt.value());
+
+            if(io::is_non_socket(path)) {
+                server.options.error(
+                    "Refusing to replace '%s' with the server's socket, "
+                    "because it exists and is not a socket.",
+                    path
+                );
+                server.options.note("Error was cause by this option:", socket_opt);
+                return 1;
             }
 
-            if(0 == fp[1]) {
-                options.error(
-                    "Unable to open file containing tokens to be parsed."
+            struct stat bound;
+            serve_fd = io::local_listen(path, SOMAXCONN, bound);
+            if(0 > serve_fd) {
+                io::error(
+                    "Unable to listen for parse requests on the socket '%s'.",
+                    path
                 );
-                options.note("File specified here:", file[1]);
+                return 1;
+            }
+
+            stop_serving = 0;
+
+            struct sigaction action;
+            memset(&action, 0, sizeof action);
+            action.sa_handler = &stop_server;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGINT, &action, 0);
+            sigaction(SIGTERM, &action, 0);
+            signal(SIGPIPE, SIG_IGN);
+
+            const unsigned num_workers(get_num_jobs(server.options));
+            server_worker_type<JobT> *workers(
+                new server_worker_type<JobT>[num_workers]
+            );
+            helper::Thread *threads(new helper::Thread[num_workers]);
 
-                if(0 != fp[0]) {
-                    fclose(fp[0]);
+            for(unsigned w(0); w < num_workers; ++w) {
+                workers[w].server = &server;
+            }
+
+            io::verbose(
+                "Serving %u grammars on '%s' with %u workers...\n",
+                static_cast<unsigned>(server.jobs.size()),
+                path,
+                num_workers
+            );
+
+            for(unsigned w(1U); w < num_workers; ++w) {
+                if(!threads[w].start(
+                    &(server_worker_type<JobT>::run),
+                    &(workers[w])
+                )) {
+                    io::verbose("Unable to start server thread.\n");
                 }
+            }
 
-                return 1;
+            server.timer.start("serve");
+            server_worker_type<JobT>::run(&(workers[0]));
+
+            typename JobT::stats_type stats;
+            for(unsigned w(0); w < num_workers; ++w) {
+                threads[w].join();
+                stats.merge(workers[w].stats);
             }
 
-            CFG cfg;
-            int ret(0);
+            delete [] threads;
+            delete [] workers;
 
-            if(io::fread(fp[0], cfg, file_name[0])) {
+            close(serve_fd);
+            serve_fd = -1;
+            io::local_unlink(path, bound);
 
-                std::vector<bool> is_nullable;
-                std::vector<std::vector<bool> *> first_terminals;
+            io::verbose("Server stopped.\n");
 
-                // fill the first and nullable sets
-                io::verbose("Computing NULL set of variables...\n");
-                cfg::compute_null_set(cfg, is_nullable);
+            report_stats(server.options, stats, server.timer);
+
+            return 0;
+        }
+
+        /// send each input to a server started with --serve, and report
+        /// the server's answers as if the inputs had been parsed here
+        static int send_inputs(
+            io::CommandLineOptions &options,
+            input_list_type &inputs
+        ) throw() {
+            io::option_type socket_opt(options["connect"]);
+            const char *path(socket_opt.value());
+
+            io::option_type grammar(options[0U]);
+            const char *id(grammar.value());
 
-                bool use_first_sets(false);
-                if(options["predict"].is_valid()) {
-                    io::verbose("Computing FIRST set of variables...\n");
-                    use_first_sets = true;
-                    cfg::compute_first_terminals(cfg, is_nullable, first_terminals);
+            signal(SIGPIPE, SIG_IGN);
+
+            for(unsigned i(0); i < inputs.size(); ++i) {
+                FILE *fp(inputs.open(i));
+                if(0 == fp) {
+                    continue;
                 }
 
-                io::verbose("Parsing...\n");
+                const int fd(io::local_connect(path));
+                if(0 > fd) {
+                    inputs.close(fp);
+                    options.error(
+                        "Unable to connect to the parse server."
+                    );
+                    options.note("Socket specified here:", socket_opt);
+                    return 1;
+                }
 
-                const char *delim_chars("\r\n");
+                // a failed write means that the server has already
+                // answered, e.g. because the grammar is unknown
+                bool sent(io::write_all(fd, id, strlen(id))
+                       && io::write_all(fd, "\n", 1U));
 
-                io::option_type delim(options["delim"]);
-                if(delim.is_valid()) {
-                    delim_chars = interpret_delim(options, delim);
+                char buffer[4096];
+                for(size_t size(0);
+                    sent && 0 < (size = fread(buffer, 1U, sizeof buffer, fp)); ) {
+                    sent = io::write_all(fd, buffer, size);
                 }
 
-                if(!options.has_error()) {
+                inputs.close(fp);
+                shutdown(fd, SHUT_WR);
 
-                    io::UTF8FileTokBuffer<1024U> reader(fp[1], delim_chars);
-                    reader.reset();
+                char answer[1024];
+                answer[0] = '\0';
 
-                    if(algorithm::CFG_PARSE_EARLEY<AlphaT, 1024U>::run(
-                        cfg,
-                        is_nullable,
-                        use_first_sets,
-                        first_terminals,
-                        reader
-                    )) {
-                        printf("Yes.\n");
-                    } else {
-                        printf("No.\n");
+                FILE *response(fdopen(fd, "r"));
+                if(0 == response) {
+                    close(fd);
+                } else {
+                    if(0 == fgets(answer, sizeof answer, response)) {
+                        answer[0] = '\0';
                     }
+                    fclose(response);
+                }
+
+                if(0 == strcmp("Yes.\n", answer)) {
+                    inputs.report(i, true);
+                } else if(0 == strcmp("No.\n", answer)) {
+                    inputs.report(i, false);
+                } else {
+                    answer[strcspn(answer, "\r\n")] = '\0';
+                    io::error(
+                        "The parse server could not parse '%s': %s",
+                        inputs.name(i),
+                        '\0' == answer[0] ? "No answer." : answer
+                    );
+                    inputs.skip(i);
+                }
+            }
+
+            return inputs.exit_code();
+        }
+
+        /// read in and serve every grammar given on the command line
+        static int run_server(
+            io::CommandLineOptions &options,
+            const char *delim_chars
+        ) throw() {
+            const char *not_served[] = {
+                "stdin", "batch", "connect", "stream", "tree", "forest", 0
+            };
+
+            for(unsigned i(0); 0 != not_served[i]; ++i) {
+                io::option_type opt(options[not_served[i]]);
+                if(opt.is_valid()) {
+                    options.error(
+                        "The --%s option cannot be used with --serve.",
+                        not_served[i]
+                    );
+                    options.note("Error was cause by this option:", opt);
+                }
+            }
+
+            const engine_type engine(get_engine(options));
+            if(ENGINE_EARLEY != engine) {
+                check_earley_only_options(options);
+            }
+
+            get_num_threads(options);
+            get_num_jobs(options);
+
+            if(options.has_error()) {
+                return 1;
+            }
+
+            server_type server(options, engine, delim_chars);
+            return server.load_next();
+        }
+
+        /// parse, or send to a server, the token files given on the command
+        /// line
+        static int run_inputs(
+            io::CommandLineOptions &options,
+            const char *delim_chars
+        ) throw() {
+            input_list_type inputs(delim_chars);
+
+            io::option_type in(options["stdin"]);
+            io::option_type batch(options["batch"]);
+
+            if(in.is_valid()) {
+                if(batch.is_valid()) {
+                    options.error(
+                        "The --stdin and --batch options cannot be used "
+                        "together."
+                    );
+                    options.note("Error was cause by this option:", batch);
+                }
+                inputs.add_stdin();
+
+            } else {
+                if(batch.is_valid() && !inputs.add_batch(batch.value())) {
+                    options.error(
+                        "Unable to open file containing the list of token "
+                        "files to be parsed."
+                    );
+                    options.note("File specified here:", batch);
                 }
 
-                // clean up the custom delimiter string
-                if(delim.is_valid()) {
-                    delete [] delim_chars;
+                for(unsigned i(1U); options[i].is_valid(); ++i) {
+                    inputs.add_file(options[i].value());
                 }
+            }
+
+            // the server decides how the tokens are parsed
+            if(options["connect"].is_valid()) {
+                const char *server_only[] = {
+                    "engine", "threads", "jobs", "predict", "lookahead",
+                    "leo", "stream", "tree", "forest", "stats", "stats-json",
+                    "delim", 0
+                };
 
-                // clean out the first set
-                for(unsigned i(0); i < first_terminals.size(); ++i) {
-                    if(0 != first_terminals[i]) {
-                        delete (first_terminals[i]);
-                        first_terminals[i] = 0;
+                for(unsigned i(0); 0 != server_only[i]; ++i) {
+                    io::option_type opt(options[server_only[i]]);
+                    if(opt.is_valid()) {
+                        options.error(
+                            "The --%s option must be given to the server, "
+                            "not with --connect.",
+                            server_only[i]
+                        );
+                        options.note("Error was cause by this option:", opt);
                     }
                 }
 
+                if(options.has_error()) {
+                    return 1;
+                }
+
+                return send_inputs(options, inputs);
+            }
+
+            const engine_type engine(get_engine(options));
+            if(ENGINE_EARLEY != engine) {
+                check_earley_only_options(options);
+            }
+
+            io::option_type stream(options["stream"]);
+            if(stream.is_valid() && ENGINE_EARLEY_LR0 != engine) {
+                options.error(
+                    "The --stream option only applies to the earley-lr0 "
+                    "engine."
+                );
+                options.note("Error was cause by this option:", stream);
+            }
+
+            get_num_threads(options);
+            get_num_jobs(options);
+
+            if(options.has_error()) {
+                return 1;
+            }
+
+            batch_runner_type run(options, inputs);
+
+            CFG cfg;
+            run.timer.start("load");
+            if(!read_grammar(options, 0U, cfg)) {
+                return 1;
+            }
+
+            return parse_with_engine(engine, options, cfg, run);
+        }
+
+        static int main(io::CommandLineOptions &options) throw() {
+
+            const char *delim_chars("\r\n");
+
+            io::option_type delim(options["delim"]);
+            if(delim.is_valid()) {
+                delim_chars = interpret_delim(options, delim);
+            }
+
+            io::option_type forest(options["forest"]);
+            if(forest.has_value() && 0 != strcmp("dot", forest.value())) {
+                options.error(
+                    "The only format that --forest accepts is 'dot', as in "
+                    "--forest=dot."
+                );
+                options.note("Error was cause by this option:", forest);
+            }
+
+            int ret(1);
+
+            // run the tool
+            if(options["serve"].is_valid()) {
+                ret = run_server(options, delim_chars);
             } else {
-                ret = 1;
+                ret = run_inputs(options, delim_chars);
             }
 
-            fclose(fp[0]);
-            fclose(fp[1]);
+            // clean up the custom delimiter string
+            if(delim.is_valid()) {
+                delete [] delim_chars;
+            }
 
             return ret;
         }
@@ -261,6 +2045,12 @@ namespace grail { namespace cli {
     template <typename AlphaT>
     const char * const CFG_PARSE<AlphaT>::TOOL_NAME("cfg-parse");
 
+    template <typename AlphaT>
+    volatile sig_atomic_t CFG_PARSE<AlphaT>::stop_serving(0);
+
+    template <typename AlphaT>
+    int CFG_PARSE<AlphaT>::serve_fd(-1);
+
 }}
 
 #endif /* FLTL_CFG_PARSE_HPP_ */
@@ -0,0 +1,342 @@
+/*
+ * CFG_TO_LALR.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_CFG_TO_LALR_HPP_
+#define Grail_Plus_CFG_TO_LALR_HPP_
+
+#include <cstdio>
+#include <vector>
+
+#include "fltl/include/CFG.hpp"
+
+#include "grail/include/cfg/compute_null_set.hpp"
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LR0Automaton.hpp"
+#include "grail/include/cfg/LALRTable.hpp"
+
+#include "grail/include/io/CommandLineOptions.hpp"
+#include "grail/include/io/fread_cfg.hpp"
+#include "grail/include/io/fprint_cfg.hpp"
+#include "grail/include/io/error.hpp"
+#include "grail/include/io/verbose.hpp"
+
+namespace grail { namespace cli {
+
+    template <typename AlphaT>
+    class CFG_TO_LALR {
+    public:
+
+        FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
+
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef cfg::LR0Automaton<AlphaT> automaton_type;
+        typedef cfg::LALRTable<AlphaT> table_type;
+
+        static const char * const TOOL_NAME;
+
+        static void declare(io::CommandLineOptions &opt, bool in_help) throw() {
+            opt.declare("quiet", io::opt::OPTIONAL, io::opt::NO_VAL);
+            if(!in_help) {
+                opt.declare_min_num_positional(1);
+                opt.declare_max_num_positional(1);
+            }
+        }
+
+        static void help(void) throw() {
+            //  "  | |                              |                                             |"
+            printf(
+                "  %s:\n"
+                "    Computes the LALR(1) parser tables of a context-free grammar (CFG). The\n"
+                "    lookahead sets are computed from the LR(0) automaton of the CFG using the\n"
+                "    relations of DeRemer and Pennello. Every state of the automaton is printed\n"
+                "    along with its items and actions. Shift/reduce and reduce/reduce conflicts\n"
+                "    are reported as warnings and resolved in favour of shifting, and of the\n"
+                "    earlier production, respectively.\n\n"
+                "  basic use options for %s:\n"
+                "    --quiet                        only report the conflicts and the size of\n"
+                "                                   the tables.\n"
+                "    <file>                         read in a CFG from <file>.\n\n",
+                TOOL_NAME, TOOL_NAME
+            );
+        }
+
+        /// print out a symbol of the compiled grammar
+        static void print_symbol(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const symbol_id_type sym
+        ) throw() {
+            if(0 > sym) {
+                io::fprint(ff, cfg, grammar.terminals[static_cast<unsigned>(-sym)]);
+            } else if(grammar.start_variable == static_cast<unsigned>(sym)) {
+                fprintf(ff, "$accept");
+            } else {
+                io::fprint(ff, cfg, grammar.variables[static_cast<unsigned>(sym)]);
+            }
+        }
+
+        /// print out a lookahead terminal
+        static void print_terminal(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const unsigned t
+        ) throw() {
+            if(table_type::END_OF_INPUT == t) {
+                fprintf(ff, "$end");
+            } else {
+                print_symbol(ff, cfg, grammar, -static_cast<symbol_id_type>(t));
+            }
+        }
+
+        /// print out an item, with a dot marking how much of its production
+        /// has been seen
+        static void print_item(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const unsigned item
+        ) throw() {
+            const unsigned p(grammar.item_production[item]);
+            const unsigned first_item(grammar.production_item[p]);
+
+            print_symbol(
+                ff, cfg, grammar,
+                static_cast<symbol_id_type>(grammar.item_variable[item])
+            );
+            fprintf(ff, " ->");
+
+            for(unsigned curr(first_item);; ++curr) {
+                if(curr == item) {
+                    fprintf(ff, " .");
+                }
+
+                const symbol_id_type sym(grammar.item_symbol[curr]);
+                if(grammar_type::END_OF_PRODUCTION == sym) {
+                    break;
+                }
+
+                fprintf(ff, " ");
+                print_symbol(ff, cfg, grammar, sym);
+            }
+        }
+
+        /// print out an action of the table
+        static void print_action(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const unsigned action
+        ) throw() {
+            const unsigned target(table_type::action_target(action));
+
+            switch(table_type::action_kind(action)) {
+            case table_type::ACTION_SHIFT:
+                fprintf(ff, "shift, and go to state %u", target);
+                break;
+            case table_type::ACTION_REDUCE:
+                fprintf(ff, "reduce using rule %u (", target);
+                print_rule(ff, cfg, grammar, target);
+                fprintf(ff, ")");
+                break;
+            case table_type::ACTION_ACCEPT:
+                fprintf(ff, "accept");
+                break;
+            default:
+                fprintf(ff, "error");
+                break;
+            }
+        }
+
+        /// print out a production as a rule, i.e. without a dot
+        static void print_rule(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const unsigned p
+        ) throw() {
+            const unsigned first_item(grammar.production_item[p]);
+
+            print_symbol(
+                ff, cfg, grammar,
+                static_cast<symbol_id_type>(grammar.item_variable[first_item])
+            );
+            fprintf(ff, " ->");
+
+            if(0U == grammar.production_length(p)) {
+                fprintf(ff, " epsilon");
+            }
+
+            for(unsigned curr(first_item);
+                grammar_type::END_OF_PRODUCTION != grammar.item_symbol[curr];
+                ++curr) {
+                fprintf(ff, " ");
+                print_symbol(ff, cfg, grammar, grammar.item_symbol[curr]);
+            }
+        }
+
+        /// print out the items and actions of every state
+        static void print_states(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const automaton_type &automaton,
+            const table_type &table
+        ) throw() {
+            for(unsigned s(0); s < automaton.num_states(); ++s) {
+                fprintf(ff, "state %u\n\n", s);
+
+                for(unsigned i(automaton.state_begin[s]);
+                    i < automaton.state_begin[s + 1U];
+                    ++i) {
+                    fprintf(ff, "    ");
+                    print_item(ff, cfg, grammar, automaton.items[i]);
+                    fprintf(ff, "\n");
+                }
+
+                fprintf(ff, "\n");
+
+                for(unsigned t(0); t < grammar.num_terminals; ++t) {
+                    const unsigned action(table.action(s, t));
+                    if(table_type::ACTION_ERROR == action
+                    || action == table.default_action[s]) {
+                        continue;
+                    }
+
+                    fprintf(ff, "    ");
+                    print_terminal(ff, cfg, grammar, t);
+                    fprintf(ff, "  ");
+                    print_action(ff, cfg, grammar, action);
+                    fprintf(ff, "\n");
+                }
+
+                for(unsigned k(automaton.transition_begin[s]);
+                    k < automaton.transition_begin[s + 1U];
+                    ++k) {
+
+                    const symbol_id_type sym(automaton.transition_symbol[k]);
+                    if(0 < sym) {
+                        fprintf(ff, "    ");
+                        print_symbol(ff, cfg, grammar, sym);
+                        fprintf(ff, "  go to state %u\n", automaton.transition_target[k]);
+                    }
+                }
+
+                if(table_type::ACTION_ERROR != table.default_action[s]) {
+                    fprintf(ff, "    $default  ");
+                    print_action(ff, cfg, grammar, table.default_action[s]);
+                    fprintf(ff, "\n");
+                }
+
+                fprintf(ff, "\n");
+            }
+        }
+
+        /// report the conflicts of the table as warnings
+        static void print_conflicts(
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const table_type &table
+        ) throw() {
+            for(unsigned i(0); i < table.conflicts.size(); ++i) {
+                const typename table_type::conflict_type &conflict(
+                    table.conflicts[i]
+                );
+
+                io::warning(
+                    "%s conflict in state %u. Action #0 has been chosen.",
+                    table_type::SHIFT_REDUCE == conflict.kind
+                        ? "Shift/reduce" : "Reduce/reduce",
+                    conflict.state
+                );
+
+                fprintf(stderr, "         lookahead: ");
+                print_terminal(stderr, cfg, grammar, conflict.terminal);
+                fprintf(stderr, "\n         #0: ");
+                print_action(stderr, cfg, grammar, conflict.chosen);
+                fprintf(stderr, "\n         #1: ");
+                print_action(stderr, cfg, grammar, conflict.rejected);
+                fprintf(stderr, "\n\n");
+            }
+        }
+
+        static int main(io::CommandLineOptions &options) throw() {
+
+            // run the tool
+            io::option_type file(options[0U]);
+            const char *file_name(file.value());
+            FILE *fp(fopen(file_name, "r"));
+
+            if(0 == fp) {
+                options.error(
+                    "Unable to open file containing context-free "
+                    "grammar for reading."
+                );
+                options.note("File specified here:", file);
+                return 1;
+            }
+
+            cfg_type cfg;
+            int ret(0);
+
+            if(io::fread(fp, cfg, file_name)) {
+
+                std::vector<bool> nullable;
+
+                io::verbose("Computing NULL set of variables...\n");
+                cfg::compute_null_set(cfg, nullable);
+
+                io::verbose("Compiling grammar...\n");
+                const grammar_type grammar(cfg, nullable);
+
+                io::verbose("Building LR(0) automaton...\n");
+                const automaton_type automaton(grammar);
+
+                io::verbose("Computing LALR(1) lookahead sets...\n");
+                const table_type table(grammar, automaton);
+
+                if(!options["quiet"].is_valid()) {
+                    print_states(stdout, cfg, grammar, automaton, table);
+                }
+
+                print_conflicts(cfg, grammar, table);
+
+                unsigned num_sr(0);
+                for(unsigned i(0); i < table.conflicts.size(); ++i) {
+                    if(table_type::SHIFT_REDUCE == table.conflicts[i].kind) {
+                        ++num_sr;
+                    }
+                }
+
+                fprintf(stdout,
+                    "%u states, %u shift/reduce conflicts, %u reduce/reduce "
+                    "conflicts, %u packed table entries\n",
+                    automaton.num_states(),
+                    num_sr,
+                    static_cast<unsigned>(table.conflicts.size()) - num_sr,
+                    table.num_entries()
+                );
+
+            } else {
+                ret = 1;
+            }
+
+            fclose(fp);
+
+            return ret;
+        }
+    };
+
+    template <typename AlphaT>
+    const char * const CFG_TO_LALR<AlphaT>::TOOL_NAME("cfg-to-lalr");
+}}
+
+#endif /* Grail_Plus_CFG_TO_LALR_HPP_ */
@@ -38,9 +38,15 @@
 
 #include "fltl/include/CFG.hpp"
 
+#include "fltl/include/helper/BitMatrix.hpp"
+#include "fltl/include/helper/BitSet.hpp"
+
+#include "grail/include/cfg/AnalysisCache.hpp"
 #include "grail/include/cfg/compute_null_set.hpp"
 #include "grail/include/cfg/compute_first_set.hpp"
 #include "grail/include/cfg/compute_follow_set.hpp"
+#include "grail/include/cfg/CompiledGrammar.hpp"
+#include "grail/include/cfg/LL1Table.hpp"
 
 #include "grail/include/io/CommandLineOptions.hpp"
 #include "grail/include/io/fread_cfg.hpp"
@@ -62,10 +68,15 @@ namespace grail { namespace cli {
 
         FLTL_CFG_USE_TYPES(fltl::CFG<AlphaT>);
 
+        typedef fltl::helper::BitMatrix bit_matrix_type;
+        typedef bit_matrix_type::word_type word_type;
+
         static const char * const TOOL_NAME;
 
         static void declare(io::CommandLineOptions &opt, bool in_help) throw() {
             //io::option_type in(opt.declare("stdin", io::opt::OPTIONAL, io::opt::NO_VAL));
+            opt.declare("fast", io::opt::OPTIONAL, io::opt::NO_VAL);
+            opt.declare("cache", io::opt::OPTIONAL, io::opt::REQUIRES_VAL);
             if(!in_help) {
                 opt.declare_min_num_positional(1);
                 opt.declare_max_num_positional(1);
@@ -81,18 +92,22 @@ namespace grail { namespace cli {
                 "    potentially a subset of the language because of first/first and first/follow\n"
                 "    conflicts.\n\n"
                 "  basic use options for %s:\n"
+                "    --fast                         output a faster parser: productions are\n"
+                "                                   expanded by a switch with one case per\n"
+                "                                   production, the parse table is compressed,\n"
+                "                                   the stack has a fixed size, and tokens\n"
+                "                                   are read through a buffer and mapped to\n"
+                "                                   integer terminal ids. As in cfg-parse's\n"
+                "                                   ll1 engine, a token that isn't a terminal\n"
+                "                                   matches any variable terminal.\n"
+                "    --cache=<dir>                  keep the NULL, FIRST, and FOLLOW sets of\n"
+                "                                   the grammar in <dir>, keyed by a hash of\n"
+                "                                   the grammar, and reuse them on later runs.\n"
                 "    <file>                         read in a CFG from <file>.\n\n",
                 TOOL_NAME, TOOL_NAME
             );
         }
 
-        static bool in_follow(
-            std::vector<std::vector<bool> *> &follow,
-            variable_type V, terminal_type a
-        ) throw() {
-            return (follow[V.number()])->at(a.number());
-        }
-
         static const char *terminal_rep(cfg_type &cfg, terminal_type a) throw() {
             if(cfg.is_variable_terminal(a)) {
                 return cfg.get_name(a);
@@ -107,8 +122,8 @@ namespace grail { namespace cli {
             production_type prod,
             terminal_type term,
             const std::vector<bool> &nullable,
-            const std::vector<std::vector<bool> *> &first,
-            const std::vector<std::vector<bool> *> &follow
+            const bit_matrix_type &first,
+            const bit_matrix_type &follow
         ) throw() {
 
             const char *prefix(0);
@@ -119,7 +134,7 @@ namespace grail { namespace cli {
                 if(w.at(i).is_variable()) {
                     variable_type v(w.at(i));
 
-                    if(first[v.number()]->at(term.number())) {
+                    if(first.test(v.number(), term.number())) {
                         fprintf(stderr,
                             "'%s' is in the first set of the variable '%s'.",
                             terminal_rep(cfg, term),
@@ -173,8 +188,8 @@ namespace grail { namespace cli {
             std::map<std::pair<unsigned, unsigned>, production_type> &table,
             variable_type V, terminal_type a, production_type p,
             const std::vector<bool> &nullable,
-            const std::vector<std::vector<bool> *> &first,
-            const std::vector<std::vector<bool> *> &follow
+            const bit_matrix_type &first,
+            const bit_matrix_type &follow
         ) throw() {
             std::pair<unsigned, unsigned> cell(V.number(), a.number());
 
@@ -230,6 +245,504 @@ namespace grail { namespace cli {
             return true;
         }
 
+        typedef cfg::CompiledGrammar<AlphaT> grammar_type;
+        typedef typename grammar_type::symbol_id_type symbol_id_type;
+        typedef cfg::LL1Table<AlphaT> table_type;
+
+        /// the smallest unsigned C++ type that can hold values up to max
+        static const char *unsigned_type(const unsigned long max) throw() {
+            if(max <= UCHAR_MAX) {
+                return "unsigned char";
+            } else if(max <= USHRT_MAX) {
+                return "unsigned short";
+            }
+            return "unsigned";
+        }
+
+        /// the FNV-1a hash of a lexeme; the generated parser hashes tokens
+        /// in the same way
+        static unsigned hash_lexeme(const char *str, const unsigned len) throw() {
+            uint32_t h(2166136261U);
+            for(unsigned i(0); i < len; ++i) {
+                h ^= static_cast<unsigned char>(str[i]);
+                h *= 16777619U;
+            }
+            return static_cast<unsigned>(h);
+        }
+
+        /// print out a C string literal
+        static void fprint_string(FILE *outfile, const char *str) throw() {
+            fputc('"', outfile);
+            for(const unsigned char *ch(
+                    reinterpret_cast<const unsigned char *>(str)
+                );
+                '\0' != *ch;
+                ++ch) {
+
+                if('"' == *ch || '\\' == *ch) {
+                    fprintf(outfile, "\\%c", *ch);
+                } else if(' ' <= *ch && *ch < 127) {
+                    fputc(*ch, outfile);
+                } else {
+                    fprintf(outfile, "\\%03o", *ch);
+                }
+            }
+            fputc('"', outfile);
+        }
+
+        /// print out an array of unsigned numbers
+        static void fprint_array(
+            FILE *outfile,
+            const char *name,
+            const std::vector<unsigned> &values
+        ) throw() {
+            unsigned long max(0);
+            for(unsigned i(0); i < values.size(); ++i) {
+                if(max < values[i]) {
+                    max = values[i];
+                }
+            }
+
+            fprintf(outfile,
+                "static const %s %s[%u] = {",
+                unsigned_type(max),
+                name,
+                static_cast<unsigned>(values.size())
+            );
+
+            for(unsigned i(0); i < values.size(); ++i) {
+                fprintf(outfile,
+                    "%s%u",
+                    0 == i ? "\n    " : (0 == i % 12U ? ",\n    " : ", "),
+                    values[i]
+                );
+            }
+
+            fprintf(outfile, "\n};\n\n");
+        }
+
+        /// write out a switch-threaded LL(1) parser. the parser keeps its
+        /// stack in a fixed-size array, looks productions up in the
+        /// row-displaced table built by LL1Table, pushes the symbols of each
+        /// production with straight-line code, and reads tokens through a
+        /// buffer, mapping them to terminal ids with a hash table. if the
+        /// grammar has variable terminals then tokens that are not terminals
+        /// get the id UNKNOWN_TERMINAL, which is looked up in the table's
+        /// variable terminal column, like in the ll1 engine of cfg-parse.
+        static void emit_fast(
+            cfg_type &cfg,
+            const std::vector<bool> &nullable,
+            const bit_matrix_type &first,
+            const bit_matrix_type &follow,
+            FILE *outfile
+        ) throw() {
+            const grammar_type grammar(cfg, nullable);
+            const table_type table(grammar, first, follow);
+            const fltl::helper::PackedTable &packed(table.packed_table());
+
+            for(unsigned i(0); i < table.conflicts.size(); ++i) {
+                const typename table_type::conflict_type &conflict(
+                    table.conflicts[i]
+                );
+
+                io::warning(
+                    "The following two productions conflict when trying to "
+                    "decide which production of '%s' to parse on input '%s'. "
+                    "Production #0 has been chosen.",
+                    cfg.get_name(grammar.variables[conflict.variable]),
+                    0 == conflict.terminal
+                        ? "<end of input>"
+                        : terminal_rep(cfg, grammar.terminals[conflict.terminal])
+                );
+
+                fprintf(stderr, "         #0: ");
+                io::fprint(stderr, cfg, grammar.productions[conflict.chosen]);
+                fprintf(stderr, "         #1: ");
+                io::fprint(stderr, cfg, grammar.productions[conflict.rejected]);
+                fprintf(stderr, "\n");
+            }
+
+            // the UNKNOWN_TERMINAL column; ambiguous cells are dropped
+            const bool has_variable_terminals(table.has_variable_terminals());
+            std::vector<unsigned> unknown_production(
+                grammar.num_variables,
+                grammar.num_productions()
+            );
+            std::vector<unsigned> is_variable_terminal(grammar.num_terminals, 0U);
+
+            for(unsigned t(1U); t < grammar.num_terminals; ++t) {
+                if(grammar.is_variable_terminal[t]) {
+                    is_variable_terminal[t] = 1U;
+                }
+            }
+
+            for(unsigned v(0); v < grammar.num_variables; ++v) {
+                if(!has_variable_terminals) {
+                    break;
+                }
+
+                const unsigned p(table.production(
+                    v,
+                    table_type::UNKNOWN_TERMINAL
+                ));
+
+                if(table_type::AMBIGUOUS_PRODUCTION == p) {
+                    io::warning(
+                        "Different variable terminals select different "
+                        "productions of '%s', so tokens that are not terminals "
+                        "of the grammar will be rejected when expanding it.",
+                        cfg.get_name(grammar.variables[v])
+                    );
+                } else if(table_type::NO_PRODUCTION != p) {
+                    unknown_production[v] = p;
+                }
+            }
+
+            // the packed table; unused entries are owned by no row
+            const unsigned num_entries(packed.num_entries());
+            std::vector<unsigned> base(grammar.num_variables, 0U);
+            std::vector<unsigned> check(num_entries, num_entries);
+            std::vector<unsigned> production(num_entries, 0U);
+
+            for(unsigned v(0); v < grammar.num_variables; ++v) {
+                base[v] = packed.row_offset(v);
+            }
+
+            for(unsigned i(0); i < num_entries; ++i) {
+                const unsigned p(packed.entry_value(i));
+                if(table_type::NO_PRODUCTION != p) {
+                    check[i] = packed.entry_row(i);
+                    production[i] = p;
+                }
+            }
+
+            // open-addressed hash table of the terminals, keyed by their
+            // lexemes. variable terminals have no lexeme.
+            unsigned num_slots(8U);
+            for(; num_slots < grammar.num_terminals * 2U; num_slots *= 2U) {
+                // at most half full
+            }
+
+            std::vector<unsigned> slots(num_slots, 0U);
+            std::vector<unsigned> lengths(grammar.num_terminals, 0U);
+
+            for(unsigned t(1U); t < grammar.num_terminals; ++t) {
+                if(grammar.is_variable_terminal[t]) {
+                    continue;
+                }
+
+                const char *lexeme(terminal_rep(cfg, grammar.terminals[t]));
+                lengths[t] = static_cast<unsigned>(strlen(lexeme));
+
+                unsigned slot(hash_lexeme(lexeme, lengths[t]) & (num_slots - 1U));
+                for(; 0 != slots[slot]; slot = (slot + 1U) & (num_slots - 1U)) {
+                    // linear probe
+                }
+                slots[slot] = t;
+            }
+
+            unsigned long max_symbol(grammar.num_terminals);
+            if(max_symbol < grammar.num_variables) {
+                max_symbol = grammar.num_variables;
+            }
+
+            fprintf(outfile,
+                "// LL(1) parser, outputted by Grail+ (http://www.grailplus.org)\n"
+                "//\n"
+                "// The parser is switch-threaded: the production that expands a\n"
+                "// variable is looked up in a table compressed by row displacement,\n"
+                "// and each case of the switch pushes the symbols of one production.\n"
+                "// The stack has a fixed capacity of LL1_STACK_SIZE symbols. Tokens\n"
+                "// are separated by new lines and are read through a buffer of\n"
+                "// LL1_BUFFER_SIZE bytes. Define LL1_MAIN to get a main function that\n"
+                "// parses standard input.\n"
+                "#include <cstdio>\n"
+                "#include <cstring>\n\n"
+                "#ifndef LL1_STACK_SIZE\n"
+                "#   define LL1_STACK_SIZE 4096U\n"
+                "#endif\n\n"
+                "#ifndef LL1_BUFFER_SIZE\n"
+                "#   define LL1_BUFFER_SIZE 65536U\n"
+                "#endif\n\n"
+                "namespace ll1 {\n\n"
+                "enum {\n"
+                "    END_OF_INPUT = 0,\n"
+                "    UNKNOWN_TOKEN = -1,\n"
+                "    NUM_TERMINALS = %u,\n"
+                "    NUM_LEXEME_SLOTS = %u\n"
+                "};\n\n",
+                grammar.num_terminals,
+                num_slots
+            );
+
+            if(has_variable_terminals) {
+                fprintf(outfile,
+                    "// the id of tokens that are not terminals; they match any\n"
+                    "// variable terminal\n"
+                    "enum {\n"
+                    "    UNKNOWN_TERMINAL = NUM_TERMINALS\n"
+                    "};\n\n"
+                );
+            }
+
+            fprintf(outfile, "// terminal id | terminal\n");
+
+            for(unsigned t(1U); t < grammar.num_terminals; ++t) {
+                fprintf(outfile,
+                    "// %11u | %s%s\n",
+                    t,
+                    terminal_rep(cfg, grammar.terminals[t]),
+                    grammar.is_variable_terminal[t] ? " (variable terminal)" : ""
+                );
+            }
+
+            fprintf(outfile,
+                "\n"
+                "// stack symbols: variables are positive, terminals are negative\n"
+                "typedef %s symbol_type;\n\n"
+                "// the production that expands variable A on terminal a is\n"
+                "// production[base[A] + a] if check[base[A] + a] == base[A]\n",
+                max_symbol <= SCHAR_MAX
+                    ? "signed char"
+                    : (max_symbol <= SHRT_MAX ? "short" : "int")
+            );
+
+            fprint_array(outfile, "base", base);
+            fprint_array(outfile, "check", check);
+            fprint_array(outfile, "production", production);
+            fprint_array(outfile, "lexeme_slots", slots);
+            fprint_array(outfile, "lexeme_lengths", lengths);
+
+            if(has_variable_terminals) {
+                fprintf(outfile,
+                    "// the production that expands variable A on UNKNOWN_TERMINAL\n"
+                    "// is unknown_production[A]\n"
+                );
+                fprint_array(outfile, "unknown_production", unknown_production);
+                fprint_array(outfile, "is_variable_terminal", is_variable_terminal);
+            }
+
+            fprintf(outfile,
+                "static const char * const lexemes[NUM_TERMINALS] = {\n"
+                "    0"
+            );
+
+            for(unsigned t(1U); t < grammar.num_terminals; ++t) {
+                fprintf(outfile, ",\n    ");
+                if(grammar.is_variable_terminal[t]) {
+                    fprintf(outfile, "0");
+                } else {
+                    fprint_string(outfile, terminal_rep(cfg, grammar.terminals[t]));
+                }
+            }
+
+            fprintf(outfile,
+                "\n};\n\n"
+                "// the id of the terminal with some lexeme, or %s\n"
+                "static inline int find_terminal(const char *str, const unsigned len) {\n"
+                "    unsigned h(2166136261U);\n"
+                "    for(unsigned i(0); i < len; ++i) {\n"
+                "        h ^= static_cast<unsigned char>(str[i]);\n"
+                "        h = (h * 16777619U) & 0xFFFFFFFFU;\n"
+                "    }\n"
+                "    for(unsigned slot(h & (NUM_LEXEME_SLOTS - 1U)); ;\n"
+                "        slot = (slot + 1U) & (NUM_LEXEME_SLOTS - 1U)) {\n"
+                "        const unsigned t(lexeme_slots[slot]);\n"
+                "        if(0U == t) {\n"
+                "            return %s;\n"
+                "        } else if(len == lexeme_lengths[t]\n"
+                "               && 0 == memcmp(str, lexemes[t], len)) {\n"
+                "            return static_cast<int>(t);\n"
+                "        }\n"
+                "    }\n"
+                "}\n\n"
+                "// reads new line-separated tokens from a file through a buffer\n"
+                "class token_reader {\n"
+                "public:\n"
+                "    explicit token_reader(FILE *fp_)\n"
+                "        : fp(fp_)\n"
+                "        , begin(0)\n"
+                "        , end(0)\n"
+                "        , at_eof(false)\n"
+                "    { }\n\n"
+                "    // the terminal id of the next token, END_OF_INPUT if there are\n"
+                "    // no more tokens, or UNKNOWN_TOKEN\n"
+                "    int next(void) {\n"
+                "        for(;;) {\n"
+                "            for(; begin < end && is_delim(buffer[begin]); ++begin) { }\n\n"
+                "            unsigned stop(begin);\n"
+                "            for(; stop < end && !is_delim(buffer[stop]); ++stop) { }\n\n"
+                "            if(stop < end || (at_eof && begin < end)) {\n"
+                "                const char *token(&(buffer[begin]));\n"
+                "                const unsigned len(stop - begin);\n"
+                "                begin = stop;\n"
+                "                return find_terminal(token, len);\n"
+                "            } else if(at_eof) {\n"
+                "                return END_OF_INPUT;\n"
+                "            } else if(0U == begin && LL1_BUFFER_SIZE == end) {\n"
+                "                return UNKNOWN_TOKEN;\n"
+                "            }\n\n"
+                "            memmove(buffer, &(buffer[begin]), end - begin);\n"
+                "            end -= begin;\n"
+                "            begin = 0;\n\n"
+                "            const size_t got(fread(\n"
+                "                &(buffer[end]), 1U, LL1_BUFFER_SIZE - end, fp\n"
+                "            ));\n"
+                "            end += static_cast<unsigned>(got);\n"
+                "            at_eof = 0U == got;\n"
+                "        }\n"
+                "    }\n\n"
+                "private:\n"
+                "    static bool is_delim(const char ch) {\n"
+                "        return '\\n' == ch || '\\r' == ch;\n"
+                "    }\n\n"
+                "    FILE *fp;\n"
+                "    unsigned begin;\n"
+                "    unsigned end;\n"
+                "    bool at_eof;\n"
+                "    char buffer[LL1_BUFFER_SIZE];\n"
+                "};\n\n"
+                "// parse the tokens of a reader, which is anything with a next()\n"
+                "// function that returns terminal ids like token_reader\n"
+                "template <typename ReaderT>\n"
+                "bool parse(ReaderT &reader) {\n",
+                has_variable_terminals ? "UNKNOWN_TERMINAL" : "UNKNOWN_TOKEN",
+                has_variable_terminals ? "UNKNOWN_TERMINAL" : "UNKNOWN_TOKEN"
+            );
+
+            if(0 == grammar.num_items()) {
+                fprintf(outfile,
+                    "    return END_OF_INPUT == reader.next();\n"
+                    "}\n\n"
+                );
+                goto emit_main;
+            }
+
+            fprintf(outfile,
+                "    symbol_type stack[LL1_STACK_SIZE];\n"
+                "    unsigned top(0);\n"
+                "    stack[top++] = %d; // %s\n\n"
+                "    int a(reader.next());\n\n"
+                "    while(0U != top) {\n"
+                "        const int X(stack[--top]);\n\n",
+                static_cast<int>(grammar.item_symbol[grammar.start_item]),
+                cfg.get_name(cfg.get_start_variable())
+            );
+
+            if(has_variable_terminals) {
+                fprintf(outfile,
+                    "        if(0 > X) {\n"
+                    "            if(-X != a && (UNKNOWN_TERMINAL != a\n"
+                    "                        || !is_variable_terminal[-X])) {\n"
+                    "                return false;\n"
+                    "            }\n"
+                    "            a = reader.next();\n"
+                    "            continue;\n"
+                    "        } else if(0 > a) {\n"
+                    "            return false;\n"
+                    "        }\n\n"
+                    "        unsigned p(unknown_production[X]);\n"
+                    "        if(UNKNOWN_TERMINAL != a) {\n"
+                    "            const unsigned offset(base[X]);\n"
+                    "            if(offset != check[offset + a]) {\n"
+                    "                return false;\n"
+                    "            }\n"
+                    "            p = production[offset + a];\n"
+                    "        }\n\n"
+                    "        switch(p) {\n"
+                );
+            } else {
+                fprintf(outfile,
+                    "        if(0 > X) {\n"
+                    "            if(-X != a) {\n"
+                    "                return false;\n"
+                    "            }\n"
+                    "            a = reader.next();\n"
+                    "            continue;\n"
+                    "        } else if(0 > a) {\n"
+                    "            return false;\n"
+                    "        }\n\n"
+                    "        const unsigned offset(base[X]);\n"
+                    "        if(offset != check[offset + a]) {\n"
+                    "            return false;\n"
+                    "        }\n\n"
+                    "        switch(production[offset + a]) {\n"
+                );
+            }
+
+            for(unsigned p(0); p < grammar.num_productions(); ++p) {
+                const unsigned first_item(grammar.production_item[p]);
+                const unsigned last_item(grammar.production_item[p + 1U] - 1U);
+                unsigned first_pushed(first_item);
+
+                fprintf(outfile, "        // ");
+                io::fprint(outfile, cfg, grammar.productions[p]);
+                fprintf(outfile, "        case %uU:\n", p);
+
+                // the production was chosen on its first terminal, so that
+                // terminal is matched without going through the stack
+                const bool starts_with_terminal(
+                    first_item < last_item && 0 > grammar.item_symbol[first_item]
+                );
+                if(starts_with_terminal) {
+                    ++first_pushed;
+                }
+
+                if(first_pushed < last_item) {
+                    fprintf(outfile,
+                        "            if(LL1_STACK_SIZE - top < %uU) {\n"
+                        "                return false;\n"
+                        "            }\n",
+                        last_item - first_pushed
+                    );
+                }
+
+                for(unsigned item(last_item); item-- > first_pushed; ) {
+                    const symbol_id_type sym(grammar.item_symbol[item]);
+                    fprintf(outfile,
+                        "            stack[top++] = %d; // %s\n",
+                        static_cast<int>(sym),
+                        0 > sym
+                            ? terminal_rep(
+                                cfg,
+                                grammar.terminals[static_cast<unsigned>(-sym)]
+                              )
+                            : cfg.get_name(
+                                grammar.variables[static_cast<unsigned>(sym)]
+                              )
+                    );
+                }
+
+                if(starts_with_terminal) {
+                    fprintf(outfile, "            a = reader.next();\n");
+                }
+
+                fprintf(outfile, "            break;\n");
+            }
+
+            fprintf(outfile,
+                "        default:\n"
+                "            return false;\n"
+                "        }\n"
+                "    }\n\n"
+                "    return END_OF_INPUT == a;\n"
+                "}\n\n"
+            );
+
+        emit_main:
+
+            fprintf(outfile,
+                "} // namespace ll1\n\n"
+                "#ifdef LL1_MAIN\n"
+                "int main(void) {\n"
+                "    static ll1::token_reader reader(stdin);\n"
+                "    printf(\"%%s\\n\", ll1::parse(reader) ? \"Yes.\" : \"No.\");\n"
+                "    return 0;\n"
+                "}\n"
+                "#endif\n"
+            );
+        }
+
         static int main(io::CommandLineOptions &options) throw() {
 
             using fltl::CFG;
@@ -261,8 +774,8 @@ namespace grail { namespace cli {
             std::map<std::pair<unsigned, unsigned>, production_type> table;
 
             std::vector<bool> nullable;
-            std::vector<std::vector<bool> *> first;
-            std::vector<std::vector<bool> *> follow;
+            bit_matrix_type first;
+            bit_matrix_type follow;
 
             // add numberings to the productions
             production_type prod;
@@ -276,7 +789,19 @@ namespace grail { namespace cli {
             generator_type As(cfg.search(~A));
             generator_type as(cfg.search(~a));
             generator_type A_related(cfg.search(~prod, A --->* ~w));
-            std::vector<bool> empty_set;
+            fltl::helper::BitSet empty_set;
+
+            // the productions of A, and for each one, either the set of
+            // lookaheads that select it or the terminal that begins it
+            std::vector<production_type> A_prods;
+            std::vector<const word_type *> A_checks;
+            std::vector<unsigned> A_terminals;
+
+            io::option_type fast(options["fast"]);
+            io::option_type cache_dir(options["cache"]);
+            const grail::cfg::AnalysisCache cache(
+                cache_dir.is_valid() ? cache_dir.value() : 0
+            );
 
             // can't bring in the cfg :(
             if(!io::fread(fp, cfg, file_name)) {
@@ -285,43 +810,57 @@ namespace grail { namespace cli {
             }
 
             // empty set of all terminals
-            empty_set.assign(cfg.num_terminals() + 2, false);
+            empty_set.resize(cfg.num_terminals() + 2);
 
-            grail::cfg::compute_null_set(cfg, nullable);
-            grail::cfg::compute_first_terminals(cfg, nullable, first);
-            grail::cfg::compute_follow_set(cfg, nullable, first, follow);
+            grail::cfg::compute_cached_sets(cfg, cache, nullable, first, follow);
+
+            if(fast.is_valid()) {
+                emit_fast(cfg, nullable, first, follow, outfile);
+                goto done;
+            }
 
             for(; As.match_next(); ) {
-                for(as.rewind(); as.match_next(); ) {
-                    for(A_related.rewind(); A_related.match_next(); ) {
+                A_prods.clear();
+                A_checks.clear();
+                A_terminals.clear();
 
-                        // easy case
-                        if(w.is_empty()) {
-                            if(in_follow(follow, A, a)) {
-                                add_to_table(cfg, table, A, a, prod, nullable, first, follow);
-                            }
+                for(A_related.rewind(); A_related.match_next(); ) {
+                    const word_type *check_set(empty_set.data());
+                    unsigned first_terminal(0);
 
-                        // tricky case, need to check nullability
-                        } else if(w.at(0).is_variable()) {
+                    // easy case
+                    if(w.is_empty()) {
+                        check_set = follow.row(A.number());
 
-                            variable_type W(w.at(0));
-                            std::vector<bool> *check_set(&empty_set);
+                    // tricky case, need to check nullability
+                    } else if(w.at(0).is_variable()) {
+                        variable_type W(w.at(0));
 
-                            // succeed quickly
-                            if(!nullable[W.number()]) {
-                                check_set = first[W.number()];
+                        // succeed quickly
+                        if(!nullable[W.number()]) {
+                            check_set = first.row(W.number());
 
-                            } else if(all_nullable(nullable, w)){
-                                check_set = follow[W.number()];
-                            }
+                        } else if(all_nullable(nullable, w)){
+                            check_set = follow.row(W.number());
+                        }
 
-                            if(check_set->at(a.number())) {
-                                add_to_table(cfg, table, A, a, prod, nullable, first, follow);
-                            }
+                    // terminal, only care about if it's the one we want
+                    } else {
+                        check_set = 0;
+                        first_terminal = terminal_type(w.at(0)).number();
+                    }
+
+                    A_prods.push_back(prod);
+                    A_checks.push_back(check_set);
+                    A_terminals.push_back(first_terminal);
+                }
 
-                        // terminal, only care about if it's the one we want
-                        } else if(w.at(0) == a) {
-                            add_to_table(cfg, table, A, a, prod, nullable, first, follow);
+                for(as.rewind(); as.match_next(); ) {
+                    for(unsigned i(0); i < A_prods.size(); ++i) {
+                        if(0 == A_checks[i]
+                            ? A_terminals[i] == a.number()
+                            : bit_matrix_type::test(A_checks[i], a.number())) {
+                            add_to_table(cfg, table, A, a, A_prods[i], nullable, first, follow);
                         }
                     }
                 }
@@ -501,17 +1040,6 @@ namespace grail { namespace cli {
 
             table.clear();
 
-            for(unsigned i(0); i < first.size(); ++i) {
-                delete first[i];
-                delete follow[i];
-
-                first[i] = 0;
-                follow[i] = 0;
-            }
-
-            first.clear();
-            follow.clear();
-
             return ret;
         }
     };
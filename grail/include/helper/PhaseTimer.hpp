@@ -0,0 +1,98 @@
+/*
+ * PhaseTimer.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_PHASETIMER_HPP_
+#define Grail_Plus_PHASETIMER_HPP_
+
+#include <cstring>
+
+#include <sys/time.h>
+
+#include "fltl/include/trait/Uncopyable.hpp"
+
+#include "grail/include/io/StatsPrinter.hpp"
+
+namespace grail { namespace helper {
+
+    /// measures the wall-clock time spent in each phase of a tool. only one
+    /// phase runs at a time; starting a phase stops the current one, and
+    /// starting a phase again adds to the time already spent in it.
+    class PhaseTimer : private fltl::trait::Uncopyable {
+    private:
+
+        enum {
+            MAX_NUM_PHASES = 16
+        };
+
+        const char *names[MAX_NUM_PHASES];
+        double seconds[MAX_NUM_PHASES];
+        unsigned num_phases;
+        unsigned current;
+        double started_at;
+
+        static double now(void) throw() {
+            struct timeval tv;
+            gettimeofday(&tv, 0);
+            return static_cast<double>(tv.tv_sec)
+                 + static_cast<double>(tv.tv_usec) / 1e6;
+        }
+
+    public:
+
+        PhaseTimer(void) throw()
+            : num_phases(0)
+            , current(MAX_NUM_PHASES)
+            , started_at(0.0)
+        { }
+
+        /// stop the current phase, if any, and start the named one. the
+        /// name must outlive the timer.
+        void start(const char *name) throw() {
+            stop();
+
+            for(current = 0; current < num_phases; ++current) {
+                if(0 == strcmp(name, names[current])) {
+                    break;
+                }
+            }
+
+            if(current == num_phases) {
+                if(MAX_NUM_PHASES == num_phases) {
+                    current = MAX_NUM_PHASES;
+                    return;
+                }
+                names[num_phases] = name;
+                seconds[num_phases] = 0.0;
+                ++num_phases;
+            }
+
+            started_at = now();
+        }
+
+        /// stop the current phase
+        void stop(void) throw() {
+            if(MAX_NUM_PHASES != current) {
+                seconds[current] += now() - started_at;
+                current = MAX_NUM_PHASES;
+            }
+        }
+
+        /// print out the time spent in each phase, in the order that the
+        /// phases were first started
+        void print(io::StatsPrinter &printer) const throw() {
+            printer.begin_group("seconds");
+            for(unsigned i(0); i < num_phases; ++i) {
+                printer.field(names[i], seconds[i]);
+            }
+            printer.end_group();
+        }
+    };
+}}
+
+#endif /* Grail_Plus_PHASETIMER_HPP_ */
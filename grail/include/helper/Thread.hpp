@@ -0,0 +1,280 @@
+/*
+ * Thread.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_THREAD_HPP_
+#define Grail_Plus_THREAD_HPP_
+
+#include <pthread.h>
+
+#include "fltl/include/trait/Uncopyable.hpp"
+
+namespace grail { namespace helper {
+
+    /// a mutual exclusion lock
+    class Mutex : private fltl::trait::Uncopyable {
+    private:
+
+        friend class Condition;
+
+        pthread_mutex_t mutex;
+
+    public:
+
+        Mutex(void) throw() {
+            pthread_mutex_init(&mutex, 0);
+        }
+
+        ~Mutex(void) throw() {
+            pthread_mutex_destroy(&mutex);
+        }
+
+        inline void lock(void) throw() {
+            pthread_mutex_lock(&mutex);
+        }
+
+        inline void unlock(void) throw() {
+            pthread_mutex_unlock(&mutex);
+        }
+    };
+
+    /// a condition variable that is always used with some mutex
+    class Condition : private fltl::trait::Uncopyable {
+    private:
+
+        pthread_cond_t cond;
+
+    public:
+
+        Condition(void) throw() {
+            pthread_cond_init(&cond, 0);
+        }
+
+        ~Condition(void) throw() {
+            pthread_cond_destroy(&cond);
+        }
+
+        /// wait on the condition; the mutex must be locked
+        inline void wait(Mutex &mutex) throw() {
+            pthread_cond_wait(&cond, &(mutex.mutex));
+        }
+
+        inline void signal(void) throw() {
+            pthread_cond_signal(&cond);
+        }
+
+        inline void broadcast(void) throw() {
+            pthread_cond_broadcast(&cond);
+        }
+    };
+
+    /// a reusable barrier for a fixed number of threads. every thread that
+    /// waits on the barrier is blocked until all threads have arrived.
+    class Barrier : private fltl::trait::Uncopyable {
+    private:
+
+        Mutex mutex;
+        Condition all_arrived;
+        unsigned num_threads;
+        unsigned num_waiting;
+        unsigned generation;
+
+    public:
+
+        explicit Barrier(const unsigned num_threads_) throw()
+            : mutex()
+            , all_arrived()
+            , num_threads(num_threads_)
+            , num_waiting(0)
+            , generation(0)
+        { }
+
+        void wait(void) throw() {
+            mutex.lock();
+            const unsigned curr_generation(generation);
+
+            if(num_threads == ++num_waiting) {
+                release();
+            } else {
+                for(; curr_generation == generation; ) {
+                    all_arrived.wait(mutex);
+                }
+            }
+
+            mutex.unlock();
+        }
+
+        /// permanently remove one thread from the barrier, e.g. because it
+        /// could not be started.
+        void leave(void) throw() {
+            mutex.lock();
+            --num_threads;
+            if(0 < num_waiting && num_threads == num_waiting) {
+                release();
+            }
+            mutex.unlock();
+        }
+
+    private:
+
+        void release(void) throw() {
+            num_waiting = 0;
+            ++generation;
+            all_arrived.broadcast();
+        }
+    };
+
+    /// hands out the tasks 0 to num_tasks - 1 to a fixed number of
+    /// workers. each worker starts with its own contiguous block of tasks
+    /// and takes them from the front. a worker whose block runs dry steals
+    /// the back half of another worker's block, so that workers that drew
+    /// cheap tasks help out the ones that drew expensive tasks.
+    class TaskPool : private fltl::trait::Uncopyable {
+    private:
+
+        class block_type {
+        public:
+            Mutex mutex;
+            unsigned begin;
+            unsigned end;
+
+            block_type(void) throw()
+                : mutex()
+                , begin(0)
+                , end(0)
+            { }
+        };
+
+        block_type *blocks;
+        const unsigned num_workers;
+
+        /// try to take the back half of the victim's block. the victim's
+        /// lock is released before the thief's own block is refilled, so
+        /// that no worker ever holds two locks.
+        bool steal(const unsigned thief, const unsigned victim) throw() {
+            block_type &from(blocks[victim]);
+
+            from.mutex.lock();
+            const unsigned end(from.end);
+            const unsigned half((end - from.begin + 1U) / 2U);
+            from.end -= half;
+            from.mutex.unlock();
+
+            if(0 == half) {
+                return false;
+            }
+
+            block_type &to(blocks[thief]);
+            to.mutex.lock();
+            to.begin = end - half;
+            to.end = end;
+            to.mutex.unlock();
+
+            return true;
+        }
+
+    public:
+
+        TaskPool(const unsigned num_tasks, const unsigned num_workers_) throw()
+            : blocks(new block_type[num_workers_])
+            , num_workers(num_workers_)
+        {
+            for(unsigned w(0); w < num_workers; ++w) {
+                blocks[w].begin = static_cast<unsigned>(
+                    (static_cast<unsigned long>(num_tasks) * w) / num_workers
+                );
+                blocks[w].end = static_cast<unsigned>(
+                    (static_cast<unsigned long>(num_tasks) * (w + 1U))
+                    / num_workers
+                );
+            }
+        }
+
+        ~TaskPool(void) throw() {
+            delete [] blocks;
+            blocks = 0;
+        }
+
+        /// get the next task of a worker. returns false once there are no
+        /// tasks left to do or to steal.
+        bool next(const unsigned worker, unsigned &task) throw() {
+            for(;;) {
+                block_type &own(blocks[worker]);
+
+                own.mutex.lock();
+                if(own.begin < own.end) {
+                    task = own.begin++;
+                    own.mutex.unlock();
+                    return true;
+                }
+                own.mutex.unlock();
+
+                bool stole(false);
+                for(unsigned i(1U); !stole && i < num_workers; ++i) {
+                    stole = steal(worker, (worker + i) % num_workers);
+                }
+
+                if(!stole) {
+                    return false;
+                }
+            }
+        }
+    };
+
+    /// run a function on a new thread. the thread is joined either
+    /// explicitly or when the thread object is destroyed.
+    class Thread : private fltl::trait::Uncopyable {
+    public:
+
+        typedef void (func_type)(void *);
+
+    private:
+
+        pthread_t thread;
+        func_type *func;
+        void *arg;
+        bool is_running;
+
+        static void *run(void *self_) throw() {
+            Thread *self(reinterpret_cast<Thread *>(self_));
+            self->func(self->arg);
+            return 0;
+        }
+
+    public:
+
+        Thread(void) throw()
+            : thread()
+            , func(0)
+            , arg(0)
+            , is_running(false)
+        { }
+
+        ~Thread(void) throw() {
+            join();
+        }
+
+        /// start running func(arg) on a new thread; returns false if the
+        /// thread could not be created.
+        bool start(func_type *func_, void *arg_) throw() {
+            func = func_;
+            arg = arg_;
+            is_running = 0 == pthread_create(&thread, 0, &run, this);
+            return is_running;
+        }
+
+        void join(void) throw() {
+            if(is_running) {
+                pthread_join(thread, 0);
+                is_running = false;
+            }
+        }
+    };
+}}
+
+#endif /* Grail_Plus_THREAD_HPP_ */
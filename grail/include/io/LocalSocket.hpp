@@ -0,0 +1,148 @@
+/*
+ * LocalSocket.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_LOCALSOCKET_HPP_
+#define Grail_Plus_LOCALSOCKET_HPP_
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace grail { namespace io {
+
+    namespace detail {
+
+        /// fill in the address of a Unix domain socket; returns false if
+        /// the path is too long
+        inline bool make_local_address(
+            const char *path,
+            struct sockaddr_un &addr
+        ) throw() {
+            memset(&addr, 0, sizeof addr);
+            addr.sun_family = AF_UNIX;
+
+            if(strlen(path) >= sizeof addr.sun_path) {
+                return false;
+            }
+
+            strcpy(addr.sun_path, path);
+            return true;
+        }
+    }
+
+    /// is there a file at path that is not a socket? such a file is never
+    /// replaced by local_listen.
+    inline bool is_non_socket(const char *path) throw() {
+        struct stat info;
+        return 0 == lstat(path, &info) && !S_ISSOCK(info.st_mode);
+    }
+
+    /// listen for connections on a Unix domain socket bound to path. a
+    /// stale socket file at path is replaced, but any other kind of file
+    /// is left alone and the socket is not set up. the identity of the
+    /// bound socket file is put into bound, so that local_unlink can later
+    /// remove exactly that file. returns the socket, or -1 if it could not
+    /// be set up.
+    inline int local_listen(
+        const char *path,
+        const int backlog,
+        struct stat &bound
+    ) throw() {
+        struct sockaddr_un addr;
+        if(!detail::make_local_address(path, addr)) {
+            return -1;
+        }
+
+        struct stat info;
+        if(0 == lstat(path, &info)) {
+            if(!S_ISSOCK(info.st_mode)) {
+                return -1;
+            }
+            unlink(path);
+        }
+
+        const int fd(socket(AF_UNIX, SOCK_STREAM, 0));
+        if(0 > fd) {
+            return -1;
+        }
+
+        if(0 != bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof addr)
+        || 0 != listen(fd, backlog)
+        || 0 != lstat(path, &bound)) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    /// remove the socket file that local_listen bound, unless it has since
+    /// been replaced by some other file
+    inline void local_unlink(const char *path, const struct stat &bound) throw() {
+        struct stat info;
+        if(0 == lstat(path, &info)
+        && S_ISSOCK(info.st_mode)
+        && info.st_dev == bound.st_dev
+        && info.st_ino == bound.st_ino) {
+            unlink(path);
+        }
+    }
+
+    /// connect to a Unix domain socket bound to path. returns the socket,
+    /// or -1 if the connection could not be made.
+    inline int local_connect(const char *path) throw() {
+        struct sockaddr_un addr;
+        if(!detail::make_local_address(path, addr)) {
+            return -1;
+        }
+
+        const int fd(socket(AF_UNIX, SOCK_STREAM, 0));
+        if(0 > fd) {
+            return -1;
+        }
+
+        if(0 != connect(
+            fd,
+            reinterpret_cast<struct sockaddr *>(&addr),
+            sizeof addr
+        )) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    /// write all of a buffer to a socket or file descriptor, retrying
+    /// after short writes and interruptions
+    inline bool write_all(
+        const int fd,
+        const char *data,
+        const size_t size
+    ) throw() {
+        for(size_t written(0); written < size; ) {
+            const ssize_t amount(write(fd, data + written, size - written));
+            if(0 > amount) {
+                if(EINTR == errno) {
+                    continue;
+                }
+                return false;
+            }
+            written += static_cast<size_t>(amount);
+        }
+        return true;
+    }
+}}
+
+#endif /* Grail_Plus_LOCALSOCKET_HPP_ */
@@ -0,0 +1,146 @@
+/*
+ * StatsPrinter.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *     Version: $Id$
+ */
+
+
+#ifndef Grail_Plus_STATSPRINTER_HPP_
+#define Grail_Plus_STATSPRINTER_HPP_
+
+#include <cctype>
+#include <cstdio>
+
+#include "fltl/include/trait/Uncopyable.hpp"
+
+namespace grail { namespace io {
+
+    /// prints out named counters, either as "label: value" lines or as a
+    /// JSON object. the JSON key of a counter is its label in lower case,
+    /// with spaces replaced by underscores, so that both forms are made by
+    /// the same calls. counters can be grouped into nested objects.
+    class StatsPrinter : private fltl::trait::Uncopyable {
+    private:
+
+        FILE *fp;
+        const bool as_json;
+        unsigned depth;
+        bool need_comma;
+
+        /// start a new counter, or group of counters
+        void begin_entry(const char *label) throw() {
+            if(!as_json) {
+                for(unsigned i(1U); i < depth; ++i) {
+                    fputs("  ", fp);
+                }
+                fprintf(fp, "%s:", label);
+                return;
+            }
+
+            fputs(need_comma ? ",\n" : "\n", fp);
+            for(unsigned i(0); i < depth; ++i) {
+                fputs("  ", fp);
+            }
+
+            fputc('"', fp);
+            for(const char *ch(label); '\0' != *ch; ++ch) {
+                if(' ' == *ch || '-' == *ch) {
+                    fputc('_', fp);
+                } else {
+                    fputc(tolower(static_cast<unsigned char>(*ch)), fp);
+                }
+            }
+            fputs("\": ", fp);
+            need_comma = true;
+        }
+
+    public:
+
+        StatsPrinter(FILE *fp_, const bool as_json_) throw()
+            : fp(fp_)
+            , as_json(as_json_)
+            , depth(0)
+            , need_comma(false)
+        { }
+
+        /// start the counters
+        void begin(void) throw() {
+            begin_group(0);
+        }
+
+        /// finish printing the counters
+        void end(void) throw() {
+            end_group();
+        }
+
+        /// start a group of counters; a null label starts the outermost
+        /// group
+        void begin_group(const char *label) throw() {
+            if(0 != label) {
+                begin_entry(label);
+                if(!as_json) {
+                    fputc('\n', fp);
+                }
+            }
+
+            if(as_json) {
+                fputc('{', fp);
+            }
+
+            ++depth;
+            need_comma = false;
+        }
+
+        void end_group(void) throw() {
+            --depth;
+
+            if(as_json) {
+                fputc('\n', fp);
+                for(unsigned i(0); i < depth; ++i) {
+                    fputs("  ", fp);
+                }
+                fputs(0 == depth ? "}\n" : "}", fp);
+            }
+
+            need_comma = true;
+        }
+
+        void field(const char *label, const unsigned long value) throw() {
+            begin_entry(label);
+            fprintf(fp, as_json ? "%lu" : " %lu\n", value);
+        }
+
+        void field(const char *label, const unsigned value) throw() {
+            field(label, static_cast<unsigned long>(value));
+        }
+
+        /// print out a time, in seconds
+        void field(const char *label, const double value) throw() {
+            begin_entry(label);
+            fprintf(fp, as_json ? "%.6f" : " %.6fs\n", value);
+        }
+
+        /// print out a list of counters
+        void field(
+            const char *label,
+            const unsigned long *values,
+            const unsigned num_values
+        ) throw() {
+            begin_entry(label);
+            fputs(as_json ? "[" : " ", fp);
+
+            for(unsigned i(0); i < num_values; ++i) {
+                if(0 < i) {
+                    fputs(as_json ? ", " : " ", fp);
+                }
+                fprintf(fp, "%lu", values[i]);
+            }
+
+            fputs(as_json ? "]" : "\n", fp);
+        }
+    };
+}}
+
+#endif /* Grail_Plus_STATSPRINTER_HPP_ */
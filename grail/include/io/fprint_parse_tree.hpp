@@ -30,10 +30,14 @@
 #define FLTL_FPRINT_PARSE_TREE_HPP_
 
 #include <cstdio>
+#include <vector>
 
 #include "fltl/include/CFG.hpp"
 
-#include "grail/include/cfg/ParseTree.hpp"
+#include "grail/include/cfg/ParseForest.hpp"
+
+#include "grail/include/io/fprint.hpp"
+#include "grail/include/io/fprint_cfg.hpp"
 
 namespace grail { namespace io {
 
@@ -41,43 +45,320 @@ namespace grail { namespace io {
     class lisp_language { };
     class tree_language { };
 
+    /// implements printing of parse forests. nothing here is recursive,
+    /// as the depth of a parse tree can be as large as its input.
     template <typename AlphaT>
-    int fprint(
-        FILE *ff,
-        fltl::CFG<AlphaT> &gram,
-        const grail::cfg::ParseTree<AlphaT> *tree,
-        const dot_language
-    ) throw() {
+    class fprint_parse_tree_impl {
+    public:
 
-        (void) ff;
-        (void) gram;
-        (void) tree;
-    }
+        typedef fltl::CFG<AlphaT> cfg_type;
+        typedef grail::cfg::ParseForest<AlphaT> forest_type;
+        typedef typename forest_type::grammar_type grammar_type;
+        typedef typename forest_type::node_type node_type;
+        typedef typename forest_type::packed_node_type packed_node_type;
+        typedef typename cfg_type::symbol_type symbol_type;
+        typedef typename cfg_type::production_type production_type;
 
-    template <typename AlphaT>
-    int fprint(
-        FILE *ff,
-        const fltl::CFG<AlphaT> &gram,
-        const grail::cfg::ParseTree<AlphaT> *tree,
-        const lisp_language
-    ) throw() {
+        enum {
+            NO_NODE = forest_type::NO_NODE
+        };
 
-        (void) ff;
-        (void) gram;
-        (void) tree;
-    }
+        /// print a token as a double-quoted string. when printing labels
+        /// for dot, the quotes themselves must also be escaped.
+        static int print_lexeme(
+            FILE *ff,
+            const char *lexeme,
+            const bool in_label
+        ) throw() {
+            const char *quote(in_label ? "\\\"" : "\"");
+            int num(fprintf(ff, "%s", quote));
 
-    template <typename AlphaT>
+            for(; '\0' != *lexeme; ++lexeme) {
+                if('"' == *lexeme || '\\' == *lexeme) {
+                    num += fprintf(ff, in_label ? "\\\\\\%c" : "\\%c", *lexeme);
+                } else {
+                    num += fprintf(ff, "%c", *lexeme);
+                }
+            }
+
+            return num + fprintf(ff, "%s", quote);
+        }
+
+        /// print out the symbol of a variable or terminal node
+        static int print_symbol(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const typename grammar_type::symbol_id_type sym,
+            const bool in_label
+        ) throw() {
+            if(0 < sym) {
+                return fprintf(
+                    ff, "%s",
+                    cfg.get_name(grammar.variables[static_cast<unsigned>(sym)])
+                );
+            }
+
+            const unsigned term(static_cast<unsigned>(-sym));
+            if(grammar.is_variable_terminal[term]) {
+                return fprintf(ff, "%s", cfg.get_name(grammar.terminals[term]));
+            } else if(!in_label) {
+                return fprint(ff, cfg, grammar.terminals[term]);
+            }
+
+            return fprintf(ff, "\\\"")
+                 + fprint(ff, cfg.get_alpha(grammar.terminals[term]))
+                 + fprintf(ff, "\\\"");
+        }
+
+        /// print out a dotted item, e.g. A --> B . c
+        static int print_item(
+            FILE *ff,
+            const cfg_type &cfg,
+            const grammar_type &grammar,
+            const unsigned item,
+            const bool in_label
+        ) throw() {
+            const production_type &prod(
+                grammar.productions[grammar.item_production[item]]
+            );
+            const unsigned dot(grammar.item_dot[item]);
+            int num(fprintf(ff, "%s ->", cfg.get_name(prod.variable())));
+
+            for(unsigned i(0); i < prod.length(); ++i) {
+                if(i == dot) {
+                    num += fprintf(ff, " .");
+                }
+
+                const symbol_type &S(prod.symbol_at(i));
+                typename grammar_type::symbol_id_type sym(
+                    static_cast<typename grammar_type::symbol_id_type>(S.number())
+                );
+
+                num += fprintf(ff, " ");
+                num += print_symbol(
+                    ff, cfg, grammar, S.is_terminal() ? -sym : sym, in_label
+                );
+            }
+
+            if(dot == prod.length()) {
+                num += fprintf(ff, " .");
+            }
+
+            return num;
+        }
+
+        /// print out one parse tree of the forest as an s-expression. the
+        /// first packed node of each node is always used; these never form
+        /// a cycle, even for cyclic grammars.
+        static int print(
+            FILE *ff,
+            const cfg_type &cfg,
+            const forest_type &forest,
+            const lisp_language
+        ) throw() {
+            const grammar_type &grammar(*(forest.grammar));
+            std::vector<unsigned> stack;
+            std::vector<unsigned> children;
+            bool need_space(false);
+            int num(0);
+
+            if(forest.is_empty()) {
+                return num;
+            }
+
+            // NO_NODE is used as the marker for closing a list
+            stack.push_back(forest.root);
+
+            for(; !stack.empty(); ) {
+                const unsigned curr(stack.back());
+                stack.pop_back();
+
+                if(NO_NODE == curr) {
+                    num += fprintf(ff, ")");
+                    need_space = true;
+                    continue;
+                }
+
+                if(need_space) {
+                    num += fprintf(ff, " ");
+                }
+
+                need_space = true;
+
+                const node_type &node(forest.nodes[curr]);
+
+                // terminal; variable terminals are printed with the token
+                // that they matched
+                if(0 > node.symbol) {
+                    const unsigned term(static_cast<unsigned>(-node.symbol));
+                    if(grammar.is_variable_terminal[term]) {
+                        num += fprintf(ff, "(");
+                        num += print_symbol(ff, cfg, grammar, node.symbol, false);
+                        num += fprintf(ff, " ");
+                        num += print_lexeme(ff, forest.lexeme(node.start), false);
+                        num += fprintf(ff, ")");
+                    } else {
+                        num += print_symbol(ff, cfg, grammar, node.symbol, false);
+                    }
+                    continue;
+                }
+
+                num += fprintf(ff, "(");
+                num += print_symbol(ff, cfg, grammar, node.symbol, false);
+
+                // undo the binarization of the production; the children are
+                // collected from right to left
+                children.clear();
+                const packed_node_type *packed(
+                    &(forest.packed_nodes[node.first_packed])
+                );
+
+                if(NO_NODE != packed->right) {
+                    children.push_back(packed->right);
+                }
+
+                unsigned left(packed->left);
+                for(; NO_NODE != left && 0 == forest.nodes[left].symbol; ) {
+                    packed = &(forest.packed_nodes[
+                        forest.nodes[left].first_packed
+                    ]);
+                    children.push_back(packed->right);
+                    left = packed->left;
+                }
+
+                if(NO_NODE != left) {
+                    children.push_back(left);
+                }
+
+                stack.push_back(NO_NODE);
+                stack.insert(stack.end(), children.begin(), children.end());
+            }
+
+            return num + fprintf(ff, "\n");
+        }
+
+        /// print out every node of the forest, along with all of the ways
+        /// that each node can be derived
+        static int print(
+            FILE *ff,
+            const cfg_type &cfg,
+            const forest_type &forest,
+            const tree_language
+        ) throw() {
+            const grammar_type &grammar(*(forest.grammar));
+            int num(0);
+
+            for(unsigned i(0); i < forest.num_nodes(); ++i) {
+                const node_type &node(forest.nodes[i]);
+
+                num += fprintf(ff, "#%u ", i);
+                if(0 == node.symbol) {
+                    num += fprintf(ff, "[");
+                    num += print_item(ff, cfg, grammar, node.item, false);
+                    num += fprintf(ff, "]");
+                } else {
+                    num += print_symbol(ff, cfg, grammar, node.symbol, false);
+                }
+
+                num += fprintf(ff, " [%u, %u)", node.start, node.end);
+
+                if(0 > node.symbol) {
+                    num += fprintf(ff, " ");
+                    num += print_lexeme(ff, forest.lexeme(node.start), false);
+                }
+
+                num += fprintf(ff, "\n");
+
+                for(unsigned p(0); p < node.num_packed; ++p) {
+                    const packed_node_type &packed(
+                        forest.packed_nodes[node.first_packed + p]
+                    );
+
+                    num += fprintf(ff, "    ");
+                    num += print_item(ff, cfg, grammar, packed.item, false);
+                    num += fprintf(ff, " :");
+
+                    if(NO_NODE != packed.left) {
+                        num += fprintf(ff, " #%u", packed.left);
+                    }
+
+                    if(NO_NODE != packed.right) {
+                        num += fprintf(ff, " #%u", packed.right);
+                    }
+
+                    num += fprintf(ff, "\n");
+                }
+            }
+
+            return num;
+        }
+
+        /// print out the forest as a graphviz digraph. packed nodes are only
+        /// drawn for nodes that have more than one derivation.
+        static int print(
+            FILE *ff,
+            const cfg_type &cfg,
+            const forest_type &forest,
+            const dot_language
+        ) throw() {
+            const grammar_type &grammar(*(forest.grammar));
+            int num(fprintf(ff, "digraph forest {\n"));
+
+            for(unsigned i(0); i < forest.num_nodes(); ++i) {
+                const node_type &node(forest.nodes[i]);
+
+                num += fprintf(ff, "    n%u [label=\"", i);
+                if(0 == node.symbol) {
+                    num += print_item(ff, cfg, grammar, node.item, true);
+                } else if(0 > node.symbol) {
+                    num += print_lexeme(ff, forest.lexeme(node.start), true);
+                } else {
+                    num += print_symbol(ff, cfg, grammar, node.symbol, true);
+                }
+
+                num += fprintf(
+                    ff, " [%u, %u)\"%s];\n",
+                    node.start, node.end,
+                    0 == node.symbol ? " shape=box" : ""
+                );
+
+                for(unsigned p(0); p < node.num_packed; ++p) {
+                    const unsigned id(node.first_packed + p);
+                    const packed_node_type &packed(forest.packed_nodes[id]);
+
+                    if(1U < node.num_packed) {
+                        num += fprintf(
+                            ff, "    p%u [shape=point];\n    n%u -> p%u;\n",
+                            id, i, id
+                        );
+                    }
+
+                    const unsigned child[2] = {packed.left, packed.right};
+                    for(unsigned c(0); c < 2U; ++c) {
+                        if(NO_NODE == child[c]) {
+                            continue;
+                        } else if(1U < node.num_packed) {
+                            num += fprintf(ff, "    p%u -> n%u;\n", id, child[c]);
+                        } else {
+                            num += fprintf(ff, "    n%u -> n%u;\n", i, child[c]);
+                        }
+                    }
+                }
+            }
+
+            return num + fprintf(ff, "}\n");
+        }
+    };
+
+    template <typename AlphaT, typename LanguageT>
     int fprint(
         FILE *ff,
-        const fltl::CFG<AlphaT> &gram,
-        const grail::cfg::ParseTree<AlphaT> *tree,
-        const tree_language
+        const fltl::CFG<AlphaT> &cfg,
+        const grail::cfg::ParseForest<AlphaT> &forest,
+        const LanguageT lang
     ) throw() {
-
-        (void) ff;
-        (void) gram;
-        (void) tree;
+        return fprint_parse_tree_impl<AlphaT>::print(ff, cfg, forest, lang);
     }
 }}
 
@@ -625,9 +625,10 @@ namespace grail { namespace io {
                 error(diag::err_option_requires_val, opt);
                 return;
             }
-        } else if(opt::NO_VAL == vc && 0 != opt->val_begin) {
+        } else if(opt::REQUIRES_VAL != vc && 0 != opt->val_begin) {
 
-            // split the option into two
+            // split the option into two; an optional value can only be
+            // given after an '=' sign, so the value is really positional
             if(opt->is_positional_candidate) {
 
                 CommandLineOption *pos(new CommandLineOption);
@@ -650,7 +651,7 @@ namespace grail { namespace io {
                 ++num_positional;
 
             // there was an '=' sign, error
-            } else {
+            } else if(opt::NO_VAL == vc) {
                 error(diag::err_option_no_val, opt);
             }
         }
@@ -8,6 +8,7 @@
 #include "grail/include/cli/PDA_TO_CFG.hpp"
 #include "grail/include/cli/CFG_TO_GNF.hpp"
 #include "grail/include/cli/CFG_TO_LL1.hpp"
+#include "grail/include/cli/CFG_TO_LALR.hpp"
 //#include "grail/include/cli/CFG_TO_TDOP.hpp"
 
 #include "grail/include/cli/NFA_TO_DOT.hpp"
@@ -23,6 +24,7 @@ GRAIL_DECLARE_TOOL(CFG_TO_CNF)
 GRAIL_DECLARE_TOOL(CFG_TO_GNF)
 GRAIL_DECLARE_TOOL(CFG_TO_PDA)
 GRAIL_DECLARE_TOOL(CFG_TO_LL1)
+GRAIL_DECLARE_TOOL(CFG_TO_LALR)
 //GRAIL_DECLARE_TOOL(CFG_TO_TDOP)
 
 GRAIL_DECLARE_TOOL(NFA_DOMINATORS)
@@ -0,0 +1,36 @@
+#!/bin/bash
+#
+# Benchmarks the default Earley engine of cfg-parse against the LR(0)
+# Earley engine (--engine=earley-lr0) on the ANSI C grammar in
+# test/ansic.cfg. The input is a C program made of copies of one small
+# function. Identifiers and constants are not terminals of the grammar, so
+# both engines substitute variable terminals for them.
+#
+# usage: test/bench-earley-lr0.sh [path to grail binary] [numbers of functions...]
+#
+
+GRAIL=${1:-./bin/grail}
+shift
+SIZES=${@:-100 200 400 800 1600}
+
+GRAMMAR=$(dirname "$0")/ansic.cfg
+TOKENS=$(mktemp)
+TIMEFORMAT="%R"
+
+trap 'rm -f "$TOKENS"' EXIT
+
+printf "%10s %12s %12s\n" "tokens" "earley (s)" "earley-lr0 (s)"
+
+for n in $SIZES; do
+    awk -v n="$n" 'BEGIN {
+        for(i = 0; i < n; ++i) {
+            print "int\nf\n(\nint\nx\n)\n{\nwhile\n(\nx\n>\n0\n)\n{\nx\n=\nx\n-\n1\n;\n}\nreturn\nx\n*\n2\n;\n}"
+        }
+    }' > "$TOKENS"
+    num_tokens=$(wc -l < "$TOKENS")
+
+    t_default=$( { time "$GRAIL" --tool=cfg-parse "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+    t_lr0=$( { time "$GRAIL" --tool=cfg-parse --engine=earley-lr0 "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+
+    printf "%10s %12s %12s\n" "$num_tokens" "$t_default" "$t_lr0"
+done
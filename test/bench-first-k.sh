@@ -0,0 +1,28 @@
+#!/bin/bash
+#
+# Benchmarks the computation of the FIRST_k and FOLLOW_k sets of a grammar
+# with cfg-info for several k. Prints the time that each k takes and the
+# number of bytes of sets that it prints.
+#
+# usage: test/bench-first-k.sh [path to grail binary] [grammar] [k...]
+#
+
+GRAIL=${1:-./bin/grail}
+GRAMMAR=${2:-test/ansic.cfg}
+shift
+shift
+KS=${@:-1 2 3}
+
+OUT=$(mktemp)
+
+trap 'rm -f "$OUT"' EXIT
+
+TIMEFORMAT="%R"
+
+printf "%4s %10s %12s\n" "k" "time (s)" "output (B)"
+
+for k in $KS; do
+    t=$( { time "$GRAIL" --tool=cfg-info --first=$k --follow=$k "$GRAMMAR" > "$OUT"; } 2>&1 )
+
+    printf "%4s %10s %12s\n" "$k" "$t" "$(wc -c < "$OUT")"
+done
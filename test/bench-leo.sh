@@ -0,0 +1,32 @@
+#!/bin/bash
+#
+# Benchmarks cfg-parse with and without Leo items (--leo) on the
+# right-recursive grammar in test/right-recursive.cfg. Without Leo items
+# every token of a right-recursive list adds one completion per enclosing
+# list, so the parse time grows at least quadratically with the input
+# length. With Leo items it grows linearly.
+#
+# usage: test/bench-leo.sh [path to grail binary] [input lengths...]
+#
+
+GRAIL=${1:-./bin/grail}
+shift
+SIZES=${@:-1000 2000 4000 8000 16000}
+
+GRAMMAR=$(dirname "$0")/right-recursive.cfg
+TOKENS=$(mktemp)
+TIMEFORMAT="%R"
+
+trap 'rm -f "$TOKENS"' EXIT
+
+printf "%10s %12s %12s\n" "tokens" "default (s)" "--leo (s)"
+
+for n in $SIZES; do
+    awk -v n="$n" 'BEGIN { for(i = 1; i < n; ++i) print "x\n,"; print "x" }' > "$TOKENS"
+    num_tokens=$(wc -l < "$TOKENS")
+
+    t_default=$( { time "$GRAIL" --tool=cfg-parse "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+    t_leo=$( { time "$GRAIL" --tool=cfg-parse --leo "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+
+    printf "%10s %12s %12s\n" "$num_tokens" "$t_default" "$t_leo"
+done
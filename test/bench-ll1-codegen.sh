@@ -0,0 +1,87 @@
+#!/bin/bash
+#
+# Compares the table-driven LL(1) engine of cfg-parse against the parser
+# that cfg-to-ll1 --fast writes out, on inputs of growing length:
+#
+#   - sums of products for test/ll1-math.cfg;
+#   - nested lists for test/ll1-lists.cfg, whose identifiers are matched
+#     by the variable terminal ID.
+#
+# Both should accept every input.
+#
+# usage: test/bench-ll1-codegen.sh [path to grail binary] [numbers of terms...]
+#
+
+GRAIL=${1:-./bin/grail}
+shift
+SIZES=${@:-100000 1000000}
+
+DIR=$(dirname "$0")
+WORK=$(mktemp -d)
+TIMEFORMAT="%R"
+
+# write out the tokens of a sum of n products
+math_tokens() {
+    awk -v n="$1" 'BEGIN {
+        for(i = 0; i < n; ++i) {
+            if(0 < i) {
+                print (i % 3) ? "+" : "*"
+            }
+            print "("
+            print i % 10
+            print "*"
+            print (i * 7) % 10
+            print ")"
+        }
+    }'
+}
+
+# write out the tokens of a list of n short lists of identifiers
+list_tokens() {
+    awk -v n="$1" 'BEGIN {
+        print "("
+        for(i = 0; i < n; ++i) {
+            print "("
+            print "x" i
+            print "y"
+            print ")"
+        }
+        print ")"
+    }'
+}
+
+# compare the engine and the generated parser of a grammar
+compare() {
+    local grammar=$1
+    local tokens=$2
+
+    echo "$grammar"
+
+    "$GRAIL" --tool=cfg-to-ll1 --fast "$grammar" > "$WORK/parser.cpp" || exit 1
+    ${CXX:-g++} -O2 -DLL1_MAIN "$WORK/parser.cpp" -o "$WORK/parser" || exit 1
+
+    printf "%10s %14s %14s\n" "tokens" "cfg-parse (s)" "generated (s)"
+
+    for n in $SIZES; do
+        $tokens "$n" > "$WORK/tokens.txt"
+
+        engine=$( { time "$GRAIL" --tool=cfg-parse --engine=ll1 "$grammar" \
+            "$WORK/tokens.txt" > "$WORK/engine.out"; } 2>&1 )
+        generated=$( { time "$WORK/parser" < "$WORK/tokens.txt" \
+            > "$WORK/generated.out"; } 2>&1 )
+
+        if ! cmp -s "$WORK/engine.out" "$WORK/generated.out"; then
+            echo "answers differ for $n terms"
+        elif [ "Yes." != "$(cat "$WORK/engine.out")" ]; then
+            echo "input of $n terms was rejected"
+        fi
+
+        printf "%10s %14s %14s\n" \
+            "$(wc -l < "$WORK/tokens.txt")" "$engine" "$generated"
+    done
+}
+
+compare "$DIR/ll1-math.cfg" math_tokens
+compare "$DIR/ll1-lists.cfg" list_tokens
+
+rm -rf "$WORK"
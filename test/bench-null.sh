@@ -0,0 +1,39 @@
+#!/bin/bash
+#
+# Benchmarks the computation of the NULL set on a chain of variables
+# V0 -> V1 -> ... -> Vn -> epsilon. The productions are listed from the
+# top of the chain down, so a fixpoint that sweeps over the productions in
+# order learns of only one more nullable variable per sweep. Prints the
+# time of the NULL phase that cfg-parse reports with --stats.
+#
+# usage: test/bench-null.sh [path to grail binary] [chain lengths...]
+#
+
+GRAIL=${1:-./bin/grail}
+shift
+SIZES=${@:-1000 2000 4000 8000}
+
+GRAMMAR=$(mktemp)
+TOKENS=$(mktemp)
+
+trap 'rm -f "$GRAMMAR" "$TOKENS"' EXIT
+
+echo "x" > "$TOKENS"
+
+printf "%10s %12s\n" "variables" "NULL (s)"
+
+for n in $SIZES; do
+    awk -v n="$n" 'BEGIN {
+        print "S -> V0 \"x\"";
+        for(i = 0; i < n - 1; ++i) {
+            print "V" i " -> V" (i + 1) " \"y\"";
+            print "V" i " -> V" (i + 1);
+        }
+        print "V" (n - 1) " -> epsilon";
+    }' > "$GRAMMAR"
+
+    t_null=$("$GRAIL" --tool=cfg-parse --stats "$GRAMMAR" "$TOKENS" 2>&1 \
+             | awk '$1 == "NULL:" { sub("s", "", $2); print $2 }')
+
+    printf "%10s %12s\n" "$n" "$t_null"
+done
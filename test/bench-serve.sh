@@ -0,0 +1,47 @@
+#!/bin/bash
+#
+# Compares parsing the same token file many times with one cfg-parse run
+# per file against sending each file to a cfg-parse --serve server, which
+# reads in and analyses test/ansic.cfg only once. Both should give the same
+# answers; the server should save the cost of loading the grammar.
+#
+# usage: test/bench-serve.sh [path to grail binary] [token file] [requests]
+#
+
+GRAIL=${1:-./bin/grail}
+TOKENS=${2:?a file of ANSI C tokens is needed}
+REQUESTS=${3:-100}
+
+GRAMMAR=$(dirname "$0")/ansic.cfg
+SOCKET=$(mktemp -u /tmp/cfg-parse.XXXXXX)
+TIMEFORMAT="%R"
+
+"$GRAIL" --tool=cfg-parse --serve="$SOCKET" --jobs=4 "$GRAMMAR" &
+SERVER=$!
+
+for i in $(seq 50); do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+
+direct=$( { time for i in $(seq "$REQUESTS"); do
+    "$GRAIL" --tool=cfg-parse "$GRAMMAR" "$TOKENS"
+done > /tmp/direct.$$; } 2>&1 )
+
+served=$( { time for i in $(seq "$REQUESTS"); do
+    "$GRAIL" --tool=cfg-parse --connect="$SOCKET" ansic.cfg "$TOKENS"
+done > /tmp/served.$$; } 2>&1 )
+
+kill -INT "$SERVER"
+wait "$SERVER"
+
+if cmp -s /tmp/direct.$$ /tmp/served.$$; then
+    echo "answers match"
+else
+    echo "answers differ"
+fi
+rm -f /tmp/direct.$$ /tmp/served.$$
+
+printf "%10s %12s\n" "mode" "time (s)"
+printf "%10s %12s\n" "direct" "$direct"
+printf "%10s %12s\n" "served" "$served"
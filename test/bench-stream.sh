@@ -0,0 +1,38 @@
+#!/bin/bash
+#
+# Streams log-like token streams of growing length through cfg-parse
+# --stream using the grammar in test/log.cfg. Finished sets are collected
+# once they hold 65536 items, and after that whenever they hold twice as
+# many items as the last collection left. The largest number of items
+# kept therefore grows until it reaches that threshold. The number of
+# items left by a collection (0 for streams too short to collect) should
+# stay the same no matter how long the stream is, because each log entry
+# can only complete back to the start of the log or of the entry itself.
+#
+# usage: test/bench-stream.sh [path to grail binary] [numbers of entries...]
+#
+
+GRAIL=${1:-./bin/grail}
+shift
+SIZES=${@:-10000 100000 1000000}
+
+GRAMMAR=$(dirname "$0")/log.cfg
+TIMEFORMAT="%R"
+
+printf "%10s %12s %16s %16s\n" \
+    "tokens" "time (s)" "max items kept" "max items left"
+
+for n in $SIZES; do
+    stats=$( { time awk -v n="$n" 'BEGIN {
+        for(i = 0; i < n; ++i) {
+            print "info\nword\nword\nword\neol"
+        }
+    }' | "$GRAIL" --tool=cfg-parse --stream --stats "$GRAMMAR" --stdin \
+        > /dev/null; } 2>&1 )
+
+    kept=$(echo "$stats" | sed -n 's/^max items kept: //p')
+    left=$(echo "$stats" | sed -n 's/^max items after collection: //p')
+    t=$(echo "$stats" | tail -n 1)
+
+    printf "%10s %12s %16s %16s\n" "$((n * 5))" "$t" "$kept" "${left:-0}"
+done
@@ -0,0 +1,41 @@
+#!/bin/bash
+#
+# Benchmarks the cyk and valiant engines of cfg-parse on the arithmetic
+# grammar in test/math.cfg. Both engines fill the same chart of the CNF of
+# the grammar; the valiant engine fills it a tile of positions at a time,
+# and can spread each band of tiles over several threads (--threads).
+#
+# usage: test/bench-valiant.sh [path to grail binary] [threads] [input lengths...]
+#
+
+GRAIL=${1:-./bin/grail}
+shift
+THREADS=${1:-4}
+shift
+SIZES=${@:-250 500 1000 2000}
+
+GRAMMAR=$(dirname "$0")/math.cfg
+TOKENS=$(mktemp)
+TIMEFORMAT="%R"
+
+trap 'rm -f "$TOKENS"' EXIT
+
+printf "%10s %12s %14s %24s\n" "tokens" "cyk (s)" "valiant (s)" "valiant --threads=$THREADS (s)"
+
+for n in $SIZES; do
+    awk -v n="$n" 'BEGIN {
+        srand(1);
+        for(i = 4; i < n; i += 4) {
+            print "(\n" int(rand() * 10) "\n" (rand() < 0.5 ? "+" : "*");
+        }
+        print "1";
+        for(i = 4; i < n; i += 4) print ")";
+    }' > "$TOKENS"
+    num_tokens=$(wc -l < "$TOKENS")
+
+    t_cyk=$( { time "$GRAIL" --tool=cfg-parse --engine=cyk "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+    t_valiant=$( { time "$GRAIL" --tool=cfg-parse --engine=valiant "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+    t_parallel=$( { time "$GRAIL" --tool=cfg-parse --engine=valiant --threads="$THREADS" "$GRAMMAR" "$TOKENS" > /dev/null; } 2>&1 )
+
+    printf "%10s %12s %14s %24s\n" "$num_tokens" "$t_cyk" "$t_valiant" "$t_parallel"
+done
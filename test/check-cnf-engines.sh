@@ -0,0 +1,90 @@
+#!/bin/bash
+#
+# Cross-checks the cyk and valiant engines of cfg-parse against the Earley
+# engine. Both CNF engines parse with the Chomsky normal form of the
+# grammar, so this also checks the CNF conversion. Every string of at most
+# MAX_LENGTH tokens over a grammar's terminals is parsed by all three
+# engines, and any string on which they disagree is printed. Exits with 1
+# if there was a disagreement.
+#
+# usage: test/check-cnf-engines.sh [path to grail binary] [max length]
+#
+
+GRAIL=${1:-./bin/grail}
+MAX_LENGTH=${2:-4}
+
+GRAMMAR=$(mktemp)
+TOKENS=$(mktemp)
+
+trap 'rm -f "$GRAMMAR" "$TOKENS"' EXIT
+
+# each grammar is followed by a line with its terminals
+GRAMMARS=(
+'S : "a" ;'
+'a'
+
+'S : B C | ;
+A : "a" ;
+B : | A ;
+C : "c" "b" | "b" B | A ;'
+'a b c'
+
+'S : "a" S "b" | ;'
+'a b'
+
+'S : S S | "a" | "(" S ")" ;'
+'a ( )'
+
+'S : A B | B "a" ;
+A : "a" | ;
+B : "b" A | A ;'
+'a b'
+
+'E : E "+" T | T ;
+T : T "*" F | F ;
+F : "(" E ")" | "x" ;'
+'x + * ( )'
+)
+
+num_failed=0
+
+# parse the tokens in $TOKENS with every engine and compare the answers
+check() {
+    local earley cyk valiant
+    earley=$("$GRAIL" --tool=cfg-parse --engine=earley "$GRAMMAR" "$TOKENS" 2>&1)
+    cyk=$("$GRAIL" --tool=cfg-parse --engine=cyk "$GRAMMAR" "$TOKENS" 2>&1)
+    valiant=$("$GRAIL" --tool=cfg-parse --engine=valiant "$GRAMMAR" "$TOKENS" 2>&1)
+
+    if [ "$earley" != "$cyk" ] || [ "$earley" != "$valiant" ]; then
+        echo "MISMATCH on input '$1': earley '$earley', cyk '$cyk', valiant '$valiant'"
+        num_failed=$((num_failed + 1))
+    fi
+}
+
+# check every string of at most MAX_LENGTH terminals that extends $1
+extend() {
+    local prefix=$1 length=$2 t
+
+    printf "%s" "$prefix" | tr ' ' '\n' | sed '/^$/d' > "$TOKENS"
+    check "$prefix"
+
+    if [ "$length" -lt "$MAX_LENGTH" ]; then
+        for t in $TERMINALS; do
+            extend "$prefix $t" $((length + 1))
+        done
+    fi
+}
+
+for ((i = 0; i < ${#GRAMMARS[@]}; i += 2)); do
+    printf "%s\n" "${GRAMMARS[i]}" > "$GRAMMAR"
+    TERMINALS=${GRAMMARS[i + 1]}
+    echo "checking grammar $((i / 2 + 1)) over '$TERMINALS'..."
+    extend "" 0
+done
+
+if [ 0 -ne "$num_failed" ]; then
+    echo "$num_failed mismatches."
+    exit 1
+fi
+
+echo "All engines agree."